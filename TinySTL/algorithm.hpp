@@ -8,8 +8,9 @@
 #include <cmath>
 #include <cstring>
 #include <initializer_list>
-#include <random>
+#include <new>
 
+#include "allocators.hpp"
 #include "functional.hpp"
 #include "iterator.hpp"
 
@@ -139,6 +140,35 @@ inline InIter find_if_not(InIter first, InIter last, UnaryPred pred) {
     return last;
 }
 
+// the first subsequence of [first, last) equal to [sFirst, sLast)
+template <typename FwdIter1, typename FwdIter2, typename BinPred>
+inline FwdIter1 search(FwdIter1 first, FwdIter1 last, FwdIter2 sFirst,
+                       FwdIter2 sLast, BinPred pred) {
+    for (;; ++first) {
+        FwdIter1 it = first;
+        for (FwdIter2 sIt = sFirst;; ++it, ++sIt) {
+            if (sIt == sLast)
+                return first;
+            if (it == last)
+                return last;
+            if (!pred(*it, *sIt))
+                break;
+        }
+    }
+}
+
+template <typename FwdIter1, typename FwdIter2>
+inline FwdIter1 search(FwdIter1 first, FwdIter1 last, FwdIter2 sFirst,
+                       FwdIter2 sLast) {
+    return tiny_stl::search(first, last, sFirst, sLast, equal_to<>{});
+}
+
+// searcher(first, last) returns the matched range, see searcher.hpp
+template <typename FwdIter, typename Searcher>
+inline FwdIter search(FwdIter first, FwdIter last, const Searcher& searcher) {
+    return searcher(first, last).first;
+}
+
 template <typename FwdIter, typename T>
 struct FillMemsetIsSafeHelper {
     using ValueType = typename iterator_traits<FwdIter>::value_type;
@@ -225,8 +255,9 @@ inline OutIter transform(InIter first1, InIter last1, OutIter dstFirst,
     return dstFirst;
 }
 
-template <typename InIter, typename OutIter, typename BinOp>
-inline OutIter transform(InIter first1, InIter last1, InIter first2,
+template <typename InIter1, typename InIter2, typename OutIter,
+          typename BinOp>
+inline OutIter transform(InIter1 first1, InIter1 last1, InIter2 first2,
                          OutIter dstFirst, BinOp op) {
     for (; first1 != last1; ++first1, ++first2, ++dstFirst)
         *dstFirst = op(*first1, *first2);
@@ -566,8 +597,8 @@ inline void adjustHeapHelper(RanIter first, Diff hole, Diff len, T&& val,
 
     // have a right child
     while (rightChild < len) {
-        if (*(first + rightChild) <
-            *(first + (rightChild - 1))) // left child > right child
+        if (cmp(*(first + rightChild),
+                *(first + (rightChild - 1)))) // left child > right child
             --rightChild;
         *(first + hole) = tiny_stl::move(
             *(first + rightChild));      // move the bigger one to the hole
@@ -631,7 +662,7 @@ inline void pop_heap(RanIter first, RanIter last) {
 template <typename RanIter, typename Cmp>
 inline void sort_heap(RanIter first, RanIter last, Cmp cmp) {
     for (; last - first > 1; --last)
-        tiny_stl::pop_heap(first, last);
+        tiny_stl::pop_heap(first, last, cmp);
 }
 
 template <typename RanIter>
@@ -724,84 +755,1155 @@ inline void insertSort(RanIter first, RanIter last, Compare& cmp) {
         return;
 
     for (RanIter i = first + 1; i != last; ++i) {
+        if (!cmp(*i, *(i - 1)))
+            continue;
+
         auto key = tiny_stl::move(*i);
         RanIter j = i;
-        for (; j > first && cmp(key, (*(j - 1))); --j) {
+        do {
             *j = tiny_stl::move(*(j - 1));
-        }
+        } while (--j != first && cmp(key, *(j - 1)));
 
         *j = tiny_stl::move(key);
     }
 }
 
-// quick_sort
-template <typename RanIter>
-inline auto getRandom(RanIter first, RanIter last) {
-    using Diff = typename iterator_traits<RanIter>::difference_type;
-    static std::mt19937 e;
-    std::uniform_int_distribution<Diff> u{0, (last - first - 1)};
+// *(first - 1) is not greater than any element in [first, last), so the
+// inner loop needs no bound check
+template <typename RanIter, typename Compare>
+inline void unguardedInsertSort(RanIter first, RanIter last, Compare& cmp) {
+    if (first == last)
+        return;
+
+    for (RanIter i = first + 1; i != last; ++i) {
+        if (!cmp(*i, *(i - 1)))
+            continue;
+
+        auto key = tiny_stl::move(*i);
+        RanIter j = i;
+        do {
+            *j = tiny_stl::move(*(j - 1));
+        } while (cmp(key, *(--j - 1)));
 
-    return u(e);
+        *j = tiny_stl::move(key);
+    }
 }
 
+static const std::ptrdiff_t PARTIAL_INSERT_SORT_LIMIT = 8;
+
+// give up and return false once more than PARTIAL_INSERT_SORT_LIMIT
+// elements have been moved
 template <typename RanIter, typename Compare>
-inline RanIter quickSortPartition(RanIter first, RanIter last, Compare& cmp) {
-    using Diff = typename iterator_traits<RanIter>::difference_type;
-    Diff randomPos = getRandom(first, last);
-    tiny_stl::iter_swap(first + randomPos, last - 1);
-    auto key = *(last - 1);
+inline bool partialInsertSort(RanIter first, RanIter last, Compare& cmp) {
+    if (first == last)
+        return true;
+
+    std::ptrdiff_t moved = 0;
+    for (RanIter i = first + 1; i != last; ++i) {
+        if (!cmp(*i, *(i - 1)))
+            continue;
+
+        auto key = tiny_stl::move(*i);
+        RanIter j = i;
+        do {
+            *j = tiny_stl::move(*(j - 1));
+        } while (--j != first && cmp(key, *(j - 1)));
+
+        *j = tiny_stl::move(key);
+        moved += i - j;
+        if (moved > PARTIAL_INSERT_SORT_LIMIT)
+            return false;
+    }
+
+    return true;
+}
+
+// pattern-defeating quick_sort
+template <typename RanIter, typename Compare>
+inline void sort2(RanIter a, RanIter b, Compare& cmp) {
+    if (cmp(*b, *a))
+        tiny_stl::iter_swap(a, b);
+}
+
+// median of three to *b
+template <typename RanIter, typename Compare>
+inline void sort3(RanIter a, RanIter b, RanIter c, Compare& cmp) {
+    sort2(a, b, cmp);
+    sort2(b, c, cmp);
+    sort2(a, b, cmp);
+}
+
+// partition around the pivot *first, the elements equal to it go right.
+// returns the pivot position and whether the range was already partitioned
+template <typename RanIter, typename Compare>
+inline pair<RanIter, bool> partitionRight(RanIter first, RanIter last,
+                                          Compare& cmp, false_type) {
+    auto pivot = tiny_stl::move(*first);
+
+    RanIter i = first;
+    RanIter j = last;
+
+    // the median of three guarantees an element >= pivot on the right
+    while (cmp(*++i, pivot))
+        ;
+
+    // unless it was swapped to the first position
+    if (i - 1 == first)
+        while (i < j && !cmp(*--j, pivot))
+            ;
+    else
+        while (!cmp(*--j, pivot))
+            ;
+
+    bool partitioned = i >= j;
+
+    // Hoare partition, the sentinels keep both scans in range
+    while (i < j) {
+        tiny_stl::iter_swap(i, j);
+        while (cmp(*++i, pivot))
+            ;
+        while (!cmp(*--j, pivot))
+            ;
+    }
+
+    RanIter pivotPos = i - 1;
+    *first = tiny_stl::move(*pivotPos);
+    *pivotPos = tiny_stl::move(pivot);
+
+    return tiny_stl::make_pair(pivotPos, partitioned);
+}
+
+static const std::size_t PARTITION_BLOCK_SIZE = 64;
+
+// swap the elements at l + offsetsL[i] and r - offsetsR[i]. for unequal
+// counts the cyclic permutation needs fewer moves than the swaps
+template <typename RanIter>
+inline void swapOffsets(RanIter l, RanIter r, const unsigned char* offsetsL,
+                        const unsigned char* offsetsR, std::size_t num,
+                        bool useSwaps) {
+    if (useSwaps) {
+        for (std::size_t i = 0; i < num; ++i)
+            tiny_stl::iter_swap(l + offsetsL[i], r - offsetsR[i]);
+    } else if (num > 0) {
+        RanIter left = l + offsetsL[0];
+        RanIter right = r - offsetsR[0];
+        auto tmp = tiny_stl::move(*left);
+        *left = tiny_stl::move(*right);
+        for (std::size_t i = 1; i < num; ++i) {
+            left = l + offsetsL[i];
+            *right = tiny_stl::move(*left);
+            right = r - offsetsR[i];
+            *left = tiny_stl::move(*right);
+        }
+        *right = tiny_stl::move(tmp);
+    }
+}
+
+// BlockQuicksort partition, same result as the one above. the comparison
+// results only advance the offset counters, the misplaced elements of a
+// block are then swapped in a loop without data dependent branches
+template <typename RanIter, typename Compare>
+inline pair<RanIter, bool> partitionRight(RanIter first, RanIter last,
+                                          Compare& cmp, true_type) {
+    const std::size_t kBlock = PARTITION_BLOCK_SIZE;
+    auto pivot = tiny_stl::move(*first);
 
     RanIter i = first;
-    for (RanIter j = first; j < last - 1; ++j) {
-        if (cmp(*j, key)) {
-            tiny_stl::iter_swap(i++, j);
+    RanIter j = last;
+
+    while (cmp(*++i, pivot))
+        ;
+
+    if (i - 1 == first)
+        while (i < j && !cmp(*--j, pivot))
+            ;
+    else
+        while (!cmp(*--j, pivot))
+            ;
+
+    bool partitioned = i >= j;
+
+    if (!partitioned) {
+        tiny_stl::iter_swap(i, j);
+        ++i;
+
+        alignas(64) unsigned char offsetsL[PARTITION_BLOCK_SIZE];
+        alignas(64) unsigned char offsetsR[PARTITION_BLOCK_SIZE];
+        RanIter baseL = i;
+        RanIter baseR = j;
+        std::size_t numL = 0, numR = 0, startL = 0, startR = 0;
+
+        // [i, j) is unknown. offsetsL records the elements >= pivot from
+        // baseL, offsetsR the elements < pivot before baseR
+        while (i < j) {
+            const std::size_t unknown = static_cast<std::size_t>(j - i);
+            const std::size_t splitL =
+                numL == 0 ? (numR == 0 ? unknown / 2 : unknown) : 0;
+            const std::size_t splitR = numR == 0 ? unknown - splitL : 0;
+
+            const std::size_t countL = splitL < kBlock ? splitL : kBlock;
+            for (std::size_t k = 0; k < countL; ++k, ++i) {
+                offsetsL[numL] = static_cast<unsigned char>(k);
+                numL += !cmp(*i, pivot);
+            }
+
+            const std::size_t countR = splitR < kBlock ? splitR : kBlock;
+            for (std::size_t k = 0; k < countR;) {
+                offsetsR[numR] = static_cast<unsigned char>(++k);
+                numR += cmp(*--j, pivot);
+            }
+
+            const std::size_t num = numL < numR ? numL : numR;
+            swapOffsets(baseL, baseR, offsetsL + startL, offsetsR + startR,
+                        num, numL == numR);
+            numL -= num;
+            numR -= num;
+            startL += num;
+            startR += num;
+
+            if (numL == 0) {
+                startL = 0;
+                baseL = i;
+            }
+            if (numR == 0) {
+                startR = 0;
+                baseR = j;
+            }
         }
+
+        // at most one side has leftovers, move them to the middle
+        if (numL != 0) {
+            while (numL-- != 0)
+                tiny_stl::iter_swap(baseL + offsetsL[startL + numL], --j);
+            i = j;
+        }
+        if (numR != 0) {
+            while (numR-- != 0)
+                tiny_stl::iter_swap(baseR - offsetsR[startR + numR], i++);
+            j = i;
+        }
+    }
+
+    RanIter pivotPos = i - 1;
+    *first = tiny_stl::move(*pivotPos);
+    *pivotPos = tiny_stl::move(pivot);
+
+    return tiny_stl::make_pair(pivotPos, partitioned);
+}
+
+// partition around the pivot *first, the elements equal to it go left.
+// only used when *(first - 1) == pivot, so the left part needs no sort
+template <typename RanIter, typename Compare>
+inline RanIter partitionLeft(RanIter first, RanIter last, Compare& cmp) {
+    auto pivot = tiny_stl::move(*first);
+
+    RanIter i = first;
+    RanIter j = last;
+
+    while (cmp(pivot, *--j))
+        ;
+
+    if (j + 1 == last)
+        while (i < j && !cmp(pivot, *++i))
+            ;
+    else
+        while (!cmp(pivot, *++i))
+            ;
+
+    while (i < j) {
+        tiny_stl::iter_swap(i, j);
+        while (cmp(pivot, *--j))
+            ;
+        while (!cmp(pivot, *++i))
+            ;
     }
-    tiny_stl::iter_swap(i, last - 1);
 
-    return i;
+    *first = tiny_stl::move(*j);
+    *j = tiny_stl::move(pivot);
+
+    return j;
 }
 
-static const std::ptrdiff_t INSERT_SORT_MAX = 32;
+static const std::ptrdiff_t INSERT_SORT_MAX = 24;
+static const std::ptrdiff_t NINTHER_MIN = 128;
 
+// shuffle some elements to break the pattern of a bad partition
+template <typename RanIter>
+inline void breakPatterns(RanIter first, RanIter last,
+                          IterDiffType<RanIter> count) {
+    if (count < INSERT_SORT_MAX)
+        return;
+
+    const IterDiffType<RanIter> quarter = count / 4;
+    tiny_stl::iter_swap(first, first + quarter);
+    tiny_stl::iter_swap(last - 1, last - quarter);
+
+    if (count > NINTHER_MIN) {
+        tiny_stl::iter_swap(first + 1, first + (quarter + 1));
+        tiny_stl::iter_swap(first + 2, first + (quarter + 2));
+        tiny_stl::iter_swap(last - 2, last - (quarter + 1));
+        tiny_stl::iter_swap(last - 3, last - (quarter + 2));
+    }
+}
+
+// move the median of three, or Tukey's ninther for the large range, to
+// *first. *(last - 1) is then not less than the pivot
 template <typename RanIter, typename Compare>
-inline void quickSort(RanIter first, RanIter last, IterDiffType<RanIter> diff,
-                      Compare& cmp) {
-    IterDiffType<RanIter> count = last - first;
-    if (count > INSERT_SORT_MAX && diff > 0) {
-        RanIter miditer = quickSortPartition(first, last, cmp);
+inline void choosePivot(RanIter first, RanIter last, Compare& cmp) {
+    const IterDiffType<RanIter> count = last - first;
+    const IterDiffType<RanIter> half = count / 2;
+    if (count > NINTHER_MIN) {
+        sort3(first, first + half, last - 1, cmp);
+        sort3(first + 1, first + (half - 1), last - 2, cmp);
+        sort3(first + 2, first + (half + 1), last - 3, cmp);
+        sort3(first + (half - 1), first + half, first + (half + 1), cmp);
+        tiny_stl::iter_swap(first, first + half);
+    } else {
+        sort3(first + half, first, last - 1, cmp);
+    }
+}
+
+// leftmost: [first, last) is the leftmost part, there is no
+//           *(first - 1) as the sentinel
+// badAllowed: the number of unbalanced partitions before heap_sort
+template <typename RanIter, typename Compare>
+inline void pdqSort(RanIter first, RanIter last, int badAllowed,
+                    bool leftmost, Compare& cmp) {
+    using Diff = IterDiffType<RanIter>;
+
+    while (true) {
+        const Diff count = last - first;
+        if (count < INSERT_SORT_MAX) {
+            if (leftmost)
+                insertSort(first, last, cmp);
+            else
+                unguardedInsertSort(first, last, cmp);
+            return;
+        }
+
+        choosePivot(first, last, cmp);
+
+        // the pivot equals the previous pivot, which is not greater than
+        // any element here. many duplicates, skip the equal elements
+        if (!leftmost && !cmp(*(first - 1), *first)) {
+            first = partitionLeft(first, last, cmp) + 1;
+            continue;
+        }
+
+        pair<RanIter, bool> ret = partitionRight(
+            first, last, cmp,
+            IsBranchlessCompare<IteratorValueType<RanIter>, Compare>{});
+        const RanIter pivotPos = ret.first;
+        const Diff leftCount = pivotPos - first;
+        const Diff rightCount = last - (pivotPos + 1);
+
+        if (leftCount < count / 8 || rightCount < count / 8) {
+            if (--badAllowed == 0) { // O(nlogn) in the worst case
+                tiny_stl::make_heap(first, last, cmp);
+                tiny_stl::sort_heap(first, last, cmp);
+                return;
+            }
+
+            breakPatterns(first, pivotPos, leftCount);
+            breakPatterns(pivotPos + 1, last, rightCount);
+        } else if (ret.second && partialInsertSort(first, pivotPos, cmp) &&
+                   partialInsertSort(pivotPos + 1, last, cmp)) {
+            return; // already sorted
+        }
+
+        // recurse into the left, loop on the right
+        pdqSort(first, pivotPos, badAllowed, leftmost, cmp);
+        first = pivotPos + 1;
+        leftmost = false;
+    }
+}
+
+template <typename Diff>
+inline int sortDepthLimit(Diff count) {
+    int depth = 0;
+    for (; count > 1; count >>= 1)
+        ++depth;
+
+    return depth;
+}
+
+// radix_sort
+template <std::size_t Size>
+struct RadixUInt;
+
+template <>
+struct RadixUInt<1> {
+    using type = std::uint8_t;
+};
+
+template <>
+struct RadixUInt<2> {
+    using type = std::uint16_t;
+};
+
+template <>
+struct RadixUInt<4> {
+    using type = std::uint32_t;
+};
+
+template <>
+struct RadixUInt<8> {
+    using type = std::uint64_t;
+};
+
+// map the key to an unsigned integer with the same order
+template <typename K, bool = is_floating_point<K>::value>
+struct RadixKey {
+    using Bits = typename RadixUInt<sizeof(K)>::type;
+
+    static Bits toBits(K k) noexcept {
+        // flip the sign bit, negative integers go first
+        const Bits signBit =
+            is_signed<K>::value
+                ? static_cast<Bits>(Bits(1) << (sizeof(K) * 8 - 1))
+                : Bits(0);
+        return static_cast<Bits>(static_cast<Bits>(k) ^ signBit);
+    }
+};
 
-        diff = (diff >> 1) + (diff >> 2);
+template <typename K>
+struct RadixKey<K, true> {
+    static_assert(sizeof(K) <= 8, "radix_sort needs an IEEE float or double");
 
-        quickSort(first, miditer, diff, cmp);
-        first = miditer;
+    using Bits = typename RadixUInt<sizeof(K)>::type;
 
-        quickSort(miditer + 1, last, diff, cmp);
-        last = miditer + 1;
+    static Bits toBits(K k) noexcept {
+        // negative: flip all bits, positive: flip the sign bit
+        Bits bits;
+        std::memcpy(&bits, &k, sizeof(K));
+        const Bits signBit = static_cast<Bits>(Bits(1) << (sizeof(K) * 8 - 1));
+        const Bits mask = static_cast<Bits>(
+            static_cast<Bits>(0 - (bits >> (sizeof(K) * 8 - 1))) | signBit);
+        return static_cast<Bits>(bits ^ mask);
     }
+};
 
-    if (count > INSERT_SORT_MAX) {
-        tiny_stl::make_heap(first, last, cmp);
-        tiny_stl::sort_heap(first, last, cmp);
+struct RadixIdentity {
+    template <typename T>
+    const T& operator()(const T& x) const noexcept {
+        return x;
     }
+};
+
+template <std::size_t Idx, typename KeyFn>
+struct RadixGet {
+    KeyFn key;
+
+    template <typename T>
+    auto operator()(const T& x) const {
+        return get<Idx>(key(x));
+    }
+};
+
+static const std::size_t RADIX_BUCKETS = 256;
 
-    else if (count >= 2) {
-        insertSort(first, last, cmp);
+template <typename Iter, typename BitsFn, std::size_t Bytes>
+inline void radixHistogram(Iter it, std::size_t n,
+                           std::size_t (&counts)[Bytes][RADIX_BUCKETS],
+                           BitsFn& bits) {
+    for (std::size_t i = 0; i < n; ++i, ++it) {
+        const auto v = bits(*it);
+        for (std::size_t b = 0; b < Bytes; ++b)
+            ++counts[b][(v >> (b * 8)) & 0xFF];
     }
 }
 
+// stable, offsets are the bucket positions in dst
+template <typename Src, typename Dst, typename BitsFn>
+inline void radixScatter(Src src, std::size_t n, Dst dst, std::size_t* offsets,
+                         std::size_t shift, BitsFn& bits) {
+    for (std::size_t i = 0; i < n; ++i, ++src)
+        *(dst + offsets[(bits(*src) >> shift) & 0xFF]++) = tiny_stl::move(*src);
+}
+
+// the elements are in [first, first + n) or in buf, inBuffer tells which.
+// one histogram pass for all bytes, then a counting pass per byte from the
+// lowest one. a byte that is the same in every key needs no pass
+template <typename Bits, typename RanIter, typename T, typename BitsFn>
+inline void radixSortBits(RanIter first, std::size_t n, T* buf,
+                          bool& inBuffer, BitsFn bits) {
+    std::size_t counts[sizeof(Bits)][RADIX_BUCKETS] = {};
+    Bits firstBits;
+    if (inBuffer) {
+        radixHistogram(buf, n, counts, bits);
+        firstBits = bits(*buf);
+    } else {
+        radixHistogram(first, n, counts, bits);
+        firstBits = bits(*first);
+    }
+
+    for (std::size_t b = 0; b < sizeof(Bits); ++b) {
+        std::size_t* offsets = counts[b];
+        const std::size_t shift = b * 8;
+        if (offsets[(firstBits >> shift) & 0xFF] == n)
+            continue;
+
+        std::size_t sum = 0;
+        for (std::size_t k = 0; k < RADIX_BUCKETS; ++k) {
+            const std::size_t count = offsets[k];
+            offsets[k] = sum;
+            sum += count;
+        }
+
+        if (inBuffer)
+            radixScatter(buf, n, first, offsets, shift, bits);
+        else
+            radixScatter(first, n, buf, offsets, shift, bits);
+        inBuffer = !inBuffer;
+    }
+}
+
+template <typename RanIter, typename T, typename KeyFn>
+inline void radixSortKey(RanIter first, std::size_t n, T* buf, bool& inBuffer,
+                         KeyFn key, bool descending);
+
+template <typename RanIter, typename T, typename KeyFn>
+inline void radixSortTuple(RanIter, std::size_t, T*, bool&, KeyFn, bool,
+                           integral_constant<std::size_t, 0>) {
+}
+
+// pair and tuple keys, sort by the last component first
+template <typename RanIter, typename T, typename KeyFn, std::size_t Idx>
+inline void radixSortTuple(RanIter first, std::size_t n, T* buf,
+                           bool& inBuffer, KeyFn key, bool descending,
+                           integral_constant<std::size_t, Idx>) {
+    radixSortKey(first, n, buf, inBuffer, RadixGet<Idx - 1, KeyFn>{key},
+                 descending);
+    radixSortTuple(first, n, buf, inBuffer, key, descending,
+                   integral_constant<std::size_t, Idx - 1>{});
+}
+
+template <typename K, typename RanIter, typename T, typename KeyFn>
+inline void radixSortKeyAux(RanIter first, std::size_t n, T* buf,
+                            bool& inBuffer, KeyFn& key, bool descending,
+                            true_type /* arithmetic */) {
+    using Bits = typename RadixKey<K>::Bits;
+    const Bits flip = descending ? static_cast<Bits>(~Bits(0)) : Bits(0);
+    radixSortBits<Bits>(first, n, buf, inBuffer, [&key, flip](const T& x) {
+        return static_cast<Bits>(RadixKey<K>::toBits(key(x)) ^ flip);
+    });
+}
+
+template <typename K, typename RanIter, typename T, typename KeyFn>
+inline void radixSortKeyAux(RanIter first, std::size_t n, T* buf,
+                            bool& inBuffer, KeyFn& key, bool descending,
+                            false_type /* pair or tuple */) {
+    radixSortTuple(first, n, buf, inBuffer, key, descending,
+                   integral_constant<std::size_t, tuple_size<K>::value>{});
+}
+
+template <typename RanIter, typename T, typename KeyFn>
+inline void radixSortKey(RanIter first, std::size_t n, T* buf, bool& inBuffer,
+                         KeyFn key, bool descending) {
+    using K = decay_t<decltype(key(*buf))>;
+    radixSortKeyAux<K>(first, n, buf, inBuffer, key, descending,
+                       is_arithmetic<K>{});
+}
+
+// raw storage for the radix passes and the merges, it may get less
+// than asked and never throws
+template <typename T>
+class TemporaryBuffer {
+private:
+    T* ptr;
+    std::ptrdiff_t len;
+
+public:
+    explicit TemporaryBuffer(std::ptrdiff_t want) : ptr(nullptr), len(0) {
+        for (; want > 0 && ptr == nullptr; want /= 2) {
+            ptr = static_cast<T*>(::operator new(
+                static_cast<std::size_t>(want) * sizeof(T), std::nothrow));
+            len = want;
+        }
+        if (ptr == nullptr)
+            len = 0;
+    }
+
+    TemporaryBuffer(const TemporaryBuffer&) = delete;
+    TemporaryBuffer& operator=(const TemporaryBuffer&) = delete;
+
+    ~TemporaryBuffer() {
+        ::operator delete(ptr);
+    }
+
+    T* data() const noexcept {
+        return ptr;
+    }
+
+    std::ptrdiff_t size() const noexcept {
+        return len;
+    }
+}; // class TemporaryBuffer<T>
+
+// trivially copyable elements are assigned into the raw buffer, others
+// are moved into it first
+template <typename RanIter, typename T>
+inline bool radixPrepare(RanIter, std::size_t, T*, true_type) noexcept {
+    return false;
+}
+
+template <typename RanIter, typename T>
+inline bool radixPrepare(RanIter first, std::size_t n, T* buf, false_type) {
+    std::size_t i = 0;
+    try {
+        for (; i < n; ++i, ++first)
+            ::new (static_cast<void*>(buf + i)) T(tiny_stl::move(*first));
+    } catch (...) {
+        for (std::size_t k = 0; k < i; ++k)
+            tiny_stl::destroy_at(buf + k);
+        throw;
+    }
+    return true;
+}
+
+template <typename T>
+inline void radixRelease(T*, std::size_t, true_type) noexcept {
+}
+
+template <typename T>
+inline void radixRelease(T* buf, std::size_t n, false_type) noexcept {
+    for (std::size_t k = 0; k < n; ++k)
+        tiny_stl::destroy_at(buf + k);
+}
+
+// buf is raw storage for n elements
+template <typename RanIter, typename T, typename KeyFn>
+inline void radixSortBuffer(RanIter first, std::size_t n, T* buf, KeyFn key,
+                            bool descending) {
+    using Trivial = bool_constant<std::is_trivially_copyable<T>::value>;
+
+    bool inBuffer = radixPrepare(first, n, buf, Trivial{});
+    try {
+        radixSortKey(first, n, buf, inBuffer, key, descending);
+        if (inBuffer)
+            tiny_stl::move(buf, buf + n, first);
+    } catch (...) {
+        radixRelease(buf, n, Trivial{});
+        throw;
+    }
+    radixRelease(buf, n, Trivial{});
+}
+
+template <typename RanIter, typename KeyFn>
+inline void radixSort(RanIter first, RanIter last, KeyFn key,
+                      bool descending) {
+    using T = IteratorValueType<RanIter>;
+
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < 2)
+        return;
+
+    allocator<T> alloc;
+    T* const buf = alloc.allocate(n);
+    try {
+        radixSortBuffer(first, n, buf, key, descending);
+    } catch (...) {
+        alloc.deallocate(buf, n);
+        throw;
+    }
+    alloc.deallocate(buf, n);
+}
+
+template <typename Cmp>
+struct IsGreaterCompare : false_type {};
+
+template <typename T>
+struct IsGreaterCompare<greater<T>> : true_type {};
+
+// the radix passes beat the comparisons above this size
+static const std::ptrdiff_t RADIX_SORT_MIN = 1024;
+
+template <typename RanIter, typename Compare>
+inline void sortAux(RanIter first, RanIter last, Compare& cmp, false_type) {
+    pdqSort(first, last, sortDepthLimit(last - first), true, cmp);
+}
+
+template <typename RanIter, typename Compare>
+inline void sortAux(RanIter first, RanIter last, Compare& cmp,
+                    true_type /* arithmetic key, less or greater */) {
+    // pdqSort finishes the sorted and the reversed input in one pass, the
+    // checks stop at the first out of order pair on the other inputs
+    auto rcmp = [&cmp](const auto& lhs, const auto& rhs) {
+        return cmp(rhs, lhs);
+    };
+    if (last - first < RADIX_SORT_MIN ||
+        tiny_stl::is_sorted_until(first, last, cmp) == last ||
+        tiny_stl::is_sorted_until(first, last, rcmp) == last) {
+        sortAux(first, last, cmp, false_type{});
+        return;
+    }
+
+    // sort does not throw bad_alloc, pdqSort needs no buffer
+    TemporaryBuffer<IteratorValueType<RanIter>> buf(last - first);
+    if (buf.size() != last - first) {
+        sortAux(first, last, cmp, false_type{});
+        return;
+    }
+
+    radixSortBuffer(first, static_cast<std::size_t>(last - first),
+                    buf.data(), RadixIdentity{},
+                    IsGreaterCompare<Compare>::value);
+}
+
 } // namespace details
 
 template <typename RanIter, typename Compare>
 inline void sort(RanIter first, RanIter last, Compare cmp) {
-    if (last - first - 1 > 0) {
-        details::quickSort(first, last, last - first, cmp);
+    using T = typename iterator_traits<RanIter>::value_type;
+    if (last - first > 1) {
+        details::sortAux(
+            first, last, cmp,
+            bool_constant<IsBranchlessCompare<T, Compare>::value &&
+                          sizeof(T) <= 8>{});
     }
 }
 
 template <typename RanIter>
 inline void sort(RanIter first, RanIter last) {
-    sort(first, last, tiny_stl::less<>{});
+    tiny_stl::sort(first, last, tiny_stl::less<>{});
+}
+
+// stable LSD radix sort on key(x), which is an integer, a float, a double
+// or a pair/tuple of them. needs a buffer of last - first elements, throws
+// bad_alloc if it cannot get one
+template <typename RanIter, typename KeyFn>
+inline void radix_sort(RanIter first, RanIter last, KeyFn key) {
+    details::radixSort(first, last, key, false);
+}
+
+template <typename RanIter>
+inline void radix_sort(RanIter first, RanIter last) {
+    details::radixSort(first, last, details::RadixIdentity{}, false);
+}
+
+namespace details {
+
+// partial_sort
+// the smallest middle - first elements to a max heap in [first, middle)
+template <typename RanIter, typename Compare>
+inline void heapSelect(RanIter first, RanIter middle, RanIter last,
+                       Compare& cmp) {
+    tiny_stl::make_heap(first, middle, cmp);
+    for (RanIter i = middle; i < last; ++i) {
+        if (cmp(*i, *first)) { // replace the top
+            auto val = tiny_stl::move(*i);
+            popHeapHelper(first, middle, i, tiny_stl::move(val), cmp);
+        }
+    }
+}
+
+// nth_element
+template <typename RanIter, typename Compare>
+inline void introSelect(RanIter first, RanIter nth, RanIter last,
+                        Compare& cmp) {
+    int depth = sortDepthLimit(last - first) * 2;
+    bool leftmost = true;
+
+    while (last - first > INSERT_SORT_MAX) {
+        if (depth-- == 0) { // O(nlogn) in the worst case
+            heapSelect(first, nth + 1, last, cmp);
+            tiny_stl::iter_swap(first, nth);
+            return;
+        }
+
+        choosePivot(first, last, cmp);
+
+        // as in pdqSort, the equal elements are the smallest ones here
+        if (!leftmost && !cmp(*(first - 1), *first)) {
+            const RanIter equalLast = partitionLeft(first, last, cmp);
+            if (nth <= equalLast)
+                return;
+            first = equalLast + 1;
+            continue;
+        }
+
+        const RanIter pivotPos =
+            partitionRight(
+                first, last, cmp,
+                IsBranchlessCompare<IteratorValueType<RanIter>, Compare>{})
+                .first;
+
+        if (pivotPos == nth)
+            return;
+        if (nth < pivotPos) {
+            last = pivotPos;
+        } else {
+            first = pivotPos + 1;
+            leftmost = false;
+        }
+    }
+
+    insertSort(first, last, cmp);
+}
+
+// stable_sort, timsort with the powersort merge policy
+template <typename RanIter, typename T, typename Compare>
+inline RanIter lowerBoundAux(RanIter first, RanIter last, const T& val,
+                             Compare& cmp) {
+    IterDiffType<RanIter> count = last - first;
+    while (count > 0) {
+        const IterDiffType<RanIter> step = count / 2;
+        const RanIter mid = first + step;
+        if (cmp(*mid, val)) {
+            first = mid + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+template <typename RanIter, typename T, typename Compare>
+inline RanIter upperBoundAux(RanIter first, RanIter last, const T& val,
+                             Compare& cmp) {
+    IterDiffType<RanIter> count = last - first;
+    while (count > 0) {
+        const IterDiffType<RanIter> step = count / 2;
+        const RanIter mid = first + step;
+        if (!cmp(val, *mid)) {
+            first = mid + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+// lower bound, probing first[0], first[2], first[6], ... before the
+// binary search. cheap when the answer is near first
+template <typename RanIter, typename T, typename Compare>
+inline RanIter gallopLower(RanIter first, RanIter last, const T& key,
+                           Compare& cmp) {
+    using Diff = IterDiffType<RanIter>;
+    const Diff len = last - first;
+    Diff prev = 0;
+    Diff ofs = 1;
+    while (ofs <= len && cmp(*(first + (ofs - 1)), key)) {
+        prev = ofs;
+        ofs = ofs * 2 + 1;
+    }
+
+    return lowerBoundAux(first + prev, first + (ofs - 1 < len ? ofs - 1 : len),
+                         key, cmp);
+}
+
+template <typename RanIter, typename T, typename Compare>
+inline RanIter gallopUpper(RanIter first, RanIter last, const T& key,
+                           Compare& cmp) {
+    using Diff = IterDiffType<RanIter>;
+    const Diff len = last - first;
+    Diff prev = 0;
+    Diff ofs = 1;
+    while (ofs <= len && !cmp(key, *(first + (ofs - 1)))) {
+        prev = ofs;
+        ofs = ofs * 2 + 1;
+    }
+
+    return upperBoundAux(first + prev, first + (ofs - 1 < len ? ofs - 1 : len),
+                         key, cmp);
+}
+
+// [first, sorted) is sorted
+template <typename RanIter, typename Compare>
+inline void binaryInsertSort(RanIter first, RanIter sorted, RanIter last,
+                             Compare& cmp) {
+    for (RanIter i = sorted; i != last; ++i) {
+        RanIter pos = upperBoundAux(first, i, *i, cmp);
+        if (pos != i) {
+            auto key = tiny_stl::move(*i);
+            tiny_stl::move_backward(pos, i, i + 1);
+            *pos = tiny_stl::move(key);
+        }
+    }
+}
+
+// the length of the run at first, a strictly descending run is reversed
+template <typename RanIter, typename Compare>
+inline IterDiffType<RanIter> countRun(RanIter first, RanIter last,
+                                      Compare& cmp) {
+    RanIter run = first + 1;
+    if (run == last)
+        return 1;
+
+    if (cmp(*run, *first)) {
+        while (++run != last && cmp(*run, *(run - 1)))
+            ;
+        tiny_stl::reverse(first, run);
+    } else {
+        while (++run != last && !cmp(*run, *(run - 1)))
+            ;
+    }
+
+    return run - first;
+}
+
+template <typename Compare>
+struct FlipCompare {
+    Compare& cmp;
+
+    template <typename T1, typename T2>
+    bool operator()(const T1& lhs, const T2& rhs) const {
+        return cmp(rhs, lhs);
+    }
+};
+
+static const std::ptrdiff_t MIN_GALLOP = 7;
+
+// move [first, mid) to the raw buffer and merge it with [mid, last) from
+// the left. after MIN_GALLOP wins in a row of one side, gallop to find
+// how many elements it wins and move them at once
+template <typename RanIter, typename BufIter, typename Compare>
+inline void mergeLo(RanIter first, RanIter mid, RanIter last, BufIter buf,
+                    Compare& cmp) {
+    using T = IteratorValueType<RanIter>;
+    using Diff = IterDiffType<RanIter>;
+
+    BufIter bufEnd = buf;
+    for (RanIter it = first; it != mid; ++it, ++bufEnd)
+        ::new (static_cast<void*>(tiny_stl::addressof(*bufEnd)))
+            T(tiny_stl::move(*it));
+
+    BufIter x = buf;
+    RanIter y = mid;
+    RanIter dst = first; // the hole [dst, y) fits [x, bufEnd)
+    try {
+        Diff winX = 0;
+        Diff winY = 0;
+        while (x != bufEnd && y != last) {
+            if (cmp(*y, *x)) {
+                *dst++ = tiny_stl::move(*y++);
+                winX = 0;
+                if (++winY >= MIN_GALLOP) {
+                    const RanIter yEnd = gallopLower(y, last, *x, cmp);
+                    dst = tiny_stl::move(y, yEnd, dst);
+                    y = yEnd;
+                    winY = 0;
+                }
+            } else {
+                *dst++ = tiny_stl::move(*x++);
+                winY = 0;
+                if (++winX >= MIN_GALLOP && y != last) {
+                    const BufIter xEnd = gallopUpper(x, bufEnd, *y, cmp);
+                    dst = tiny_stl::move(x, xEnd, dst);
+                    x = xEnd;
+                    winX = 0;
+                }
+            }
+        }
+    } catch (...) {
+        tiny_stl::move(x, bufEnd, dst);
+        for (BufIter it = buf; it != bufEnd; ++it)
+            tiny_stl::destroy_at(tiny_stl::addressof(*it));
+        throw;
+    }
+
+    // the rest of [mid, last) is in place
+    tiny_stl::move(x, bufEnd, dst);
+    for (BufIter it = buf; it != bufEnd; ++it)
+        tiny_stl::destroy_at(tiny_stl::addressof(*it));
+}
+
+// the mirror of mergeLo, [mid, last) goes to the buffer
+template <typename RanIter, typename T, typename Compare>
+inline void mergeHi(RanIter first, RanIter mid, RanIter last, T* buf,
+                    Compare& cmp) {
+    using RevIter = reverse_iterator<RanIter>;
+    FlipCompare<Compare> flip{cmp};
+    mergeLo(RevIter(last), RevIter(mid), RevIter(first),
+            reverse_iterator<T*>(buf + (last - mid)), flip);
+}
+
+// no buffer, O(nlogn) rotations
+template <typename RanIter, typename Compare>
+inline void mergeInPlace(RanIter first, RanIter mid, RanIter last,
+                         Compare& cmp) {
+    const IterDiffType<RanIter> len1 = mid - first;
+    const IterDiffType<RanIter> len2 = last - mid;
+    if (len1 == 0 || len2 == 0)
+        return;
+
+    if (len1 + len2 == 2) {
+        if (cmp(*mid, *first))
+            tiny_stl::iter_swap(first, mid);
+        return;
+    }
+
+    RanIter cut1, cut2;
+    if (len1 > len2) {
+        cut1 = first + len1 / 2;
+        cut2 = lowerBoundAux(mid, last, *cut1, cmp);
+    } else {
+        cut2 = mid + len2 / 2;
+        cut1 = upperBoundAux(first, mid, *cut2, cmp);
+    }
+
+    const RanIter newMid = tiny_stl::rotate(cut1, mid, cut2);
+    mergeInPlace(first, cut1, newMid, cmp);
+    mergeInPlace(newMid, cut2, last, cmp);
+}
+
+template <typename RanIter, typename T, typename Compare>
+inline void mergeRuns(RanIter first, RanIter mid, RanIter last, T* buf,
+                      std::ptrdiff_t bufLen, Compare& cmp) {
+    // the head of the left run and the tail of the right run stay
+    first = gallopUpper(first, mid, *mid, cmp);
+    if (first == mid)
+        return;
+    last = gallopLower(mid, last, *(mid - 1), cmp);
+
+    const IterDiffType<RanIter> len1 = mid - first;
+    const IterDiffType<RanIter> len2 = last - mid;
+    if (len1 <= len2 && len1 <= bufLen)
+        mergeLo(first, mid, last, buf, cmp);
+    else if (len2 < len1 && len2 <= bufLen)
+        mergeHi(first, mid, last, buf, cmp);
+    else
+        mergeInPlace(first, mid, last, cmp);
+}
+
+static const std::ptrdiff_t MIN_MERGE = 64;
+
+// n / 2^k in [32, 64], rounded up when a bit is shifted out, so the
+// runs split n evenly
+inline std::ptrdiff_t minRunLength(std::ptrdiff_t n) {
+    std::ptrdiff_t r = 0;
+    while (n >= MIN_MERGE) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+// powersort: the depth of the node between the run [s1, s1 + n1) and the
+// run [s1 + n1, s1 + n1 + n2) in the balanced merge tree of [0, n)
+inline int runPower(std::ptrdiff_t s1, std::ptrdiff_t n1, std::ptrdiff_t n2,
+                    std::ptrdiff_t n) {
+    std::ptrdiff_t a = 2 * s1 + n1;
+    std::ptrdiff_t b = a + n1 + n2;
+    int power = 0;
+    while (true) {
+        ++power;
+        if (a >= n) {
+            a -= n;
+            b -= n;
+        } else if (b >= n) {
+            break;
+        }
+        a <<= 1;
+        b <<= 1;
+    }
+    return power;
+}
+
+template <typename RanIter, typename Compare>
+inline void timSort(RanIter first, RanIter last, Compare& cmp) {
+    using Diff = IterDiffType<RanIter>;
+    using T = IteratorValueType<RanIter>;
+
+    const Diff n = last - first;
+    if (n < 2)
+        return;
+
+    if (n <= MIN_MERGE) {
+        binaryInsertSort(first, first + countRun(first, last, cmp), last, cmp);
+        return;
+    }
+
+    struct Run {
+        Diff start;
+        Diff len;
+        int power; // of the boundary to the next run
+    };
+
+    TemporaryBuffer<T> buf((n + 1) / 2);
+    const Diff minRun = minRunLength(n);
+    Run runs[sizeof(Diff) * 8 + 2];
+    int top = 0;
+
+    auto mergeTop = [&] {
+        Run& lhs = runs[top - 2];
+        const Run& rhs = runs[top - 1];
+        mergeRuns(first + lhs.start, first + rhs.start,
+                  first + (rhs.start + rhs.len), buf.data(), buf.size(), cmp);
+        lhs.len += rhs.len;
+        --top;
+    };
+
+    for (Diff lo = 0; lo < n;) {
+        Diff len = countRun(first + lo, last, cmp);
+        if (len < minRun) { // extend the short run
+            const Diff forced = tiny_stl::min(minRun, n - lo);
+            binaryInsertSort(first + lo, first + (lo + len),
+                             first + (lo + forced), cmp);
+            len = forced;
+        }
+
+        if (top > 0) {
+            const Run& prev = runs[top - 1];
+            const int power = runPower(prev.start, prev.len, len, n);
+            while (top > 1 && runs[top - 2].power > power)
+                mergeTop();
+            runs[top - 1].power = power;
+        }
+
+        runs[top++] = Run{lo, len, 0};
+        lo += len;
+    }
+
+    while (top > 1)
+        mergeTop();
+}
+
+} // namespace details
+
+// adaptive and stable, O(n) on the presorted runs. merges use a buffer of
+// n / 2 elements if it can be allocated, else they rotate in place
+template <typename RanIter, typename Compare>
+inline void stable_sort(RanIter first, RanIter last, Compare cmp) {
+    details::timSort(first, last, cmp);
+}
+
+template <typename RanIter>
+inline void stable_sort(RanIter first, RanIter last) {
+    tiny_stl::stable_sort(first, last, tiny_stl::less<>{});
+}
+
+// O(nlog(middle - first))
+template <typename RanIter, typename Compare>
+inline void partial_sort(RanIter first, RanIter middle, RanIter last,
+                         Compare cmp) {
+    if (first == middle)
+        return;
+
+    details::heapSelect(first, middle, last, cmp);
+    tiny_stl::sort_heap(first, middle, cmp);
+}
+
+template <typename RanIter>
+inline void partial_sort(RanIter first, RanIter middle, RanIter last) {
+    tiny_stl::partial_sort(first, middle, last, tiny_stl::less<>{});
+}
+
+// O(n) on average, quick select with the heap select fallback
+template <typename RanIter, typename Compare>
+inline void nth_element(RanIter first, RanIter nth, RanIter last,
+                        Compare cmp) {
+    if (nth == last)
+        return;
+
+    details::introSelect(first, nth, last, cmp);
+}
+
+template <typename RanIter>
+inline void nth_element(RanIter first, RanIter nth, RanIter last) {
+    tiny_stl::nth_element(first, nth, last, tiny_stl::less<>{});
 }
 
 template <typename FwdIter, typename T, typename Compare>
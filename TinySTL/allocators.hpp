@@ -144,6 +144,10 @@ public:
     }
 }; // class allocator<void>
 
+// stateless
+template <typename T>
+struct is_trivially_relocatable<allocator<T>> : true_type {};
+
 template <typename T>
 inline bool operator==(const allocator<T>& lhs,
                        const allocator<T>& rhs) noexcept {
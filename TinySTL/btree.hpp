@@ -0,0 +1,1112 @@
+﻿// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#include "memory.hpp"
+
+namespace tiny_stl {
+
+namespace details {
+
+// the bytes of the values of a node, a search touches a few cache lines
+// per level instead of one node per comparison
+static const std::size_t BTREE_NODE_BYTES = 256;
+
+// at least 3 values, a split keeps a separator and two non-empty halves
+constexpr std::size_t btreeSlots(std::size_t size) {
+    return BTREE_NODE_BYTES / size < 3 ? 3 : BTREE_NODE_BYTES / size;
+}
+
+template <typename T, std::size_t N>
+struct BTreeInternalNode;
+
+// the values of a node are sorted, the children of an internal node lie
+// in between: child(i) < value(i) < child(i + 1)
+template <typename T, std::size_t N>
+struct BTreeNode {
+    BTreeNode* parent; // nullptr for the root
+    std::uint16_t position; // the index in parent->child
+    std::uint16_t count;
+    bool isLeaf;
+    alignas(T) unsigned char buffer[sizeof(T) * N];
+
+    T* values() noexcept {
+        return reinterpret_cast<T*>(buffer);
+    }
+
+    T& value(std::size_t i) noexcept {
+        return values()[i];
+    }
+
+    // internal nodes only
+    BTreeNode*& child(std::size_t i) noexcept {
+        return static_cast<BTreeInternalNode<T, N>*>(this)->children[i];
+    }
+};
+
+template <typename T, std::size_t N>
+struct BTreeInternalNode : BTreeNode<T, N> {
+    BTreeNode<T, N>* children[N + 1];
+};
+
+} // namespace details
+
+template <typename T, std::size_t N>
+struct BTreeConstIterator {
+    using iterator_category = bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    using Ptr = details::BTreeNode<T, N>*;
+
+    Ptr node = nullptr;
+    int pos = 0;
+
+    BTreeConstIterator() = default;
+    BTreeConstIterator(Ptr x, int i) : node(x), pos(i) {
+    }
+
+    reference operator*() const {
+        return node->value(pos);
+    }
+
+    pointer operator->() const {
+        return pointer_traits<pointer>::pointer_to(**this);
+    }
+
+    BTreeConstIterator& operator++() {
+        if (!node->isLeaf) { // the first value of the right subtree
+            node = node->child(pos + 1);
+            while (!node->isLeaf)
+                node = node->child(0);
+            pos = 0;
+            return *this;
+        }
+
+        if (++pos < node->count)
+            return *this;
+
+        // the first ancestor on the left of which we are
+        BTreeConstIterator save = *this;
+        while (pos == node->count && node->parent != nullptr) {
+            pos = node->position;
+            node = node->parent;
+        }
+        if (pos == node->count) // end
+            *this = save;
+
+        return *this;
+    }
+
+    BTreeConstIterator operator++(int) {
+        BTreeConstIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    BTreeConstIterator& operator--() {
+        if (!node->isLeaf) { // the last value of the left subtree
+            node = node->child(pos);
+            while (!node->isLeaf)
+                node = node->child(node->count);
+            pos = node->count - 1;
+            return *this;
+        }
+
+        if (--pos >= 0)
+            return *this;
+
+        while (pos < 0 && node->parent != nullptr) {
+            pos = node->position - 1;
+            node = node->parent;
+        }
+
+        return *this;
+    }
+
+    BTreeConstIterator operator--(int) {
+        BTreeConstIterator tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    bool operator==(const BTreeConstIterator& rhs) const {
+        return node == rhs.node && pos == rhs.pos;
+    }
+
+    bool operator!=(const BTreeConstIterator& rhs) const {
+        return !(*this == rhs);
+    }
+}; // BTreeConstIterator
+
+template <typename T, std::size_t N>
+struct BTreeIterator : BTreeConstIterator<T, N> {
+    using iterator_category = bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    using Ptr = details::BTreeNode<T, N>*;
+    using Base = BTreeConstIterator<T, N>;
+
+    BTreeIterator() : Base() {
+    }
+    BTreeIterator(Ptr x, int i) : Base(x, i) {
+    }
+
+    reference operator*() const {
+        return const_cast<reference>(Base::operator*());
+    }
+
+    pointer operator->() const {
+        return pointer_traits<pointer>::pointer_to(**this);
+    }
+
+    BTreeIterator& operator++() {
+        ++*static_cast<Base*>(this);
+        return *this;
+    }
+
+    BTreeIterator operator++(int) {
+        BTreeIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    BTreeIterator& operator--() {
+        --*static_cast<Base*>(this);
+        return *this;
+    }
+
+    BTreeIterator operator--(int) {
+        BTreeIterator tmp = *this;
+        --*this;
+        return tmp;
+    }
+}; // BTreeIterator
+
+// B-tree with the values in all nodes, every leaf is at the same depth.
+// A node holds about BTREE_NODE_BYTES of values and is searched by
+// binary search. Insert and erase move the values inside a node, so they
+// invalidate all iterators
+template <typename T, typename Compare, typename Alloc, bool isMap>
+class BTree {
+public:
+    using key_type = typename AssociatedTypeHelper<T, isMap>::key_type;
+    using mapped_type = typename AssociatedTypeHelper<T, isMap>::mapped_type;
+    using value_type = T;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+
+    static const std::size_t SLOTS = details::btreeSlots(sizeof(T));
+    static const std::size_t MIN_SLOTS = SLOTS / 2;
+
+    using AlTraits = allocator_traits<Alloc>;
+    using Node = details::BTreeNode<T, SLOTS>;
+    using NodePtr = Node*;
+    using InternalNode = details::BTreeInternalNode<T, SLOTS>;
+    using AlNode = typename AlTraits::template rebind_alloc<Node>;
+    using AlNodeTraits = allocator_traits<AlNode>;
+    using AlInternal = typename AlTraits::template rebind_alloc<InternalNode>;
+
+    using iterator = BTreeIterator<value_type, SLOTS>;
+    using const_iterator = BTreeConstIterator<value_type, SLOTS>;
+    using reverse_iterator = tiny_stl::reverse_iterator<iterator>;
+    using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>;
+
+protected:
+    NodePtr root;
+    NodePtr leftmost;
+    NodePtr rightmost;
+    size_type mCount;
+    AlNode alloc;
+    Compare compare;
+
+private:
+    NodePtr allocNode(bool leaf) {
+        NodePtr p = nullptr;
+        if (leaf) {
+            p = alloc.allocate(1);
+        } else {
+            AlInternal al(alloc);
+            p = al.allocate(1);
+        }
+
+        p->parent = nullptr;
+        p->position = 0;
+        p->count = 0;
+        p->isLeaf = leaf;
+        return p;
+    }
+
+    // the values must be destroyed or moved out
+    void freeNode(NodePtr p) {
+        if (p->isLeaf) {
+            alloc.deallocate(p, 1);
+        } else {
+            AlInternal al(alloc);
+            al.deallocate(static_cast<InternalNode*>(p), 1);
+        }
+    }
+
+    template <typename... Args>
+    void constructValue(T* p, Args&&... args) {
+        AlNodeTraits::construct(alloc, p, tiny_stl::forward<Args>(args)...);
+    }
+
+    void destroyValue(T* p) {
+        AlNodeTraits::destroy(alloc, p);
+    }
+
+    // memmove for the relocatable values
+    void relocateAux(T* first, T* last, T* dst, true_type) {
+        if (first != last)
+            std::memmove(static_cast<void*>(dst),
+                         static_cast<const void*>(first),
+                         static_cast<std::size_t>(last - first) * sizeof(T));
+    }
+
+    void relocateAux(T* first, T* last, T* dst, false_type) {
+        if (dst <= first) {
+            for (; first != last; ++first, ++dst) {
+                constructValue(dst, tiny_stl::move(*first));
+                destroyValue(first);
+            }
+        } else {
+            dst += last - first;
+            while (last != first) {
+                constructValue(--dst, tiny_stl::move(*--last));
+                destroyValue(last);
+            }
+        }
+    }
+
+    // moves [first, last) to dst, the ranges may overlap. The source
+    // slots are raw memory afterwards
+    void relocate(T* first, T* last, T* dst) {
+        relocateAux(first, last, dst, UseRelocate<Alloc>{});
+    }
+
+    void setChild(NodePtr parent, std::size_t i, NodePtr child) {
+        parent->child(i) = child;
+        child->parent = parent;
+        child->position = static_cast<std::uint16_t>(i);
+    }
+
+    // map
+    const key_type& getKeyValue(const T& val, true_type) const {
+        return val.first;
+    }
+
+    // set
+    const key_type& getKeyValue(const T& val, false_type) const {
+        return val;
+    }
+
+    const key_type& getKeyFromValue(const T& val) const {
+        return getKeyValue(val, tiny_stl::bool_constant<isMap>{});
+    }
+
+    // the first value in node not less than key
+    template <typename K>
+    int lowerIndex(NodePtr node, const K& key) const {
+        int first = 0;
+        int len = node->count;
+        while (len > 0) {
+            const int half = len / 2;
+            if (compare(getKeyFromValue(node->value(first + half)), key)) {
+                first += half + 1;
+                len -= half + 1;
+            } else {
+                len = half;
+            }
+        }
+
+        return first;
+    }
+
+    // the first value in node greater than key
+    template <typename K>
+    int upperIndex(NodePtr node, const K& key) const {
+        int first = 0;
+        int len = node->count;
+        while (len > 0) {
+            const int half = len / 2;
+            if (!compare(key, getKeyFromValue(node->value(first + half)))) {
+                first += half + 1;
+                len -= half + 1;
+            } else {
+                len = half;
+            }
+        }
+
+        return first;
+    }
+
+    // the deepest candidate is the smallest one
+    template <typename K>
+    iterator lowBoundAux(const K& key) const {
+        iterator res = makeEnd();
+        for (NodePtr node = root; node != nullptr;) {
+            const int i = lowerIndex(node, key);
+            if (i < node->count)
+                res = iterator(node, i);
+            if (node->isLeaf)
+                break;
+            node = node->child(i);
+        }
+
+        return res;
+    }
+
+    template <typename K>
+    iterator uppBoundAux(const K& key) const {
+        iterator res = makeEnd();
+        for (NodePtr node = root; node != nullptr;) {
+            const int i = upperIndex(node, key);
+            if (i < node->count)
+                res = iterator(node, i);
+            if (node->isLeaf)
+                break;
+            node = node->child(i);
+        }
+
+        return res;
+    }
+
+    // stops at the first equal value on the path
+    template <typename K>
+    iterator findAux(const K& key) const {
+        for (NodePtr node = root; node != nullptr;) {
+            const int i = lowerIndex(node, key);
+            if (i < node->count &&
+                !compare(key, getKeyFromValue(node->value(i))))
+                return iterator(node, i);
+            if (node->isLeaf)
+                break;
+            node = node->child(i);
+        }
+
+        return makeEnd();
+    }
+
+    iterator makeEnd() const noexcept {
+        return rightmost == nullptr ? iterator(nullptr, 0)
+                                    : iterator(rightmost, rightmost->count);
+    }
+
+    // the successor of the last value of a node
+    iterator normalize(iterator iter) const noexcept {
+        if (iter.node == nullptr || iter.pos < iter.node->count)
+            return iter;
+
+        NodePtr node = iter.node;
+        int pos = iter.pos;
+        while (pos == node->count && node->parent != nullptr) {
+            pos = node->position;
+            node = node->parent;
+        }
+
+        return pos == node->count ? makeEnd() : iterator(node, pos);
+    }
+
+    // split a full node around pos, where a value will be inserted. The
+    // separator moves up to the parent, which is split first if it is
+    // full. Appending keeps the left node full, so sorted input fills
+    // the nodes completely
+    NodePtr splitNode(NodePtr node, int pos) {
+        NodePtr sibling = allocNode(node->isLeaf);
+        try {
+            if (node->parent == nullptr) {
+                NodePtr newRoot = allocNode(false);
+                setChild(newRoot, 0, node);
+                newRoot->parent = nullptr;
+                root = newRoot;
+            } else if (node->parent->count == SLOTS) {
+                splitNode(node->parent, node->position);
+            }
+        } catch (...) {
+            freeNode(sibling);
+            throw;
+        }
+
+        int keep = static_cast<int>(SLOTS / 2);
+        if (pos == static_cast<int>(SLOTS))
+            keep = static_cast<int>(SLOTS) - 1;
+        else if (pos == 0)
+            keep = 0;
+
+        const int moved = static_cast<int>(SLOTS) - keep - 1;
+        relocate(node->values() + keep + 1, node->values() + SLOTS,
+                 sibling->values());
+        if (!node->isLeaf) {
+            for (int j = 0; j <= moved; ++j)
+                setChild(sibling, j, node->child(keep + 1 + j));
+        }
+        sibling->count = static_cast<std::uint16_t>(moved);
+
+        // the separator to the parent, sibling on its right
+        NodePtr parent = node->parent;
+        const int at = node->position;
+        relocate(parent->values() + at, parent->values() + parent->count,
+                 parent->values() + at + 1);
+        relocate(node->values() + keep, node->values() + keep + 1,
+                 parent->values() + at);
+        for (int j = parent->count; j > at; --j)
+            setChild(parent, j + 1, parent->child(j));
+        setChild(parent, at + 1, sibling);
+        ++parent->count;
+        node->count = static_cast<std::uint16_t>(keep);
+
+        if (node == rightmost)
+            rightmost = sibling;
+
+        return sibling;
+    }
+
+    iterator insertAt(NodePtr node, int pos, T&& val) {
+        if (node == nullptr) { // empty tree
+            node = allocNode(true);
+            root = leftmost = rightmost = node;
+            pos = 0;
+        } else if (node->count == SLOTS) {
+            NodePtr sibling = splitNode(node, pos);
+            if (pos > node->count) {
+                pos -= node->count + 1;
+                node = sibling;
+            }
+        }
+
+        relocate(node->values() + pos, node->values() + node->count,
+                 node->values() + pos + 1);
+        constructValue(node->values() + pos, tiny_stl::move(val));
+        ++node->count;
+        ++mCount;
+
+        return iterator(node, pos);
+    }
+
+    template <typename... Args>
+    iterator insertEqualAux(Args&&... args) {
+        T value(tiny_stl::forward<Args>(args)...);
+        const key_type& key = getKeyFromValue(value);
+        NodePtr node = root;
+        int pos = 0;
+        while (node != nullptr) {
+            pos = upperIndex(node, key);
+            if (node->isLeaf)
+                break;
+            node = node->child(pos);
+        }
+
+        return insertAt(node, pos, tiny_stl::move(value));
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> insertUniqueAux(Args&&... args) {
+        T value(tiny_stl::forward<Args>(args)...);
+        const key_type& key = getKeyFromValue(value);
+        NodePtr node = root;
+        int pos = 0;
+        while (node != nullptr) {
+            pos = lowerIndex(node, key);
+            if (pos < node->count &&
+                !compare(key, getKeyFromValue(node->value(pos))))
+                return tiny_stl::make_pair(iterator(node, pos), false);
+            if (node->isLeaf)
+                break;
+            node = node->child(pos);
+        }
+
+        return tiny_stl::make_pair(insertAt(node, pos, tiny_stl::move(value)),
+                                   true);
+    }
+
+    // right is the right sibling of left, both with the separator fit
+    // in left
+    void mergeNodes(NodePtr left, NodePtr right) {
+        NodePtr parent = left->parent;
+        const int at = left->position;
+        const int leftCount = left->count;
+
+        relocate(parent->values() + at, parent->values() + at + 1,
+                 left->values() + leftCount);
+        relocate(right->values(), right->values() + right->count,
+                 left->values() + leftCount + 1);
+        if (!left->isLeaf) {
+            for (int j = 0; j <= right->count; ++j)
+                setChild(left, leftCount + 1 + j, right->child(j));
+        }
+        left->count = static_cast<std::uint16_t>(leftCount + 1 + right->count);
+
+        relocate(parent->values() + at + 1, parent->values() + parent->count,
+                 parent->values() + at);
+        for (int j = at + 1; j < parent->count; ++j)
+            setChild(parent, j, parent->child(j + 1));
+        --parent->count;
+
+        if (right == rightmost)
+            rightmost = left;
+        freeNode(right);
+    }
+
+    // k values from the left sibling through the parent to node
+    void moveFromLeft(NodePtr node, NodePtr left, int k) {
+        NodePtr parent = node->parent;
+        const int sep = node->position - 1;
+        const int leftCount = left->count;
+
+        relocate(node->values(), node->values() + node->count,
+                 node->values() + k);
+        relocate(parent->values() + sep, parent->values() + sep + 1,
+                 node->values() + k - 1);
+        relocate(left->values() + leftCount - k + 1,
+                 left->values() + leftCount, node->values());
+        relocate(left->values() + leftCount - k,
+                 left->values() + leftCount - k + 1, parent->values() + sep);
+        if (!node->isLeaf) {
+            for (int j = node->count; j >= 0; --j)
+                setChild(node, j + k, node->child(j));
+            for (int j = 0; j < k; ++j)
+                setChild(node, j, left->child(leftCount - k + 1 + j));
+        }
+
+        left->count = static_cast<std::uint16_t>(leftCount - k);
+        node->count = static_cast<std::uint16_t>(node->count + k);
+    }
+
+    // k values from the right sibling through the parent to node
+    void moveFromRight(NodePtr node, NodePtr right, int k) {
+        NodePtr parent = node->parent;
+        const int sep = node->position;
+        const int count = node->count;
+        const int rightCount = right->count;
+
+        relocate(parent->values() + sep, parent->values() + sep + 1,
+                 node->values() + count);
+        relocate(right->values(), right->values() + k - 1,
+                 node->values() + count + 1);
+        relocate(right->values() + k - 1, right->values() + k,
+                 parent->values() + sep);
+        relocate(right->values() + k, right->values() + rightCount,
+                 right->values());
+        if (!node->isLeaf) {
+            for (int j = 0; j < k; ++j)
+                setChild(node, count + 1 + j, right->child(j));
+            for (int j = k; j <= rightCount; ++j)
+                setChild(right, j - k, right->child(j));
+        }
+
+        node->count = static_cast<std::uint16_t>(count + k);
+        right->count = static_cast<std::uint16_t>(rightCount - k);
+    }
+
+    // refill the nodes under MIN_SLOTS from the erased leaf upwards,
+    // iter is the value after the erased one and follows the moves
+    iterator rebalanceAfterErase(NodePtr node, iterator iter) {
+        while (node != root && node->count < MIN_SLOTS) {
+            NodePtr parent = node->parent;
+            const int at = node->position;
+            NodePtr left = at > 0 ? parent->child(at - 1) : nullptr;
+            NodePtr right =
+                at < parent->count ? parent->child(at + 1) : nullptr;
+
+            if (left != nullptr && left->count + node->count < SLOTS) {
+                if (iter.node == node)
+                    iter = iterator(left, left->count + 1 + iter.pos);
+                mergeNodes(left, node);
+            } else if (right != nullptr &&
+                       node->count + right->count < SLOTS) {
+                if (iter.node == right)
+                    iter = iterator(node, node->count + 1 + iter.pos);
+                mergeNodes(node, right);
+            } else if (left != nullptr &&
+                       (right == nullptr || left->count >= right->count)) {
+                const int k = (left->count - node->count + 1) / 2;
+                if (iter.node == node)
+                    iter.pos += k;
+                moveFromLeft(node, left, k);
+                break;
+            } else {
+                const int k = (right->count - node->count + 1) / 2;
+                moveFromRight(node, right, k);
+                break;
+            }
+
+            node = parent;
+        }
+
+        if (root->count == 0) {
+            NodePtr old = root;
+            if (root->isLeaf) {
+                root = leftmost = rightmost = nullptr;
+                iter = iterator(nullptr, 0);
+            } else {
+                root = root->child(0);
+                root->parent = nullptr;
+                root->position = 0;
+            }
+            freeNode(old);
+        }
+
+        return normalize(iter);
+    }
+
+    void clearAux(NodePtr node) {
+        if (!node->isLeaf) {
+            for (int j = 0; j <= node->count; ++j)
+                clearAux(node->child(j));
+        }
+
+        for (int j = 0; j < node->count; ++j)
+            destroyValue(node->values() + j);
+        freeNode(node);
+    }
+
+    NodePtr copyNodes(NodePtr src, NodePtr parent) {
+        NodePtr node = allocNode(src->isLeaf);
+        node->parent = parent;
+        node->position = src->position;
+
+        int built = 0;
+        try {
+            for (; node->count < src->count; ++node->count)
+                constructValue(node->values() + node->count,
+                               src->value(node->count));
+            if (!src->isLeaf) {
+                for (; built <= src->count; ++built)
+                    node->child(built) = copyNodes(src->child(built), node);
+            }
+        } catch (...) {
+            for (int j = 0; j < built; ++j)
+                clearAux(node->child(j));
+            for (int j = 0; j < node->count; ++j)
+                destroyValue(node->values() + j);
+            freeNode(node);
+            throw;
+        }
+
+        return node;
+    }
+
+    void copyAux(const BTree& rhs) {
+        if (rhs.root == nullptr)
+            return;
+
+        root = copyNodes(rhs.root, nullptr);
+        leftmost = rightmost = root;
+        while (!leftmost->isLeaf)
+            leftmost = leftmost->child(0);
+        while (!rightmost->isLeaf)
+            rightmost = rightmost->child(rightmost->count);
+        mCount = rhs.mCount;
+    }
+
+    void moveAux(BTree&& rhs) {
+        tiny_stl::swapADL(this->compare, rhs.compare);
+        tiny_stl::swapADL(root, rhs.root);
+        tiny_stl::swapADL(leftmost, rhs.leftmost);
+        tiny_stl::swapADL(rightmost, rhs.rightmost);
+        tiny_stl::swapADL(mCount, rhs.mCount);
+    }
+
+public:
+    BTree()
+        : root(nullptr), leftmost(nullptr), rightmost(nullptr), mCount(0),
+          alloc(), compare() {
+    }
+
+    BTree(const Compare& cmp) : BTree(cmp, Alloc()) {
+    }
+
+    template <typename Any_alloc>
+    BTree(const Compare& cmp, Any_alloc&& anyAlloc)
+        : root(nullptr), leftmost(nullptr), rightmost(nullptr), mCount(0),
+          alloc(tiny_stl::forward<Any_alloc>(anyAlloc)), compare(cmp) {
+    }
+
+    template <typename Any_alloc>
+    BTree(const BTree& rhs, Any_alloc&& anyAlloc)
+        : BTree(rhs.compare, tiny_stl::forward<Any_alloc>(anyAlloc)) {
+        copyAux(rhs);
+    }
+
+    BTree(BTree&& rhs) noexcept : BTree(rhs.compare, rhs.alloc) {
+        moveAux(tiny_stl::move(rhs));
+    }
+
+    BTree(BTree&& rhs, const Alloc& alloc) : BTree(rhs.compare, alloc) {
+        moveAux(tiny_stl::move(rhs));
+    }
+
+    BTree& operator=(const BTree& rhs) {
+        // Non-standard, user allocator may be wrong
+        if (this != &rhs) {
+            clear();
+            copyAux(rhs);
+        }
+
+        return *this;
+    }
+
+    BTree& operator=(BTree&& rhs) {
+        // Non-standard, user allocator may be wrong
+        clear();
+        moveAux(tiny_stl::move(rhs));
+
+        return *this;
+    }
+
+    ~BTree() {
+        clear();
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return alloc;
+    }
+
+    size_type size() const noexcept {
+        return mCount;
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    size_type max_size() const noexcept {
+        return static_cast<size_type>(-1) / sizeof(T);
+    }
+
+    iterator lower_bound(const key_type& key) {
+        return lowBoundAux(key);
+    }
+
+    const_iterator lower_bound(const key_type& key) const {
+        return lowBoundAux(key);
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    iterator lower_bound(const K& key) {
+        return lowBoundAux(key);
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    const_iterator lower_bound(const K& key) const {
+        return lowBoundAux(key);
+    }
+
+    iterator upper_bound(const key_type& key) {
+        return uppBoundAux(key);
+    }
+
+    const_iterator upper_bound(const key_type& key) const {
+        return uppBoundAux(key);
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    iterator upper_bound(const K& key) {
+        return uppBoundAux(key);
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    const_iterator upper_bound(const K& key) const {
+        return uppBoundAux(key);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key) {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type& key) const {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    pair<iterator, iterator> equal_range(const K& key) {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    size_type count(const key_type& key) const {
+        pair<const_iterator, const_iterator> range = equal_range(key);
+        return tiny_stl::distance(range.first, range.second);
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    size_type count(const K& key) const {
+        pair<const_iterator, const_iterator> range = equal_range(key);
+        return tiny_stl::distance(range.first, range.second);
+    }
+
+    iterator find(const key_type& key) {
+        return findAux(key);
+    }
+
+    const_iterator find(const key_type& key) const {
+        return findAux(key);
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    iterator find(const K& key) {
+        return findAux(key);
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    const_iterator find(const K& key) const {
+        return findAux(key);
+    }
+
+    bool contains(const key_type& key) const {
+        return find(key) != end();
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
+
+protected:
+    iterator insert_equal(const value_type& val) {
+        return insertEqualAux(val);
+    }
+
+    iterator insert_equal(value_type&& val) {
+        return insertEqualAux(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert_equal(InIter first, InIter last) {
+        for (; first != last; ++first)
+            insertEqualAux(*first);
+    }
+
+    pair<iterator, bool> insert_unique(const value_type& val) {
+        return insertUniqueAux(val);
+    }
+
+    pair<iterator, bool> insert_unique(value_type&& val) {
+        return insertUniqueAux(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert_unique(InIter first, InIter last) {
+        for (; first != last; ++first)
+            insertUniqueAux(*first);
+    }
+
+    template <typename... Args>
+    iterator emplace_equal(Args&&... args) {
+        return insertEqualAux(tiny_stl::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> emplace_unique(Args&&... args) {
+        return insertUniqueAux(tiny_stl::forward<Args>(args)...);
+    }
+
+public:
+    // an internal value is replaced by its predecessor, which is always
+    // in a leaf, then the leaf is erased from and rebalanced
+    iterator erase(const_iterator pos) {
+        NodePtr node = pos.node;
+        int i = pos.pos;
+        const bool internal = !node->isLeaf;
+        if (internal) {
+            const_iterator pred = pos;
+            --pred;
+            node->value(i) = tiny_stl::move(*iterator(pred.node, pred.pos));
+            node = pred.node;
+            i = pred.pos;
+        }
+
+        destroyValue(node->values() + i);
+        relocate(node->values() + i + 1, node->values() + node->count,
+                 node->values() + i);
+        --node->count;
+        --mCount;
+
+        iterator next = rebalanceAfterErase(node, iterator(node, i));
+        if (internal) // next is the predecessor moved up
+            ++next;
+
+        return next;
+    }
+
+    // erase moves the values, so last is found again by counting
+    iterator erase(const_iterator first, const_iterator last) {
+        if (first == begin() && last == end()) {
+            clear();
+            return end();
+        }
+
+        size_type num = tiny_stl::distance(first, last);
+        iterator iter(first.node, first.pos);
+        for (; num > 0; --num)
+            iter = erase(iter);
+
+        return iter;
+    }
+
+    size_type erase(const key_type& key) {
+        auto ppos = equal_range(key);
+        size_type num = tiny_stl::distance(ppos.first, ppos.second);
+
+        erase(ppos.first, ppos.second);
+
+        return num;
+    }
+
+    // iterators are not keys
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent,
+              typename = enable_if_t<!is_convertible<K, iterator>::value &&
+                                     !is_convertible<K, const_iterator>::value>>
+    size_type erase(K&& key) {
+        auto ppos = equal_range(key);
+        size_type num = tiny_stl::distance(ppos.first, ppos.second);
+
+        erase(ppos.first, ppos.second);
+
+        return num;
+    }
+
+public:
+    iterator begin() noexcept {
+        return iterator(leftmost, 0);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(leftmost, 0);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return makeEnd();
+    }
+
+    const_iterator end() const noexcept {
+        return makeEnd();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+    void clear() {
+        if (root != nullptr)
+            clearAux(root);
+        root = leftmost = rightmost = nullptr;
+        mCount = 0;
+    }
+
+    void swap(BTree& rhs) noexcept(AlTraits::is_always_equal::value&&
+                                       is_nothrow_swappable<Compare>::value) {
+        assert(this->alloc == rhs.alloc);
+
+        if (allocator_traits<Alloc>::propagate_on_container_swap::value)
+            tiny_stl::swapAlloc(this->alloc, rhs.alloc);
+
+        tiny_stl::swapADL(root, rhs.root);
+        tiny_stl::swapADL(leftmost, rhs.leftmost);
+        tiny_stl::swapADL(rightmost, rhs.rightmost);
+        tiny_stl::swapADL(compare, rhs.compare);
+        tiny_stl::swapADL(mCount, rhs.mCount);
+    }
+}; // BTree
+
+template <typename T, typename Compare, typename Alloc, bool isMap>
+bool operator==(const BTree<T, Compare, Alloc, isMap>& lhs,
+                const BTree<T, Compare, Alloc, isMap>& rhs) {
+    return lhs.size() == rhs.size() &&
+           tiny_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, typename Compare, typename Alloc, bool isMap>
+bool operator!=(const BTree<T, Compare, Alloc, isMap>& lhs,
+                const BTree<T, Compare, Alloc, isMap>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename T, typename Compare, typename Alloc, bool isMap>
+bool operator<(const BTree<T, Compare, Alloc, isMap>& lhs,
+               const BTree<T, Compare, Alloc, isMap>& rhs) {
+    return tiny_stl::lexicographical_compare(lhs.begin(), lhs.end(),
+                                             rhs.begin(), rhs.end());
+}
+
+template <typename T, typename Compare, typename Alloc, bool isMap>
+bool operator>(const BTree<T, Compare, Alloc, isMap>& lhs,
+               const BTree<T, Compare, Alloc, isMap>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename T, typename Compare, typename Alloc, bool isMap>
+bool operator<=(const BTree<T, Compare, Alloc, isMap>& lhs,
+                const BTree<T, Compare, Alloc, isMap>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename T, typename Compare, typename Alloc, bool isMap>
+bool operator>=(const BTree<T, Compare, Alloc, isMap>& lhs,
+                const BTree<T, Compare, Alloc, isMap>& rhs) {
+    return !(lhs < rhs);
+}
+
+} // namespace tiny_stl
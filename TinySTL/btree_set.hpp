@@ -0,0 +1,281 @@
+﻿// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "btree.hpp"
+
+namespace tiny_stl {
+
+// btree_set
+template <typename Key, typename Compare = tiny_stl::less<Key>,
+          typename Alloc = tiny_stl::allocator<Key>>
+class btree_set : public BTree<Key, Compare, Alloc, false> {
+public:
+    using allocator_type = Alloc;
+private:
+    using Base = BTree<Key, Compare, allocator_type, false>;
+    using AlTraits = allocator_traits<allocator_type>;
+    using AlNode = typename Base::AlNode;
+    using AlNodeTraits = typename Base::AlNodeTraits;
+
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = typename Alloc::size_type;
+    using difference_type = typename Alloc::difference_type;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename AlTraits::pointer;
+    using const_pointer = typename AlTraits::const_pointer;
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+    using reverse_iterator = typename Base::reverse_iterator;
+    using const_reverse_iterator = typename Base::const_reverse_iterator;
+
+public:
+    btree_set() : btree_set(Compare()) {
+    }
+    explicit btree_set(const Compare& cmp, const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+    }
+
+    explicit btree_set(const Alloc& alloc) : Base(key_compare(), alloc) {
+    }
+
+    template <typename InIter>
+    btree_set(InIter first, InIter last, const key_compare& cmp,
+        const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_unique(first, last);
+    }
+
+    template <typename InIter>
+    btree_set(InIter first, InIter last, const Alloc& alloc)
+        : Base(key_compare(), alloc) {
+        this->insert_unique(first, last);
+    }
+
+    btree_set(const btree_set& rhs)
+        : Base(rhs, AlTraits::select_on_container_copy_construction(
+                        rhs.get_allocator())) {
+    }
+
+    btree_set(const btree_set& rhs, const Alloc& alloc) : Base(rhs, alloc) {
+    }
+
+    btree_set(btree_set&& rhs) : Base(tiny_stl::move(rhs)) {
+    }
+
+    btree_set(btree_set&& rhs, const Alloc& alloc)
+        : Base(tiny_stl::move(rhs), alloc) {
+    }
+
+    btree_set(std::initializer_list<value_type> ilist,
+              const Compare& cmp = Compare(), const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_unique(ilist.begin(), ilist.end());
+    }
+
+    btree_set(std::initializer_list<value_type> ilist, const Alloc& alloc)
+        : btree_set(ilist, Compare(), alloc) {
+    }
+
+    btree_set& operator=(const btree_set& rhs) {
+        Base::operator=(rhs);
+        return *this;
+    }
+
+    btree_set& operator=(btree_set&& rhs) {
+        Base::operator=(tiny_stl::move(rhs));
+        return *this;
+    }
+
+    btree_set& operator=(std::initializer_list<value_type> ilist) {
+        btree_set tmp(ilist);
+        this->swap(tmp);
+        return *this;
+    }
+
+    pair<iterator, bool> insert(const value_type& val) {
+        return this->insert_unique(val);
+    }
+
+    pair<iterator, bool> insert(value_type&& val) {
+        return this->insert_unique(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert(InIter first, InIter last) {
+        this->insert_unique(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        this->insert_unique(ilist.begin(), ilist.end());
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+        return this->emplace_unique(tiny_stl::forward<Args>(args)...);
+    }
+
+    void swap(btree_set& rhs) {
+        Base::swap(rhs);
+    }
+
+    key_compare key_comp() const {
+        return key_compare{};
+    }
+
+    value_compare value_comp() const {
+        return value_compare{};
+    }
+}; // btree_set
+
+template <typename Key, typename Compare, typename Alloc>
+inline void
+swap(btree_set<Key, Compare, Alloc>& lhs,
+     btree_set<Key, Compare, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+// btree_multiset
+template <typename Key, typename Compare = tiny_stl::less<Key>,
+          typename Alloc = tiny_stl::allocator<Key>>
+class btree_multiset : public BTree<Key, Compare, Alloc, false> {
+public:
+    using allocator_type = Alloc;
+private:
+    using Base = BTree<Key, Compare, allocator_type, false>;
+    using AlTraits = allocator_traits<allocator_type>;
+    using AlNode = typename Base::AlNode;
+    using AlNodeTraits = typename Base::AlNodeTraits;
+
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename AlTraits::pointer;
+    using const_pointer = typename AlTraits::const_pointer;
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+    using reverse_iterator = typename Base::reverse_iterator;
+    using const_reverse_iterator = typename Base::const_reverse_iterator;
+
+public:
+    btree_multiset() : btree_multiset(Compare()) {
+    }
+    explicit btree_multiset(const Compare& cmp, const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+    }
+
+    explicit btree_multiset(const Alloc& alloc) : Base(key_compare(), alloc) {
+    }
+
+    template <typename InIter>
+    btree_multiset(InIter first, InIter last, const key_compare& cmp,
+             const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_equal(first, last);
+    }
+
+    template <typename InIter>
+    btree_multiset(InIter first, InIter last, const Alloc& alloc)
+        : Base(key_compare(), alloc) {
+        this->insert_equal(first, last);
+    }
+
+    btree_multiset(const btree_multiset& rhs)
+        : Base(rhs, AlTraits::select_on_container_copy_construction(
+                        rhs.get_allocator())) {
+    }
+
+    btree_multiset(const btree_multiset& rhs, const Alloc& alloc)
+        : Base(rhs, alloc) {
+    }
+
+    btree_multiset(btree_multiset&& rhs) : Base(tiny_stl::move(rhs)) {
+    }
+
+    btree_multiset(btree_multiset&& rhs, const Alloc& alloc)
+        : Base(tiny_stl::move(rhs), alloc) {
+    }
+
+    btree_multiset(std::initializer_list<value_type> ilist,
+             const Compare& cmp = Compare(), const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_equal(ilist.begin(), ilist.end());
+    }
+
+    btree_multiset(std::initializer_list<value_type> ilist, const Alloc& alloc)
+        : btree_multiset(ilist, Compare(), alloc) {
+    }
+
+    btree_multiset& operator=(const btree_multiset& rhs) {
+        Base::operator=(rhs);
+        return *this;
+    }
+
+    btree_multiset& operator=(btree_multiset&& rhs) {
+        Base::operator=(tiny_stl::move(rhs));
+        return *this;
+    }
+
+    btree_multiset& operator=(std::initializer_list<value_type> ilist) {
+        btree_multiset tmp(ilist);
+        this->swap(tmp);
+        return *this;
+    }
+
+    iterator insert(const value_type& val) {
+        return this->insert_equal(val);
+    }
+
+    iterator insert(value_type&& val) {
+        return this->insert_equal(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert(InIter first, InIter last) {
+        this->insert_equal(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        this->insert_equal(ilist.begin(), ilist.end());
+    }
+
+    template <typename... Args>
+    iterator emplace(Args&&... args) {
+        return this->emplace_equal(tiny_stl::forward<Args>(args)...);
+    }
+
+    void swap(btree_multiset& rhs) {
+        Base::swap(rhs);
+    }
+
+    key_compare key_comp() const {
+        return key_compare{};
+    }
+
+    value_compare value_comp() const {
+        return value_compare{};
+    }
+}; // btree_multiset
+
+template <typename Key, typename Compare, typename Alloc>
+inline void
+swap(btree_multiset<Key, Compare, Alloc>& lhs,
+     btree_multiset<Key, Compare, Alloc>& rhs) noexcept(
+    noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+} // namespace tiny_stl
\ No newline at end of file
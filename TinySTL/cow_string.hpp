@@ -4,10 +4,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <initializer_list>
 #include <string>
 
 #include "memory.hpp"
+#include "string_search.hpp"
 
 namespace tiny_stl {
 
@@ -184,39 +186,92 @@ struct CowStringIterator : CowStringConstIterator<T> {
 
 namespace extra {
 
+// RefCountPolicy of RCObject
+// counter_type:   the type of the reference count
+// load(c):        the current count
+// increase(c):    add a reference
+// decrease(c):    drop a reference, return true if it was the last one
+
+// single thread only
+struct plain_refcount_policy {
+    using counter_type = std::size_t;
+
+    static std::size_t load(const counter_type& c) noexcept {
+        return c;
+    }
+
+    static void increase(counter_type& c) noexcept {
+        ++c;
+    }
+
+    static bool decrease(counter_type& c) noexcept {
+        return --c == 0;
+    }
+};
+
+// the count of an object shared across threads. A count of 1 means the
+// caller is the only owner and no other thread can reach the object, so
+// the last release is a load instead of a locked decrement
+struct atomic_refcount_policy {
+    using counter_type = std::atomic<std::size_t>;
+
+    static std::size_t load(const counter_type& c) noexcept {
+        // acquire: the writes of the releasing owners happen before
+        // the caller modifies or deletes the unshared object
+        return c.load(std::memory_order_acquire);
+    }
+
+    static void increase(counter_type& c) noexcept {
+        // a new owner is always copied from an existing one
+        c.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static bool decrease(counter_type& c) noexcept {
+        if (load(c) == 1)
+            return true;
+
+        return c.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+};
+
 // ref <<More Effective c++>>
 
 // Reference count base class
 // Provide interface
 // Improved the original
+template <typename RefCountPolicy = atomic_refcount_policy>
 class RCObject {
 private:
-    std::size_t mRefCount;
+    typename RefCountPolicy::counter_type mRefCount;
 
 protected: // Derived class call
     RCObject() : mRefCount(0) {
     }
-    RCObject(const RCObject& rhs) = default;
-    RCObject& operator=(const RCObject& rhs) = default;
+    // a copy is a new object without references
+    RCObject(const RCObject&) : mRefCount(0) {
+    }
+    RCObject& operator=(const RCObject&) {
+        return *this;
+    }
     virtual ~RCObject() {
     }
 
 public:
     void retain() noexcept {
-        ++mRefCount;
+        RefCountPolicy::increase(mRefCount);
     }
 
     void release() noexcept {
-        if (--mRefCount == 0)
+        if (RefCountPolicy::decrease(mRefCount))
             delete this;
     }
 
     bool isShared() const noexcept {
-        return mRefCount > 1;
+        return RefCountPolicy::load(mRefCount) > 1;
     }
 
     std::size_t getRefCount() const noexcept {
-        return mRefCount;
+        return RefCountPolicy::load(mRefCount);
     }
 };
 
@@ -280,6 +335,10 @@ public:
         return *pointee;
     }
 
+    RCObj* get() const noexcept {
+        return pointee;
+    }
+
 }; // class RCPtr<T>
 
 } // namespace extra
@@ -314,7 +373,7 @@ public:
 private:
     // nested struct
     // manage resources
-    struct StringValue : public extra::RCObject {
+    struct StringValue : public extra::RCObject<> {
         size_type size;
         size_type capa;
         CharT* data;
@@ -1253,61 +1312,30 @@ private:
     // pos:   this->position at which to start the search
     // count: s->length of substring to search for
     size_type findHelper(const CharT* s, size_type pos, size_type count) const {
-        // Here is a naive find algorithm
-
-        size_type thisSize = size();
-
-        if (count > thisSize || pos > thisSize - count)
+        const size_type thisSize = size();
+        if (pos > thisSize)
             return npos;
 
-        if (count == 0) {
-            return tiny_stl::min(pos, size() - 1);
-        }
-
-        for (size_type i = pos; i <= thisSize - count; ++i) {
-            // if matched first character
-            if (traits_type::eq(value->data[i], s[0])) {
-                size_type j;
-                for (j = 1; j < count; ++j) {
-                    if (!traits_type::eq(value->data[i + j], s[j])) // mismatch
-                        break;
-                }
-                if (j == count)
-                    return i;
-            }
-        }
-
-        return npos;
+        const CharT* findAt = details::stringSearch<Traits>(
+            value->data + pos, thisSize - pos, s, count);
+        return findAt == nullptr
+                   ? npos
+                   : static_cast<size_type>(findAt - value->data);
     }
 
+    // the last match starting in [0, pos]
     size_type rfindHelper(const CharT* str, size_type pos,
                           size_type count) const {
-        // native find algorithm
-        size_type lhsSize = size();
-        if (count > lhsSize || pos < count)
+        const size_type thisSize = size();
+        if (count > thisSize)
             return npos;
-        if (lhsSize == 0)
-            return npos;
-        if (count == 0)
-            return pos;
-
-        pos = tiny_stl::min(pos, lhsSize - 1);
-        // pos >= count
-        for (difference_type i = static_cast<difference_type>(pos); i >= 0;
-             --i) {
-            // mismatched the first character
-            if (!Traits::eq(value->data[i], str[0]))
-                continue;
-
-            size_type j = 1;
-            for (; j < count; ++j) {
-                if (!Traits::eq(value->data[i + j], str[j]))
-                    break;
-            }
-            if (j == count)
-                return i;
-        }
-        return npos;
+
+        pos = tiny_stl::min(pos, thisSize - count);
+        const CharT* findAt = details::stringSearchLast<Traits>(
+            value->data, pos + count, str, count);
+        return findAt == nullptr
+                   ? npos
+                   : static_cast<size_type>(findAt - value->data);
     }
 
 public:
@@ -1331,11 +1359,7 @@ public:
     }
 
     size_type find(CharT ch, size_type pos = 0) const {
-        const CharT* find_at =
-            traits_type::find(value->data + pos, size() - pos, ch);
-        return find_at == nullptr
-                   ? npos
-                   : static_cast<size_type>(find_at - value->data);
+        return findHelper(&ch, pos, 1);
     }
 
     size_type rfind(const cow_basic_string& str,
@@ -1352,15 +1376,110 @@ public:
     }
 
     size_type rfind(CharT ch, size_type pos = npos) const {
-        pos = tiny_stl::min(pos, size() - 1);
-        CharT str[2];
-        str[0] = ch;
-        str[1] = traits_type::to_char_type(0);
-        return rfindHelper(str, pos, 1);
+        return rfindHelper(&ch, pos, 1);
+    }
+
+private:
+    size_type findFirstOfHelper(const CharT* str, size_type pos,
+                                size_type count, bool inSet) const {
+        const size_type thisSize = size();
+        if (pos >= thisSize)
+            return npos;
+
+        const CharT* findAt = details::findFirstOf<Traits>(
+            value->data + pos, thisSize - pos, str, count, inSet);
+        return findAt == nullptr
+                   ? npos
+                   : static_cast<size_type>(findAt - value->data);
+    }
+
+    // [0, pos]
+    size_type findLastOfHelper(const CharT* str, size_type pos,
+                               size_type count, bool inSet) const {
+        const size_type thisSize = size();
+        if (thisSize == 0)
+            return npos;
+
+        pos = tiny_stl::min(pos, thisSize - 1);
+        const CharT* findAt = details::findLastOf<Traits>(
+            value->data, pos + 1, str, count, inSet);
+        return findAt == nullptr
+                   ? npos
+                   : static_cast<size_type>(findAt - value->data);
+    }
+
+public:
+    size_type find_first_of(const cow_basic_string& str,
+                            size_type pos = 0) const noexcept {
+        return findFirstOfHelper(str.data(), pos, str.size(), true);
+    }
+
+    size_type find_first_of(const CharT* str, size_type pos,
+                            size_type count) const {
+        return findFirstOfHelper(str, pos, count, true);
+    }
+
+    size_type find_first_of(const CharT* str, size_type pos = 0) const {
+        return findFirstOfHelper(str, pos, Traits::length(str), true);
+    }
+
+    size_type find_first_of(CharT ch, size_type pos = 0) const {
+        return findFirstOfHelper(&ch, pos, 1, true);
+    }
+
+    size_type find_first_not_of(const cow_basic_string& str,
+                                size_type pos = 0) const noexcept {
+        return findFirstOfHelper(str.data(), pos, str.size(), false);
+    }
+
+    size_type find_first_not_of(const CharT* str, size_type pos,
+                                size_type count) const {
+        return findFirstOfHelper(str, pos, count, false);
+    }
+
+    size_type find_first_not_of(const CharT* str, size_type pos = 0) const {
+        return findFirstOfHelper(str, pos, Traits::length(str), false);
+    }
+
+    size_type find_first_not_of(CharT ch, size_type pos = 0) const {
+        return findFirstOfHelper(&ch, pos, 1, false);
     }
 
-    // find_first_of, find_first_not_of, find_last_of, find_last_not_of
-    // no implement
+    size_type find_last_of(const cow_basic_string& str,
+                           size_type pos = npos) const noexcept {
+        return findLastOfHelper(str.data(), pos, str.size(), true);
+    }
+
+    size_type find_last_of(const CharT* str, size_type pos,
+                           size_type count) const {
+        return findLastOfHelper(str, pos, count, true);
+    }
+
+    size_type find_last_of(const CharT* str, size_type pos = npos) const {
+        return findLastOfHelper(str, pos, Traits::length(str), true);
+    }
+
+    size_type find_last_of(CharT ch, size_type pos = npos) const {
+        return findLastOfHelper(&ch, pos, 1, true);
+    }
+
+    size_type find_last_not_of(const cow_basic_string& str,
+                               size_type pos = npos) const noexcept {
+        return findLastOfHelper(str.data(), pos, str.size(), false);
+    }
+
+    size_type find_last_not_of(const CharT* str, size_type pos,
+                               size_type count) const {
+        return findLastOfHelper(str, pos, count, false);
+    }
+
+    size_type find_last_not_of(const CharT* str, size_type pos = npos) const {
+        return findLastOfHelper(str, pos, Traits::length(str), false);
+    }
+
+    size_type find_last_not_of(CharT ch, size_type pos = npos) const {
+        return findLastOfHelper(&ch, pos, 1, false);
+    }
 
     // Provide non-standard interface to improve efficiency of reading
     const_reference c_front() const {
@@ -1398,6 +1517,11 @@ private:
 
 }; // class basic_string<CharT, Traits, Alloc>
 
+// only a pointer to the shared representation
+template <typename CharT, typename Traits, typename Alloc>
+struct is_trivially_relocatable<cow_basic_string<CharT, Traits, Alloc>>
+    : true_type {};
+
 template <typename CharT, typename Traits, typename Alloc>
 cow_basic_string<CharT, Traits, Alloc>
 operator+(const cow_basic_string<CharT, Traits, Alloc>& lhs,
@@ -1657,15 +1781,15 @@ operator>>(std::basic_istream<CharT, Traits>& is,
     return is;
 }
 
-template <typename CharT, typename Traits, typename Alloc>
-struct hash<cow_basic_string<CharT, Traits, Alloc>> {
+template <typename CharT, typename Traits, typename Alloc, typename Policy>
+struct hash<cow_basic_string<CharT, Traits, Alloc>, Policy> {
     using argument_type = cow_basic_string<CharT, Traits, Alloc>;
     using result_type = std::size_t;
 
     std::size_t
     operator()(const cow_basic_string<CharT, Traits, Alloc>& str) const
         noexcept {
-        return tiny_stl::hashFNV(str.c_str(), str.size());
+        return Policy::hash_bytes(str.c_str(), str.size() * sizeof(CharT));
     }
 };
 
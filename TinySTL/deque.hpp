@@ -6,7 +6,7 @@
 
 #include <initializer_list>
 
-#include "memory.h"
+#include "memory.hpp"
 
 namespace tiny_stl {
 
@@ -771,6 +771,11 @@ public:
     }
 
 private:
+    // the map only holds block pointers, the blocks never move
+    static void moveNodes(MapPtr xfirst, MapPtr xlast, MapPtr dst) noexcept {
+        std::memmove(dst, xfirst, (xlast - xfirst) * sizeof(*xfirst));
+    }
+
     // change the map_ptr at the front
     void reallocateMap(size_type num_add, true_type) {
         size_type old_num_nodes = finish.node - start.node + 1;
@@ -780,18 +785,7 @@ private:
 
         if (map_size > 2 * new_num_nodes) { // no reallocate
             new_nstart = map_ptr + (map_size - new_num_nodes) / 2 + num_add;
-
-            // Avoid coverage
-            try {
-                if (new_nstart < start.node)
-                    copy(start.node, finish.node + 1, new_nstart);
-                else
-                    copy_backward(start.node, finish.node + 1,
-                                  new_nstart + old_num_nodes);
-            } catch (...) {
-                tidy();
-                throw;
-            }
+            moveNodes(start.node, finish.node + 1, new_nstart);
         } else { // reallocate
             size_type new_map_size =
                 map_size + tiny_stl::max(map_size, num_add) + 2;
@@ -799,17 +793,15 @@ private:
             MapPtr new_map = nullptr;
             try {
                 new_map = this->alloc_map.allocate(new_map_size);
-                new_nstart =
-                    new_map + (new_map_size - new_num_nodes) / 2 + num_add;
-
-                copy(start.node, finish.node + 1,
-                     new_nstart); // copy origin node to new map
             } catch (...) {
-
                 tidy();
                 throw;
             }
 
+            new_nstart =
+                new_map + (new_map_size - new_num_nodes) / 2 + num_add;
+            moveNodes(start.node, finish.node + 1, new_nstart);
+
             this->alloc_map.deallocate(map_ptr, map_size);
 
             map_ptr = new_map;
@@ -829,17 +821,9 @@ private:
         size_type new_map_size =
             map_size + tiny_stl::max(map_size, num_add) + 2;
 
-        MapPtr new_map = nullptr, new_nstart = nullptr;
-        try {
-            new_map = this->alloc_map.allocate(new_map_size); // reallocate
-            new_nstart = new_map + (new_map_size - new_num_nodes) / 2;
-
-            copy(start.node, finish.node + 1,
-                 new_nstart); // copy origin node to new map
-        } catch (...) {
-            this->alloc_map.deallocate(new_map, new_map_size);
-            throw;
-        }
+        MapPtr new_map = this->alloc_map.allocate(new_map_size);
+        MapPtr new_nstart = new_map + (new_map_size - new_num_nodes) / 2;
+        moveNodes(start.node, finish.node + 1, new_nstart);
 
         this->alloc_map.deallocate(map_ptr, map_size);
 
@@ -1156,6 +1140,11 @@ public:
 
 }; // class deque<T, Alloc>
 
+// the map and the iterators only point to heap blocks
+template <typename T, typename Alloc>
+struct is_trivially_relocatable<deque<T, Alloc>>
+    : is_trivially_relocatable<Alloc> {};
+
 template <typename T, typename Alloc>
 inline bool operator==(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
     return lhs.size() == rhs.size() &&
@@ -0,0 +1,613 @@
+﻿// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "algorithm.hpp"
+#include "deque.hpp"
+#include "memory.hpp"
+#include "vector.hpp"
+
+namespace tiny_stl {
+
+namespace execution {
+
+class sequenced_policy {};
+class parallel_policy {};
+
+constexpr sequenced_policy seq{};
+constexpr parallel_policy par{};
+
+} // namespace execution
+
+template <typename T>
+struct is_execution_policy : false_type {};
+
+template <>
+struct is_execution_policy<execution::sequenced_policy> : true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_policy> : true_type {};
+
+template <typename T>
+constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+
+namespace details {
+
+// every worker owns a task deque, it pops its own tasks from the back and
+// steals from the front of the others. threads outside the pool submit to
+// one more shared deque
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct TaskQueue {
+        std::mutex mtx;
+        deque<Task> tasks;
+    };
+
+    vector<unique_ptr<TaskQueue>> queues;
+    vector<std::thread> workers;
+    std::atomic<std::size_t> pending{0};
+    std::mutex sleepMtx;
+    std::condition_variable sleepCv;
+    bool stop = false;
+
+    static std::size_t& workerIndex() noexcept {
+        static thread_local std::size_t index = static_cast<std::size_t>(-1);
+        return index;
+    }
+
+    std::size_t ownQueue() const noexcept {
+        const std::size_t index = workerIndex();
+        return index < workers.size() ? index : workers.size();
+    }
+
+    bool popTask(std::size_t self, Task& task) {
+        if (self < queues.size()) {
+            TaskQueue& q = *queues[self];
+            std::lock_guard<std::mutex> lock(q.mtx);
+            if (!q.tasks.empty()) {
+                task = tiny_stl::move(q.tasks.back());
+                q.tasks.pop_back();
+                --pending;
+                return true;
+            }
+        }
+
+        for (std::size_t i = 1; i <= queues.size(); ++i) {
+            TaskQueue& q = *queues[(self + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.mtx);
+            if (!q.tasks.empty()) {
+                task = tiny_stl::move(q.tasks.front());
+                q.tasks.pop_front();
+                --pending;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void workerLoop(std::size_t index) {
+        workerIndex() = index;
+        Task task;
+        while (true) {
+            if (popTask(index, task)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMtx);
+            sleepCv.wait(lock, [this] { return stop || pending != 0; });
+            if (stop && pending == 0)
+                return;
+        }
+    }
+
+public:
+    explicit ThreadPool(std::size_t count) {
+        if (count == 0)
+            count = 1;
+
+        for (std::size_t i = 0; i <= count; ++i)
+            queues.emplace_back(new TaskQueue);
+
+        for (std::size_t i = 0; i < count; ++i)
+            workers.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMtx);
+            stop = true;
+        }
+        sleepCv.notify_all();
+
+        for (std::thread& t : workers)
+            t.join();
+    }
+
+    std::size_t size() const noexcept {
+        return workers.size();
+    }
+
+    void submit(Task task) {
+        TaskQueue& q = *queues[ownQueue()];
+        ++pending;
+        {
+            std::lock_guard<std::mutex> lock(q.mtx);
+            q.tasks.push_back(tiny_stl::move(task));
+        }
+
+        // a worker between its last check and wait() must see pending
+        { std::lock_guard<std::mutex> lock(sleepMtx); }
+        sleepCv.notify_one();
+    }
+
+    // run one queued task on the calling thread
+    bool runPendingTask() {
+        Task task;
+        if (!popTask(ownQueue(), task))
+            return false;
+
+        task();
+        return true;
+    }
+}; // class ThreadPool
+
+inline ThreadPool& defaultThreadPool() {
+    static ThreadPool pool(std::thread::hardware_concurrency() > 1
+                               ? std::thread::hardware_concurrency() - 1
+                               : 1);
+    return pool;
+}
+
+// fork-join on the pool, wait() runs the queued tasks instead of
+// blocking, so the tasks may wait on their own groups
+class TaskGroup {
+private:
+    ThreadPool& pool;
+    std::atomic<std::size_t> remaining{0};
+    std::exception_ptr error;
+    std::mutex errorMtx;
+
+public:
+    explicit TaskGroup(ThreadPool& p = defaultThreadPool()) : pool(p) {
+    }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    ~TaskGroup() {
+        assert(remaining == 0);
+    }
+
+    template <typename Func>
+    void run(Func f) {
+        ++remaining;
+        pool.submit([this, f]() mutable {
+            try {
+                f();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMtx);
+                if (!error)
+                    error = std::current_exception();
+            }
+            --remaining;
+        });
+    }
+
+    void wait() {
+        while (remaining != 0)
+            if (!pool.runPendingTask())
+                std::this_thread::yield();
+
+        if (error)
+            std::rethrow_exception(tiny_stl::move(error));
+    }
+}; // class TaskGroup
+
+static const std::size_t PARALLEL_GRAIN_SIZE = 4096;
+
+// the number of chunks to split n elements into
+inline std::size_t parallelChunkCount(std::size_t n) {
+    const std::size_t maxChunks = (defaultThreadPool().size() + 1) * 4;
+    const std::size_t chunks = n / PARALLEL_GRAIN_SIZE;
+    if (chunks <= 1)
+        return 1;
+    return chunks < maxChunks ? chunks : maxChunks;
+}
+
+// fn(first, last, chunk) for each chunk of [0, n), chunk 0 runs on the
+// calling thread
+template <typename Func>
+inline void parallelChunks(std::size_t n, std::size_t chunks, Func& fn) {
+    if (chunks <= 1) {
+        fn(static_cast<std::size_t>(0), n, static_cast<std::size_t>(0));
+        return;
+    }
+
+    TaskGroup group;
+    for (std::size_t c = 1; c < chunks; ++c) {
+        group.run([&fn, n, chunks, c] {
+            fn(n * c / chunks, n * (c + 1) / chunks, c);
+        });
+    }
+
+    try {
+        fn(static_cast<std::size_t>(0), n / chunks,
+           static_cast<std::size_t>(0));
+    } catch (...) {
+        group.wait();
+        throw;
+    }
+    group.wait();
+}
+
+template <typename Policy, typename... Iters>
+struct UseParallel
+    : bool_constant<
+          is_same<decay_t<Policy>, execution::parallel_policy>::value &&
+          conjunction<is_same<typename iterator_traits<Iters>::iterator_category,
+                              random_access_iterator_tag>...>::value> {};
+
+template <typename Policy, typename Ret>
+using EnableIfPolicy =
+    enable_if_t<is_execution_policy<decay_t<Policy>>::value, Ret>;
+
+// sort: partition with the pdqSort pivot, the left part goes to the pool
+// and the loop goes on with the right part
+static const std::ptrdiff_t PARALLEL_SORT_MIN = 1 << 15;
+
+template <typename RanIter, typename Compare>
+inline void parallelSort(RanIter first, RanIter last, Compare cmp,
+                         TaskGroup& group, int depth) {
+    while (last - first > PARALLEL_SORT_MIN && depth-- > 0) {
+        choosePivot(first, last, cmp);
+        const RanIter pivotPos =
+            partitionRight(
+                first, last, cmp,
+                IsBranchlessCompare<IteratorValueType<RanIter>, Compare>{})
+                .first;
+
+        group.run([first, pivotPos, cmp, &group, depth] {
+            parallelSort(first, pivotPos, cmp, group, depth);
+        });
+        first = pivotPos + 1;
+    }
+
+    // small or unbalanced too often, pdqSort has the heap sort fallback
+    tiny_stl::sort(first, last, cmp);
+}
+
+template <typename RanIter, typename Compare>
+inline void policySortAux(RanIter first, RanIter last, Compare& cmp, true_type) {
+    if (last - first <= PARALLEL_SORT_MIN) {
+        tiny_stl::sort(first, last, cmp);
+        return;
+    }
+
+    TaskGroup group;
+    try {
+        parallelSort(first, last, cmp, group, sortDepthLimit(last - first));
+    } catch (...) {
+        group.wait();
+        throw;
+    }
+    group.wait();
+}
+
+template <typename RanIter, typename Compare>
+inline void policySortAux(RanIter first, RanIter last, Compare& cmp, false_type) {
+    tiny_stl::sort(first, last, cmp);
+}
+
+template <typename RanIter, typename Func>
+inline void forEachAux(RanIter first, RanIter last, Func& f, true_type) {
+    auto fn = [first, &f](std::size_t b, std::size_t e, std::size_t) {
+        tiny_stl::for_each(first + b, first + e, f);
+    };
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    parallelChunks(n, parallelChunkCount(n), fn);
+}
+
+template <typename InIter, typename Func>
+inline void forEachAux(InIter first, InIter last, Func& f, false_type) {
+    tiny_stl::for_each(first, last, f);
+}
+
+template <typename RanIter, typename OutIter, typename UnaryOp>
+inline OutIter transformAux(RanIter first, RanIter last, OutIter dst,
+                            UnaryOp& op, true_type) {
+    auto fn = [first, dst, &op](std::size_t b, std::size_t e, std::size_t) {
+        tiny_stl::transform(first + b, first + e, dst + b, op);
+    };
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    parallelChunks(n, parallelChunkCount(n), fn);
+    return dst + n;
+}
+
+template <typename InIter, typename OutIter, typename UnaryOp>
+inline OutIter transformAux(InIter first, InIter last, OutIter dst,
+                            UnaryOp& op, false_type) {
+    return tiny_stl::transform(first, last, dst, op);
+}
+
+template <typename RanIter1, typename RanIter2, typename OutIter,
+          typename BinOp>
+inline OutIter transformAux(RanIter1 first1, RanIter1 last1, RanIter2 first2,
+                            OutIter dst, BinOp& op, true_type) {
+    auto fn = [first1, first2, dst, &op](std::size_t b, std::size_t e,
+                                         std::size_t) {
+        tiny_stl::transform(first1 + b, first1 + e, first2 + b, dst + b, op);
+    };
+    const std::size_t n = static_cast<std::size_t>(last1 - first1);
+    parallelChunks(n, parallelChunkCount(n), fn);
+    return dst + n;
+}
+
+template <typename InIter1, typename InIter2, typename OutIter,
+          typename BinOp>
+inline OutIter transformAux(InIter1 first1, InIter1 last1, InIter2 first2,
+                            OutIter dst, BinOp& op, false_type) {
+    return tiny_stl::transform(first1, last1, first2, dst, op);
+}
+
+template <typename RanIter, typename UnaryPred>
+inline IterDiffType<RanIter> countIfAux(RanIter first, RanIter last,
+                                        UnaryPred& pred, true_type) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    const std::size_t chunks = parallelChunkCount(n);
+    vector<IterDiffType<RanIter>> counts(chunks);
+    auto fn = [first, &pred, &counts](std::size_t b, std::size_t e,
+                                      std::size_t c) {
+        counts[c] = tiny_stl::count_if(first + b, first + e, pred);
+    };
+    parallelChunks(n, chunks, fn);
+
+    IterDiffType<RanIter> sum = 0;
+    for (auto c : counts)
+        sum += c;
+    return sum;
+}
+
+template <typename InIter, typename UnaryPred>
+inline IterDiffType<InIter> countIfAux(InIter first, InIter last,
+                                       UnaryPred& pred, false_type) {
+    return tiny_stl::count_if(first, last, pred);
+}
+
+template <typename RanIter, typename UnaryPred>
+inline RanIter findIfAux(RanIter first, RanIter last, UnaryPred& pred,
+                         true_type) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    std::atomic<std::size_t> found{n};
+    auto fn = [first, &pred, &found](std::size_t b, std::size_t e,
+                                     std::size_t) {
+        // a match in an earlier chunk wins
+        if (found.load(std::memory_order_relaxed) < b)
+            return;
+
+        const RanIter end = first + e;
+        const RanIter it = tiny_stl::find_if(first + b, end, pred);
+        if (it == end)
+            return;
+
+        const std::size_t pos = static_cast<std::size_t>(it - first);
+        std::size_t old = found.load(std::memory_order_relaxed);
+        while (pos < old && !found.compare_exchange_weak(old, pos))
+            ;
+    };
+    parallelChunks(n, parallelChunkCount(n), fn);
+    return first + found.load();
+}
+
+template <typename InIter, typename UnaryPred>
+inline InIter findIfAux(InIter first, InIter last, UnaryPred& pred,
+                        false_type) {
+    return tiny_stl::find_if(first, last, pred);
+}
+
+template <typename RanIter, typename T>
+inline void fillAux(RanIter first, RanIter last, const T& val, true_type) {
+    auto fn = [first, &val](std::size_t b, std::size_t e, std::size_t) {
+        tiny_stl::fill(first + b, first + e, val);
+    };
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    parallelChunks(n, parallelChunkCount(n), fn);
+}
+
+template <typename FwdIter, typename T>
+inline void fillAux(FwdIter first, FwdIter last, const T& val, false_type) {
+    tiny_stl::fill(first, last, val);
+}
+
+template <typename RanIter, typename OutIter>
+inline OutIter copyAux(RanIter first, RanIter last, OutIter dst, true_type) {
+    auto fn = [first, dst](std::size_t b, std::size_t e, std::size_t) {
+        tiny_stl::copy(first + b, first + e, dst + b);
+    };
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    parallelChunks(n, parallelChunkCount(n), fn);
+    return dst + n;
+}
+
+template <typename InIter, typename OutIter>
+inline OutIter copyAux(InIter first, InIter last, OutIter dst, false_type) {
+    return tiny_stl::copy(first, last, dst);
+}
+
+template <typename RanIter, typename Compare>
+inline pair<RanIter, RanIter> minmaxElementAux(RanIter first, RanIter last,
+                                               Compare& cmp, true_type) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    const std::size_t chunks = parallelChunkCount(n);
+    vector<pair<RanIter, RanIter>> parts(chunks);
+    auto fn = [first, &cmp, &parts](std::size_t b, std::size_t e,
+                                    std::size_t c) {
+        parts[c] = tiny_stl::minmax_element(first + b, first + e, cmp);
+    };
+    parallelChunks(n, chunks, fn);
+
+    // the first smallest and the last largest, as the sequential one
+    pair<RanIter, RanIter> ret = parts[0];
+    for (std::size_t c = 1; c < chunks; ++c) {
+        if (cmp(*parts[c].first, *ret.first))
+            ret.first = parts[c].first;
+        if (!cmp(*parts[c].second, *ret.second))
+            ret.second = parts[c].second;
+    }
+    return ret;
+}
+
+template <typename FwdIter, typename Compare>
+inline pair<FwdIter, FwdIter> minmaxElementAux(FwdIter first, FwdIter last,
+                                               Compare& cmp, false_type) {
+    return tiny_stl::minmax_element(first, last, cmp);
+}
+
+template <typename RanIter1, typename RanIter2, typename BinPred>
+inline bool equalAux(RanIter1 first1, RanIter1 last1, RanIter2 first2,
+                     BinPred& pred, true_type) {
+    std::atomic<bool> same{true};
+    auto fn = [first1, first2, &pred, &same](std::size_t b, std::size_t e,
+                                             std::size_t) {
+        if (same.load(std::memory_order_relaxed) &&
+            !tiny_stl::equal(first1 + b, first1 + e, first2 + b, pred))
+            same.store(false, std::memory_order_relaxed);
+    };
+    const std::size_t n = static_cast<std::size_t>(last1 - first1);
+    parallelChunks(n, parallelChunkCount(n), fn);
+    return same.load();
+}
+
+template <typename InIter1, typename InIter2, typename BinPred>
+inline bool equalAux(InIter1 first1, InIter1 last1, InIter2 first2,
+                     BinPred& pred, false_type) {
+    return tiny_stl::equal(first1, last1, first2, pred);
+}
+
+} // namespace details
+
+// the parallel_policy overloads run on a thread pool shared by the
+// process, ranges that are not random access run sequentially
+
+template <typename ExecutionPolicy, typename RanIter, typename Compare>
+inline details::EnableIfPolicy<ExecutionPolicy, void>
+sort(ExecutionPolicy&&, RanIter first, RanIter last, Compare cmp) {
+    details::policySortAux(first, last, cmp,
+                           details::UseParallel<ExecutionPolicy, RanIter>{});
+}
+
+template <typename ExecutionPolicy, typename RanIter>
+inline details::EnableIfPolicy<ExecutionPolicy, void>
+sort(ExecutionPolicy&& policy, RanIter first, RanIter last) {
+    tiny_stl::sort(policy, first, last, tiny_stl::less<>{});
+}
+
+template <typename ExecutionPolicy, typename FwdIter, typename UnaryFunc>
+inline details::EnableIfPolicy<ExecutionPolicy, void>
+for_each(ExecutionPolicy&&, FwdIter first, FwdIter last, UnaryFunc f) {
+    details::forEachAux(first, last, f,
+                        details::UseParallel<ExecutionPolicy, FwdIter>{});
+}
+
+template <typename ExecutionPolicy, typename FwdIter1, typename FwdIter2,
+          typename UnaryOp>
+inline details::EnableIfPolicy<ExecutionPolicy, FwdIter2>
+transform(ExecutionPolicy&&, FwdIter1 first, FwdIter1 last, FwdIter2 dst,
+          UnaryOp op) {
+    return details::transformAux(
+        first, last, dst, op,
+        details::UseParallel<ExecutionPolicy, FwdIter1, FwdIter2>{});
+}
+
+template <typename ExecutionPolicy, typename FwdIter1, typename FwdIter2,
+          typename FwdIter3, typename BinOp>
+inline details::EnableIfPolicy<ExecutionPolicy, FwdIter3>
+transform(ExecutionPolicy&&, FwdIter1 first1, FwdIter1 last1, FwdIter2 first2,
+          FwdIter3 dst, BinOp op) {
+    return details::transformAux(
+        first1, last1, first2, dst, op,
+        details::UseParallel<ExecutionPolicy, FwdIter1, FwdIter2, FwdIter3>{});
+}
+
+template <typename ExecutionPolicy, typename FwdIter, typename UnaryPred>
+inline details::EnableIfPolicy<ExecutionPolicy,
+                               typename iterator_traits<FwdIter>::difference_type>
+count_if(ExecutionPolicy&&, FwdIter first, FwdIter last, UnaryPred pred) {
+    return details::countIfAux(
+        first, last, pred, details::UseParallel<ExecutionPolicy, FwdIter>{});
+}
+
+template <typename ExecutionPolicy, typename FwdIter, typename UnaryPred>
+inline details::EnableIfPolicy<ExecutionPolicy, FwdIter>
+find_if(ExecutionPolicy&&, FwdIter first, FwdIter last, UnaryPred pred) {
+    return details::findIfAux(first, last, pred,
+                              details::UseParallel<ExecutionPolicy, FwdIter>{});
+}
+
+template <typename ExecutionPolicy, typename FwdIter, typename T>
+inline details::EnableIfPolicy<ExecutionPolicy, void>
+fill(ExecutionPolicy&&, FwdIter first, FwdIter last, const T& val) {
+    details::fillAux(first, last, val,
+                     details::UseParallel<ExecutionPolicy, FwdIter>{});
+}
+
+template <typename ExecutionPolicy, typename FwdIter1, typename FwdIter2>
+inline details::EnableIfPolicy<ExecutionPolicy, FwdIter2>
+copy(ExecutionPolicy&&, FwdIter1 first, FwdIter1 last, FwdIter2 dst) {
+    return details::copyAux(
+        first, last, dst,
+        details::UseParallel<ExecutionPolicy, FwdIter1, FwdIter2>{});
+}
+
+template <typename ExecutionPolicy, typename FwdIter, typename Compare>
+inline details::EnableIfPolicy<ExecutionPolicy, pair<FwdIter, FwdIter>>
+minmax_element(ExecutionPolicy&&, FwdIter first, FwdIter last, Compare cmp) {
+    if (first == last)
+        return tiny_stl::make_pair(first, first);
+
+    return details::minmaxElementAux(
+        first, last, cmp, details::UseParallel<ExecutionPolicy, FwdIter>{});
+}
+
+template <typename ExecutionPolicy, typename FwdIter>
+inline details::EnableIfPolicy<ExecutionPolicy, pair<FwdIter, FwdIter>>
+minmax_element(ExecutionPolicy&& policy, FwdIter first, FwdIter last) {
+    return tiny_stl::minmax_element(policy, first, last, tiny_stl::less<>{});
+}
+
+template <typename ExecutionPolicy, typename FwdIter1, typename FwdIter2,
+          typename BinPred>
+inline details::EnableIfPolicy<ExecutionPolicy, bool>
+equal(ExecutionPolicy&&, FwdIter1 first1, FwdIter1 last1, FwdIter2 first2,
+      BinPred pred) {
+    return details::equalAux(
+        first1, last1, first2, pred,
+        details::UseParallel<ExecutionPolicy, FwdIter1, FwdIter2>{});
+}
+
+template <typename ExecutionPolicy, typename FwdIter1, typename FwdIter2>
+inline details::EnableIfPolicy<ExecutionPolicy, bool>
+equal(ExecutionPolicy&& policy, FwdIter1 first1, FwdIter1 last1,
+      FwdIter2 first2) {
+    return tiny_stl::equal(policy, first1, last1, first2,
+                           tiny_stl::equal_to<>{});
+}
+
+} // namespace tiny_stl
@@ -0,0 +1,985 @@
+﻿// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "flat_tree.hpp"
+
+namespace tiny_stl {
+
+namespace details {
+
+// the keys and the mapped values live in two arrays, dereference yields
+// a pair of references
+template <typename Key, typename T>
+class FlatMapIterator {
+public:
+    using iterator_category = random_access_iterator_tag;
+    using value_type = pair<Key, remove_const_t<T>>;
+    using difference_type = std::ptrdiff_t;
+    using reference = pair<const Key&, T&>;
+
+    // there is no pair object to point to, -> goes through a proxy
+    struct pointer {
+        reference ref;
+
+        const reference* operator->() const noexcept {
+            return &ref;
+        }
+    };
+
+    using Self = FlatMapIterator<Key, T>;
+
+    const Key* keyPtr;
+    T* valPtr;
+
+    FlatMapIterator() noexcept : keyPtr(nullptr), valPtr(nullptr) {
+    }
+
+    FlatMapIterator(const Key* k, T* v) noexcept : keyPtr(k), valPtr(v) {
+    }
+
+    // iterator to const_iterator
+    template <typename U,
+              typename = enable_if_t<is_same<const U, T>::value &&
+                                     !is_same<U, T>::value>>
+    FlatMapIterator(const FlatMapIterator<Key, U>& rhs) noexcept
+        : keyPtr(rhs.keyPtr), valPtr(rhs.valPtr) {
+    }
+
+    reference operator*() const noexcept {
+        return reference(*keyPtr, *valPtr);
+    }
+
+    pointer operator->() const noexcept {
+        return pointer{**this};
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return reference(keyPtr[n], valPtr[n]);
+    }
+
+    Self& operator++() noexcept {
+        ++keyPtr;
+        ++valPtr;
+        return *this;
+    }
+
+    Self operator++(int) noexcept {
+        Self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    Self& operator--() noexcept {
+        --keyPtr;
+        --valPtr;
+        return *this;
+    }
+
+    Self operator--(int) noexcept {
+        Self tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    Self& operator+=(difference_type n) noexcept {
+        keyPtr += n;
+        valPtr += n;
+        return *this;
+    }
+
+    Self operator+(difference_type n) const noexcept {
+        Self tmp = *this;
+        return tmp += n;
+    }
+
+    Self& operator-=(difference_type n) noexcept {
+        return *this += -n;
+    }
+
+    Self operator-(difference_type n) const noexcept {
+        Self tmp = *this;
+        return tmp -= n;
+    }
+
+    difference_type operator-(const Self& rhs) const noexcept {
+        return keyPtr - rhs.keyPtr;
+    }
+
+    bool operator==(const Self& rhs) const noexcept {
+        return keyPtr == rhs.keyPtr;
+    }
+
+    bool operator!=(const Self& rhs) const noexcept {
+        return keyPtr != rhs.keyPtr;
+    }
+
+    bool operator<(const Self& rhs) const noexcept {
+        return keyPtr < rhs.keyPtr;
+    }
+
+    bool operator>(const Self& rhs) const noexcept {
+        return rhs < *this;
+    }
+
+    bool operator<=(const Self& rhs) const noexcept {
+        return !(rhs < *this);
+    }
+
+    bool operator>=(const Self& rhs) const noexcept {
+        return !(*this < rhs);
+    }
+}; // FlatMapIterator
+
+template <typename Key, typename T>
+inline FlatMapIterator<Key, T>
+operator+(typename FlatMapIterator<Key, T>::difference_type n,
+          FlatMapIterator<Key, T> iter) noexcept {
+    return iter += n;
+}
+
+} // namespace details
+
+// a sorted vector of keys and a vector of the mapped values in the same
+// order, the base of flat_map and flat_multimap. lookups only touch the
+// keys
+template <typename Key, typename T, typename Compare, typename Alloc>
+class FlatMap {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = pair<Key, T>;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+
+private:
+    using AlTraits = allocator_traits<Alloc>;
+    using KeyAlloc = typename AlTraits::template rebind_alloc<Key>;
+    using MappedAlloc = typename AlTraits::template rebind_alloc<T>;
+
+public:
+    using key_container_type = vector<Key, KeyAlloc>;
+    using mapped_container_type = vector<T, MappedAlloc>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = pair<const Key&, T&>;
+    using const_reference = pair<const Key&, const T&>;
+    using iterator = details::FlatMapIterator<Key, T>;
+    using const_iterator = details::FlatMapIterator<Key, const T>;
+    using reverse_iterator = tiny_stl::reverse_iterator<iterator>;
+    using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>;
+
+    class value_compare {
+        friend FlatMap;
+
+    protected:
+        Compare mCmp;
+
+        value_compare(Compare c) : mCmp(c) {
+        }
+
+    public:
+        bool operator()(const_reference lhs, const_reference rhs) const {
+            return mCmp(lhs.first, rhs.first);
+        }
+    };
+
+protected:
+    key_container_type keyVec;
+    mapped_container_type valVec;
+    Compare compare;
+
+    FlatMap(const Compare& cmp, const Alloc& alloc)
+        : keyVec(KeyAlloc(alloc)), valVec(MappedAlloc(alloc)), compare(cmp) {
+    }
+
+    FlatMap(key_container_type&& keys, mapped_container_type&& values,
+            const Compare& cmp)
+        : keyVec(tiny_stl::move(keys)), valVec(tiny_stl::move(values)),
+          compare(cmp) {
+        assert(keyVec.size() == valVec.size());
+    }
+
+    FlatMap(const FlatMap& rhs) = default;
+    FlatMap(FlatMap&& rhs) = default;
+
+    FlatMap(const FlatMap& rhs, const Alloc& alloc)
+        : keyVec(rhs.keyVec, KeyAlloc(alloc)),
+          valVec(rhs.valVec, MappedAlloc(alloc)), compare(rhs.compare) {
+    }
+
+    FlatMap(FlatMap&& rhs, const Alloc& alloc)
+        : keyVec(tiny_stl::move(rhs.keyVec), KeyAlloc(alloc)),
+          valVec(tiny_stl::move(rhs.valVec), MappedAlloc(alloc)),
+          compare(rhs.compare) {
+    }
+
+    FlatMap& operator=(const FlatMap& rhs) = default;
+    FlatMap& operator=(FlatMap&& rhs) = default;
+
+private:
+    iterator makeIter(size_type i) noexcept {
+        return iterator(keyVec.data() + i, valVec.data() + i);
+    }
+
+    const_iterator makeIter(size_type i) const noexcept {
+        return const_iterator(keyVec.data() + i, valVec.data() + i);
+    }
+
+    size_type indexOf(const_iterator pos) const noexcept {
+        return static_cast<size_type>(pos.keyPtr - keyVec.data());
+    }
+
+    template <typename K>
+    size_type lowIndex(const K& key) const {
+        return static_cast<size_type>(
+            details::flatLowerBound(keyVec.data(), keyVec.size(), key,
+                                    compare) -
+            keyVec.data());
+    }
+
+    template <typename K>
+    size_type uppIndex(const K& key) const {
+        return static_cast<size_type>(
+            details::flatUpperBound(keyVec.data(), keyVec.size(), key,
+                                    compare) -
+            keyVec.data());
+    }
+
+    template <typename K>
+    size_type findIndex(const K& key) const {
+        const size_type i = lowIndex(key);
+        return (i == size() || compare(key, keyVec[i])) ? size() : i;
+    }
+
+public:
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(keyVec.get_allocator());
+    }
+
+    size_type size() const noexcept {
+        return keyVec.size();
+    }
+
+    bool empty() const noexcept {
+        return keyVec.empty();
+    }
+
+    size_type max_size() const noexcept {
+        return tiny_stl::min(keyVec.max_size(), valVec.max_size());
+    }
+
+    void reserve(size_type n) {
+        keyVec.reserve(n);
+        valVec.reserve(n);
+    }
+
+    void shrink_to_fit() {
+        keyVec.shrink_to_fit();
+        valVec.shrink_to_fit();
+    }
+
+    const key_container_type& keys() const noexcept {
+        return keyVec;
+    }
+
+    const mapped_container_type& values() const noexcept {
+        return valVec;
+    }
+
+    iterator lower_bound(const key_type& key) {
+        return makeIter(lowIndex(key));
+    }
+
+    const_iterator lower_bound(const key_type& key) const {
+        return makeIter(lowIndex(key));
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    iterator lower_bound(const K& key) {
+        return makeIter(lowIndex(key));
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    const_iterator lower_bound(const K& key) const {
+        return makeIter(lowIndex(key));
+    }
+
+    iterator upper_bound(const key_type& key) {
+        return makeIter(uppIndex(key));
+    }
+
+    const_iterator upper_bound(const key_type& key) const {
+        return makeIter(uppIndex(key));
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    iterator upper_bound(const K& key) {
+        return makeIter(uppIndex(key));
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    const_iterator upper_bound(const K& key) const {
+        return makeIter(uppIndex(key));
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key) {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type& key) const {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    pair<iterator, iterator> equal_range(const K& key) {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    size_type count(const key_type& key) const {
+        return uppIndex(key) - lowIndex(key);
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    size_type count(const K& key) const {
+        return uppIndex(key) - lowIndex(key);
+    }
+
+    iterator find(const key_type& key) {
+        return makeIter(findIndex(key));
+    }
+
+    const_iterator find(const key_type& key) const {
+        return makeIter(findIndex(key));
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    iterator find(const K& key) {
+        return makeIter(findIndex(key));
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    const_iterator find(const K& key) const {
+        return makeIter(findIndex(key));
+    }
+
+    bool contains(const key_type& key) const {
+        return findIndex(key) != size();
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    bool contains(const K& key) const {
+        return findIndex(key) != size();
+    }
+
+protected:
+    template <typename K, typename... Args>
+    iterator emplaceAt(size_type i, K&& key, Args&&... args) {
+        keyVec.emplace(keyVec.cbegin() + i, tiny_stl::forward<K>(key));
+        try {
+            valVec.emplace(valVec.cbegin() + i,
+                           tiny_stl::forward<Args>(args)...);
+        } catch (...) {
+            keyVec.erase(keyVec.cbegin() + i);
+            throw;
+        }
+
+        return makeIter(i);
+    }
+
+    template <typename K, typename... Args>
+    pair<iterator, bool> tryEmplaceAux(K&& key, Args&&... args) {
+        const size_type i = lowIndex(key);
+        if (i != size() && !compare(key, keyVec[i]))
+            return {makeIter(i), false};
+
+        return {emplaceAt(i, tiny_stl::forward<K>(key),
+                          tiny_stl::forward<Args>(args)...),
+                true};
+    }
+
+    template <typename Value>
+    iterator insertEqualAux(Value&& val) {
+        return emplaceAt(uppIndex(val.first),
+                         tiny_stl::forward<Value>(val).first,
+                         tiny_stl::forward<Value>(val).second);
+    }
+
+    template <typename Value>
+    pair<iterator, bool> insertUniqueAux(Value&& val) {
+        return tryEmplaceAux(tiny_stl::forward<Value>(val).first,
+                             tiny_stl::forward<Value>(val).second);
+    }
+
+    // the inserted values are dropped if one of them throws
+    template <typename InIter>
+    void appendRange(InIter first, InIter last) {
+        const size_type oldSize = size();
+        try {
+            for (; first != last; ++first) {
+                auto&& val = *first;
+                keyVec.emplace_back(val.first);
+                valVec.emplace_back(val.second);
+            }
+        } catch (...) {
+            keyVec.erase(keyVec.cbegin() + oldSize, keyVec.cend());
+            valVec.erase(valVec.cbegin() + oldSize, valVec.cend());
+            throw;
+        }
+    }
+
+    // stable, sorts a permutation by the keys and moves both arrays
+    // through it once
+    void sortEqual() {
+        if (tiny_stl::is_sorted(keyVec.begin(), keyVec.end(), compare))
+            return;
+
+        const size_type n = size();
+        const Key* keys = keyVec.data();
+        const Compare& cmp = compare;
+        vector<size_type> perm(n);
+        for (size_type i = 0; i < n; ++i)
+            perm[i] = i;
+        tiny_stl::stable_sort(perm.begin(), perm.end(),
+                              [keys, &cmp](size_type lhs, size_type rhs) {
+                                  return cmp(keys[lhs], keys[rhs]);
+                              });
+
+        key_container_type newKeys(keyVec.get_allocator());
+        mapped_container_type newValues(valVec.get_allocator());
+        newKeys.reserve(n);
+        newValues.reserve(n);
+        for (size_type i = 0; i < n; ++i) {
+            newKeys.push_back(tiny_stl::move(keyVec[perm[i]]));
+            newValues.push_back(tiny_stl::move(valVec[perm[i]]));
+        }
+
+        keyVec.swap(newKeys);
+        valVec.swap(newValues);
+    }
+
+    // keeps the first one of the equivalent keys
+    void sortUnique() {
+        sortEqual();
+
+        const size_type n = size();
+        if (n == 0)
+            return;
+
+        size_type result = 0;
+        for (size_type i = 1; i < n; ++i) {
+            if (compare(keyVec[result], keyVec[i]) && ++result != i) {
+                keyVec[result] = tiny_stl::move(keyVec[i]);
+                valVec[result] = tiny_stl::move(valVec[i]);
+            }
+        }
+
+        keyVec.erase(keyVec.cbegin() + (result + 1), keyVec.cend());
+        valVec.erase(valVec.cbegin() + (result + 1), valVec.cend());
+    }
+
+public:
+    iterator insert_equal(const value_type& val) {
+        return insertEqualAux(val);
+    }
+
+    iterator insert_equal(value_type&& val) {
+        return insertEqualAux(tiny_stl::move(val));
+    }
+
+    // append and sort once, the old values are a presorted run
+    template <typename InIter>
+    void insert_equal(InIter first, InIter last) {
+        appendRange(first, last);
+        sortEqual();
+    }
+
+    pair<iterator, bool> insert_unique(const value_type& val) {
+        return insertUniqueAux(val);
+    }
+
+    pair<iterator, bool> insert_unique(value_type&& val) {
+        return insertUniqueAux(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert_unique(InIter first, InIter last) {
+        appendRange(first, last);
+        sortUnique();
+    }
+
+    template <typename... Args>
+    iterator emplace_equal(Args&&... args) {
+        return insertEqualAux(value_type(tiny_stl::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> emplace_unique(Args&&... args) {
+        return insertUniqueAux(value_type(tiny_stl::forward<Args>(args)...));
+    }
+
+    iterator erase(const_iterator pos) {
+        const size_type i = indexOf(pos);
+        keyVec.erase(keyVec.cbegin() + i);
+        valVec.erase(valVec.cbegin() + i);
+        return makeIter(i);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        const size_type i = indexOf(first);
+        const size_type j = indexOf(last);
+        keyVec.erase(keyVec.cbegin() + i, keyVec.cbegin() + j);
+        valVec.erase(valVec.cbegin() + i, valVec.cbegin() + j);
+        return makeIter(i);
+    }
+
+    size_type erase(const key_type& key) {
+        auto ppos = equal_range(key);
+        const size_type num = ppos.second - ppos.first;
+        erase(ppos.first, ppos.second);
+
+        return num;
+    }
+
+    // iterators are not keys
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent,
+              typename = enable_if_t<!is_convertible<K, iterator>::value &&
+                                     !is_convertible<K, const_iterator>::value>>
+    size_type erase(K&& key) {
+        auto ppos = equal_range(key);
+        const size_type num = ppos.second - ppos.first;
+        erase(ppos.first, ppos.second);
+
+        return num;
+    }
+
+    iterator begin() noexcept {
+        return makeIter(0);
+    }
+
+    const_iterator begin() const noexcept {
+        return makeIter(0);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return makeIter(size());
+    }
+
+    const_iterator end() const noexcept {
+        return makeIter(size());
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+    void clear() noexcept {
+        keyVec.clear();
+        valVec.clear();
+    }
+
+    key_compare key_comp() const {
+        return compare;
+    }
+
+    value_compare value_comp() const {
+        return value_compare(compare);
+    }
+
+    void swap(FlatMap& rhs) noexcept(is_nothrow_swappable<Compare>::value) {
+        keyVec.swap(rhs.keyVec);
+        valVec.swap(rhs.valVec);
+        tiny_stl::swapADL(compare, rhs.compare);
+    }
+}; // FlatMap
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+bool operator==(const FlatMap<Key, T, Compare, Alloc>& lhs,
+                const FlatMap<Key, T, Compare, Alloc>& rhs) {
+    return lhs.keys() == rhs.keys() && lhs.values() == rhs.values();
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+bool operator!=(const FlatMap<Key, T, Compare, Alloc>& lhs,
+                const FlatMap<Key, T, Compare, Alloc>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+bool operator<(const FlatMap<Key, T, Compare, Alloc>& lhs,
+               const FlatMap<Key, T, Compare, Alloc>& rhs) {
+    return tiny_stl::lexicographical_compare(lhs.begin(), lhs.end(),
+                                             rhs.begin(), rhs.end());
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+bool operator>(const FlatMap<Key, T, Compare, Alloc>& lhs,
+               const FlatMap<Key, T, Compare, Alloc>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+bool operator<=(const FlatMap<Key, T, Compare, Alloc>& lhs,
+                const FlatMap<Key, T, Compare, Alloc>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+bool operator>=(const FlatMap<Key, T, Compare, Alloc>& lhs,
+                const FlatMap<Key, T, Compare, Alloc>& rhs) {
+    return !(lhs < rhs);
+}
+
+template <typename Key, typename T, typename Compare = less<Key>,
+          typename Alloc = allocator<pair<Key, T>>>
+class flat_map : public FlatMap<Key, T, Compare, Alloc> {
+private:
+    using Base = FlatMap<Key, T, Compare, Alloc>;
+
+public:
+    using allocator_type = Alloc;
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = typename Base::value_type;
+    using key_container_type = typename Base::key_container_type;
+    using mapped_container_type = typename Base::mapped_container_type;
+    using size_type = typename Base::size_type;
+    using difference_type = typename Base::difference_type;
+    using key_compare = Compare;
+    using value_compare = typename Base::value_compare;
+    using reference = typename Base::reference;
+    using const_reference = typename Base::const_reference;
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+    using reverse_iterator = typename Base::reverse_iterator;
+    using const_reverse_iterator = typename Base::const_reverse_iterator;
+
+public:
+    flat_map() : flat_map(Compare()) {
+    }
+    explicit flat_map(const Compare& cmp, const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+    }
+
+    explicit flat_map(const Alloc& alloc) : Base(Compare(), alloc) {
+    }
+
+    template <typename InIter>
+    flat_map(InIter first, InIter last, const Compare& cmp = Compare(),
+             const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_unique(first, last);
+    }
+
+    template <typename InIter>
+    flat_map(InIter first, InIter last, const Alloc& alloc)
+        : Base(Compare(), alloc) {
+        this->insert_unique(first, last);
+    }
+
+    // takes the two vectors and sorts them once
+    flat_map(key_container_type keys, mapped_container_type values,
+             const Compare& cmp = Compare())
+        : Base(tiny_stl::move(keys), tiny_stl::move(values), cmp) {
+        this->sortUnique();
+    }
+
+    flat_map(sorted_unique_t, key_container_type keys,
+             mapped_container_type values, const Compare& cmp = Compare())
+        : Base(tiny_stl::move(keys), tiny_stl::move(values), cmp) {
+        assert(tiny_stl::is_sorted(this->keyVec.begin(), this->keyVec.end(),
+                                   cmp));
+    }
+
+    flat_map(const flat_map& rhs) = default;
+
+    flat_map(const flat_map& rhs, const Alloc& alloc) : Base(rhs, alloc) {
+    }
+
+    flat_map(flat_map&& rhs) = default;
+
+    flat_map(flat_map&& rhs, const Alloc& alloc)
+        : Base(tiny_stl::move(rhs), alloc) {
+    }
+
+    flat_map(std::initializer_list<value_type> ilist,
+             const Compare& cmp = Compare(), const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_unique(ilist.begin(), ilist.end());
+    }
+
+    flat_map(std::initializer_list<value_type> ilist, const Alloc& alloc)
+        : flat_map(ilist, Compare(), alloc) {
+    }
+
+    flat_map& operator=(const flat_map& rhs) = default;
+    flat_map& operator=(flat_map&& rhs) = default;
+
+    flat_map& operator=(std::initializer_list<value_type> ilist) {
+        flat_map tmp(ilist);
+        this->swap(tmp);
+        return *this;
+    }
+
+    T& at(const Key& key) {
+        iterator pos = this->find(key);
+        if (pos == this->end())
+            xRange();
+
+        return *pos.valPtr;
+    }
+
+    const T& at(const Key& key) const {
+        const_iterator pos = this->find(key);
+        if (pos == this->end())
+            xRange();
+
+        return *pos.valPtr;
+    }
+
+    T& operator[](const Key& key) {
+        return *this->tryEmplaceAux(key).first.valPtr;
+    }
+
+    T& operator[](Key&& key) {
+        return *this->tryEmplaceAux(tiny_stl::move(key)).first.valPtr;
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        return this->tryEmplaceAux(key, tiny_stl::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+        return this->tryEmplaceAux(tiny_stl::move(key),
+                                   tiny_stl::forward<Args>(args)...);
+    }
+
+    pair<iterator, bool> insert(const value_type& val) {
+        return this->insert_unique(val);
+    }
+
+    template <typename P,
+              typename = enable_if_t<is_constructible<value_type, P&&>::value>>
+    pair<iterator, bool> insert(P&& val) {
+        return this->insert_unique(value_type(tiny_stl::forward<P>(val)));
+    }
+
+    pair<iterator, bool> insert(value_type&& val) {
+        return this->insert_unique(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert(InIter first, InIter last) {
+        this->insert_unique(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        this->insert_unique(ilist.begin(), ilist.end());
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+        return this->emplace_unique(tiny_stl::forward<Args>(args)...);
+    }
+
+    void swap(flat_map& rhs) {
+        Base::swap(rhs);
+    }
+
+private:
+    [[noreturn]] static void xRange() {
+        throw "flat_map<Key, T>, key is not exist";
+    }
+}; // flat_map
+
+template <typename Key, typename T, typename Cmp, typename Alloc>
+inline void
+swap(flat_map<Key, T, Cmp, Alloc>& lhs,
+     flat_map<Key, T, Cmp, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+template <typename Key, typename T, typename Compare = less<Key>,
+          typename Alloc = allocator<pair<Key, T>>>
+class flat_multimap : public FlatMap<Key, T, Compare, Alloc> {
+private:
+    using Base = FlatMap<Key, T, Compare, Alloc>;
+
+public:
+    using allocator_type = Alloc;
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = typename Base::value_type;
+    using key_container_type = typename Base::key_container_type;
+    using mapped_container_type = typename Base::mapped_container_type;
+    using size_type = typename Base::size_type;
+    using difference_type = typename Base::difference_type;
+    using key_compare = Compare;
+    using value_compare = typename Base::value_compare;
+    using reference = typename Base::reference;
+    using const_reference = typename Base::const_reference;
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+    using reverse_iterator = typename Base::reverse_iterator;
+    using const_reverse_iterator = typename Base::const_reverse_iterator;
+
+public:
+    flat_multimap() : flat_multimap(Compare()) {
+    }
+    explicit flat_multimap(const Compare& cmp, const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+    }
+
+    explicit flat_multimap(const Alloc& alloc) : Base(Compare(), alloc) {
+    }
+
+    template <typename InIter>
+    flat_multimap(InIter first, InIter last, const Compare& cmp = Compare(),
+                  const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_equal(first, last);
+    }
+
+    template <typename InIter>
+    flat_multimap(InIter first, InIter last, const Alloc& alloc)
+        : Base(Compare(), alloc) {
+        this->insert_equal(first, last);
+    }
+
+    // takes the two vectors and sorts them once
+    flat_multimap(key_container_type keys, mapped_container_type values,
+                  const Compare& cmp = Compare())
+        : Base(tiny_stl::move(keys), tiny_stl::move(values), cmp) {
+        this->sortEqual();
+    }
+
+    flat_multimap(sorted_equivalent_t, key_container_type keys,
+                  mapped_container_type values,
+                  const Compare& cmp = Compare())
+        : Base(tiny_stl::move(keys), tiny_stl::move(values), cmp) {
+        assert(tiny_stl::is_sorted(this->keyVec.begin(), this->keyVec.end(),
+                                   cmp));
+    }
+
+    flat_multimap(const flat_multimap& rhs) = default;
+
+    flat_multimap(const flat_multimap& rhs, const Alloc& alloc)
+        : Base(rhs, alloc) {
+    }
+
+    flat_multimap(flat_multimap&& rhs) = default;
+
+    flat_multimap(flat_multimap&& rhs, const Alloc& alloc)
+        : Base(tiny_stl::move(rhs), alloc) {
+    }
+
+    flat_multimap(std::initializer_list<value_type> ilist,
+                  const Compare& cmp = Compare(),
+                  const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_equal(ilist.begin(), ilist.end());
+    }
+
+    flat_multimap(std::initializer_list<value_type> ilist, const Alloc& alloc)
+        : flat_multimap(ilist, Compare(), alloc) {
+    }
+
+    flat_multimap& operator=(const flat_multimap& rhs) = default;
+    flat_multimap& operator=(flat_multimap&& rhs) = default;
+
+    flat_multimap& operator=(std::initializer_list<value_type> ilist) {
+        flat_multimap tmp(ilist);
+        this->swap(tmp);
+        return *this;
+    }
+
+    iterator insert(const value_type& val) {
+        return this->insert_equal(val);
+    }
+
+    template <typename P,
+              typename = enable_if_t<is_constructible<value_type, P&&>::value>>
+    iterator insert(P&& val) {
+        return this->insert_equal(value_type(tiny_stl::forward<P>(val)));
+    }
+
+    iterator insert(value_type&& val) {
+        return this->insert_equal(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert(InIter first, InIter last) {
+        this->insert_equal(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        this->insert_equal(ilist.begin(), ilist.end());
+    }
+
+    template <typename... Args>
+    iterator emplace(Args&&... args) {
+        return this->emplace_equal(tiny_stl::forward<Args>(args)...);
+    }
+
+    void swap(flat_multimap& rhs) {
+        Base::swap(rhs);
+    }
+}; // flat_multimap
+
+template <typename Key, typename T, typename Cmp, typename Alloc>
+inline void swap(flat_multimap<Key, T, Cmp, Alloc>& lhs,
+                 flat_multimap<Key, T, Cmp, Alloc>& rhs) noexcept(
+    noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+} // namespace tiny_stl
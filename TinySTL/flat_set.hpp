@@ -0,0 +1,257 @@
+﻿// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "flat_tree.hpp"
+
+namespace tiny_stl {
+
+// flat_set
+template <typename Key, typename Compare = tiny_stl::less<Key>,
+          typename Alloc = tiny_stl::allocator<Key>>
+class flat_set : public FlatTree<Key, Compare, Alloc> {
+private:
+    using Base = FlatTree<Key, Compare, Alloc>;
+
+public:
+    using allocator_type = Alloc;
+    using container_type = typename Base::container_type;
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = typename Base::size_type;
+    using difference_type = typename Base::difference_type;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+    using reverse_iterator = typename Base::reverse_iterator;
+    using const_reverse_iterator = typename Base::const_reverse_iterator;
+
+public:
+    flat_set() : flat_set(Compare()) {
+    }
+    explicit flat_set(const Compare& cmp, const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+    }
+
+    explicit flat_set(const Alloc& alloc) : Base(Compare(), alloc) {
+    }
+
+    template <typename InIter>
+    flat_set(InIter first, InIter last, const Compare& cmp = Compare(),
+             const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_unique(first, last);
+    }
+
+    template <typename InIter>
+    flat_set(InIter first, InIter last, const Alloc& alloc)
+        : Base(Compare(), alloc) {
+        this->insert_unique(first, last);
+    }
+
+    // takes the vector and sorts it once
+    explicit flat_set(container_type cont, const Compare& cmp = Compare())
+        : Base(tiny_stl::move(cont), cmp) {
+        this->sortUnique();
+    }
+
+    flat_set(sorted_unique_t, container_type cont,
+             const Compare& cmp = Compare())
+        : Base(tiny_stl::move(cont), cmp) {
+        assert(tiny_stl::is_sorted(this->begin(), this->end(), cmp));
+    }
+
+    flat_set(const flat_set& rhs) = default;
+
+    flat_set(const flat_set& rhs, const Alloc& alloc) : Base(rhs, alloc) {
+    }
+
+    flat_set(flat_set&& rhs) = default;
+
+    flat_set(flat_set&& rhs, const Alloc& alloc)
+        : Base(tiny_stl::move(rhs), alloc) {
+    }
+
+    flat_set(std::initializer_list<value_type> ilist,
+             const Compare& cmp = Compare(), const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_unique(ilist.begin(), ilist.end());
+    }
+
+    flat_set(std::initializer_list<value_type> ilist, const Alloc& alloc)
+        : flat_set(ilist, Compare(), alloc) {
+    }
+
+    flat_set& operator=(const flat_set& rhs) = default;
+    flat_set& operator=(flat_set&& rhs) = default;
+
+    flat_set& operator=(std::initializer_list<value_type> ilist) {
+        flat_set tmp(ilist);
+        this->swap(tmp);
+        return *this;
+    }
+
+    pair<iterator, bool> insert(const value_type& val) {
+        return this->insert_unique(val);
+    }
+
+    pair<iterator, bool> insert(value_type&& val) {
+        return this->insert_unique(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert(InIter first, InIter last) {
+        this->insert_unique(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        this->insert_unique(ilist.begin(), ilist.end());
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+        return this->emplace_unique(tiny_stl::forward<Args>(args)...);
+    }
+
+    void swap(flat_set& rhs) {
+        Base::swap(rhs);
+    }
+}; // flat_set
+
+template <typename Key, typename Compare, typename Alloc>
+inline void
+swap(flat_set<Key, Compare, Alloc>& lhs,
+     flat_set<Key, Compare, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+// flat_multiset
+template <typename Key, typename Compare = tiny_stl::less<Key>,
+          typename Alloc = tiny_stl::allocator<Key>>
+class flat_multiset : public FlatTree<Key, Compare, Alloc> {
+private:
+    using Base = FlatTree<Key, Compare, Alloc>;
+
+public:
+    using allocator_type = Alloc;
+    using container_type = typename Base::container_type;
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = typename Base::size_type;
+    using difference_type = typename Base::difference_type;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+    using reverse_iterator = typename Base::reverse_iterator;
+    using const_reverse_iterator = typename Base::const_reverse_iterator;
+
+public:
+    flat_multiset() : flat_multiset(Compare()) {
+    }
+    explicit flat_multiset(const Compare& cmp, const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+    }
+
+    explicit flat_multiset(const Alloc& alloc) : Base(Compare(), alloc) {
+    }
+
+    template <typename InIter>
+    flat_multiset(InIter first, InIter last, const Compare& cmp = Compare(),
+                  const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_equal(first, last);
+    }
+
+    template <typename InIter>
+    flat_multiset(InIter first, InIter last, const Alloc& alloc)
+        : Base(Compare(), alloc) {
+        this->insert_equal(first, last);
+    }
+
+    // takes the vector and sorts it once
+    explicit flat_multiset(container_type cont, const Compare& cmp = Compare())
+        : Base(tiny_stl::move(cont), cmp) {
+        this->sortEqual();
+    }
+
+    flat_multiset(sorted_equivalent_t, container_type cont,
+                  const Compare& cmp = Compare())
+        : Base(tiny_stl::move(cont), cmp) {
+        assert(tiny_stl::is_sorted(this->begin(), this->end(), cmp));
+    }
+
+    flat_multiset(const flat_multiset& rhs) = default;
+
+    flat_multiset(const flat_multiset& rhs, const Alloc& alloc)
+        : Base(rhs, alloc) {
+    }
+
+    flat_multiset(flat_multiset&& rhs) = default;
+
+    flat_multiset(flat_multiset&& rhs, const Alloc& alloc)
+        : Base(tiny_stl::move(rhs), alloc) {
+    }
+
+    flat_multiset(std::initializer_list<value_type> ilist,
+                  const Compare& cmp = Compare(),
+                  const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_equal(ilist.begin(), ilist.end());
+    }
+
+    flat_multiset(std::initializer_list<value_type> ilist, const Alloc& alloc)
+        : flat_multiset(ilist, Compare(), alloc) {
+    }
+
+    flat_multiset& operator=(const flat_multiset& rhs) = default;
+    flat_multiset& operator=(flat_multiset&& rhs) = default;
+
+    flat_multiset& operator=(std::initializer_list<value_type> ilist) {
+        flat_multiset tmp(ilist);
+        this->swap(tmp);
+        return *this;
+    }
+
+    iterator insert(const value_type& val) {
+        return this->insert_equal(val);
+    }
+
+    iterator insert(value_type&& val) {
+        return this->insert_equal(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert(InIter first, InIter last) {
+        this->insert_equal(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        this->insert_equal(ilist.begin(), ilist.end());
+    }
+
+    template <typename... Args>
+    iterator emplace(Args&&... args) {
+        return this->emplace_equal(tiny_stl::forward<Args>(args)...);
+    }
+
+    void swap(flat_multiset& rhs) {
+        Base::swap(rhs);
+    }
+}; // flat_multiset
+
+template <typename Key, typename Compare, typename Alloc>
+inline void swap(flat_multiset<Key, Compare, Alloc>& lhs,
+                 flat_multiset<Key, Compare, Alloc>& rhs) noexcept(
+    noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+} // namespace tiny_stl
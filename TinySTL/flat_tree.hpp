@@ -0,0 +1,439 @@
+﻿// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "algorithm.hpp"
+#include "vector.hpp"
+
+namespace tiny_stl {
+
+// the input is sorted (and unique), skip the sort of the constructor
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+constexpr sorted_unique_t sorted_unique{};
+
+struct sorted_equivalent_t {
+    explicit sorted_equivalent_t() = default;
+};
+constexpr sorted_equivalent_t sorted_equivalent{};
+
+namespace details {
+
+// binary search over a sorted array. the loop does not branch on the
+// comparison, the compiler emits a conditional move instead of a jump
+// that mispredicts half of the time
+template <typename T, typename K, typename Compare>
+inline const T* flatLowerBound(const T* first, std::size_t n, const K& key,
+                               const Compare& cmp) {
+    if (n == 0)
+        return first;
+
+    while (n > 1) {
+        const std::size_t half = n / 2;
+        first = cmp(first[half], key) ? first + half : first;
+        n -= half;
+    }
+
+    return first + (cmp(*first, key) ? 1 : 0);
+}
+
+template <typename T, typename K, typename Compare>
+inline const T* flatUpperBound(const T* first, std::size_t n, const K& key,
+                               const Compare& cmp) {
+    if (n == 0)
+        return first;
+
+    while (n > 1) {
+        const std::size_t half = n / 2;
+        first = cmp(key, first[half]) ? first : first + half;
+        n -= half;
+    }
+
+    return first + (cmp(key, *first) ? 0 : 1);
+}
+
+// [first, last) is sorted, keeps the first one of the equivalent values
+template <typename FwdIter, typename Compare>
+inline FwdIter flatUnique(FwdIter first, FwdIter last, Compare cmp) {
+    if (first == last)
+        return last;
+
+    FwdIter result = first;
+    while (++first != last) {
+        if (cmp(*result, *first) && ++result != first)
+            *result = tiny_stl::move(*first);
+    }
+
+    return ++result;
+}
+
+} // namespace details
+
+// sorted vector, the base of flat_set and flat_multiset
+template <typename Key, typename Compare, typename Alloc>
+class FlatTree {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using allocator_type = Alloc;
+    using container_type = vector<Key, Alloc>;
+    using size_type = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using iterator = typename container_type::const_iterator;
+    using const_iterator = typename container_type::const_iterator;
+    using reverse_iterator = tiny_stl::reverse_iterator<iterator>;
+    using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>;
+
+protected:
+    container_type elems;
+    Compare compare;
+
+    FlatTree(const Compare& cmp, const Alloc& alloc)
+        : elems(alloc), compare(cmp) {
+    }
+
+    FlatTree(container_type&& cont, const Compare& cmp)
+        : elems(tiny_stl::move(cont)), compare(cmp) {
+    }
+
+    FlatTree(const FlatTree& rhs) = default;
+    FlatTree(FlatTree&& rhs) = default;
+
+    FlatTree(const FlatTree& rhs, const Alloc& alloc)
+        : elems(rhs.elems, alloc), compare(rhs.compare) {
+    }
+
+    FlatTree(FlatTree&& rhs, const Alloc& alloc)
+        : elems(tiny_stl::move(rhs.elems), alloc), compare(rhs.compare) {
+    }
+
+    FlatTree& operator=(const FlatTree& rhs) = default;
+    FlatTree& operator=(FlatTree&& rhs) = default;
+
+private:
+    iterator makeIter(const Key* p) const noexcept {
+        return elems.cbegin() + (p - elems.data());
+    }
+
+    template <typename K>
+    const Key* lowBoundAux(const K& key) const {
+        return details::flatLowerBound(elems.data(), elems.size(), key,
+                                       compare);
+    }
+
+    template <typename K>
+    const Key* uppBoundAux(const K& key) const {
+        return details::flatUpperBound(elems.data(), elems.size(), key,
+                                       compare);
+    }
+
+    template <typename K>
+    iterator findAux(const K& key) const {
+        const Key* p = lowBoundAux(key);
+        return (p == elems.data() + elems.size() || compare(key, *p))
+                   ? end()
+                   : makeIter(p);
+    }
+
+public:
+    allocator_type get_allocator() const noexcept {
+        return elems.get_allocator();
+    }
+
+    size_type size() const noexcept {
+        return elems.size();
+    }
+
+    bool empty() const noexcept {
+        return elems.empty();
+    }
+
+    size_type max_size() const noexcept {
+        return elems.max_size();
+    }
+
+    size_type capacity() const noexcept {
+        return elems.capacity();
+    }
+
+    void reserve(size_type n) {
+        elems.reserve(n);
+    }
+
+    void shrink_to_fit() {
+        elems.shrink_to_fit();
+    }
+
+    iterator lower_bound(const key_type& key) const {
+        return makeIter(lowBoundAux(key));
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    iterator lower_bound(const K& key) const {
+        return makeIter(lowBoundAux(key));
+    }
+
+    iterator upper_bound(const key_type& key) const {
+        return makeIter(uppBoundAux(key));
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    iterator upper_bound(const K& key) const {
+        return makeIter(uppBoundAux(key));
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key) const {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    pair<iterator, iterator> equal_range(const K& key) const {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    size_type count(const key_type& key) const {
+        return static_cast<size_type>(uppBoundAux(key) - lowBoundAux(key));
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    size_type count(const K& key) const {
+        return static_cast<size_type>(uppBoundAux(key) - lowBoundAux(key));
+    }
+
+    iterator find(const key_type& key) const {
+        return findAux(key);
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    iterator find(const K& key) const {
+        return findAux(key);
+    }
+
+    bool contains(const key_type& key) const {
+        return findAux(key) != end();
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    bool contains(const K& key) const {
+        return findAux(key) != end();
+    }
+
+protected:
+    template <typename Value>
+    iterator insertEqualAux(Value&& val) {
+        const Key* p = uppBoundAux(val);
+        return elems.insert(makeIter(p), tiny_stl::forward<Value>(val));
+    }
+
+    template <typename Value>
+    pair<iterator, bool> insertUniqueAux(Value&& val) {
+        const Key* p = lowBoundAux(val);
+        if (p != elems.data() + elems.size() && !compare(val, *p))
+            return {makeIter(p), false};
+
+        return {elems.insert(makeIter(p), tiny_stl::forward<Value>(val)),
+                true};
+    }
+
+    // the inserted values are dropped if one of them throws
+    template <typename InIter>
+    void appendRange(InIter first, InIter last) {
+        const size_type oldSize = size();
+        try {
+            for (; first != last; ++first)
+                elems.emplace_back(*first);
+        } catch (...) {
+            elems.erase(elems.cbegin() + oldSize, elems.cend());
+            throw;
+        }
+    }
+
+    // stable, the values inserted earlier stay before the equivalent ones
+    void sortEqual() {
+        tiny_stl::stable_sort(elems.begin(), elems.end(), compare);
+    }
+
+    void sortUnique() {
+        sortEqual();
+        elems.erase(details::flatUnique(elems.begin(), elems.end(), compare),
+                    elems.end());
+    }
+
+public:
+    iterator insert_equal(const value_type& val) {
+        return insertEqualAux(val);
+    }
+
+    iterator insert_equal(value_type&& val) {
+        return insertEqualAux(tiny_stl::move(val));
+    }
+
+    // append and sort once, the old values are a presorted run
+    template <typename InIter>
+    void insert_equal(InIter first, InIter last) {
+        appendRange(first, last);
+        sortEqual();
+    }
+
+    pair<iterator, bool> insert_unique(const value_type& val) {
+        return insertUniqueAux(val);
+    }
+
+    pair<iterator, bool> insert_unique(value_type&& val) {
+        return insertUniqueAux(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert_unique(InIter first, InIter last) {
+        appendRange(first, last);
+        sortUnique();
+    }
+
+    template <typename... Args>
+    iterator emplace_equal(Args&&... args) {
+        return insertEqualAux(Key(tiny_stl::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> emplace_unique(Args&&... args) {
+        return insertUniqueAux(Key(tiny_stl::forward<Args>(args)...));
+    }
+
+    iterator erase(const_iterator pos) {
+        return elems.erase(pos);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        return elems.erase(first, last);
+    }
+
+    size_type erase(const key_type& key) {
+        auto ppos = equal_range(key);
+        const size_type num = ppos.second - ppos.first;
+        elems.erase(ppos.first, ppos.second);
+
+        return num;
+    }
+
+    // iterators are not keys
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent,
+              typename = enable_if_t<!is_convertible<K, iterator>::value>>
+    size_type erase(K&& key) {
+        auto ppos = equal_range(key);
+        const size_type num = ppos.second - ppos.first;
+        elems.erase(ppos.first, ppos.second);
+
+        return num;
+    }
+
+    iterator begin() const noexcept {
+        return elems.cbegin();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return elems.cbegin();
+    }
+
+    iterator end() const noexcept {
+        return elems.cend();
+    }
+
+    const_iterator cend() const noexcept {
+        return elems.cend();
+    }
+
+    reverse_iterator rbegin() const noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+
+    reverse_iterator rend() const noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+    void clear() noexcept {
+        elems.clear();
+    }
+
+    // moves the sorted vector out, the set is empty afterwards
+    container_type extract() {
+        container_type tmp(tiny_stl::move(elems));
+        elems.clear();
+        return tmp;
+    }
+
+    key_compare key_comp() const {
+        return compare;
+    }
+
+    value_compare value_comp() const {
+        return compare;
+    }
+
+    void swap(FlatTree& rhs) noexcept(
+        is_nothrow_swappable<Compare>::value) {
+        elems.swap(rhs.elems);
+        tiny_stl::swapADL(compare, rhs.compare);
+    }
+}; // FlatTree
+
+template <typename Key, typename Compare, typename Alloc>
+bool operator==(const FlatTree<Key, Compare, Alloc>& lhs,
+                const FlatTree<Key, Compare, Alloc>& rhs) {
+    return lhs.size() == rhs.size() &&
+           tiny_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename Key, typename Compare, typename Alloc>
+bool operator!=(const FlatTree<Key, Compare, Alloc>& lhs,
+                const FlatTree<Key, Compare, Alloc>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Key, typename Compare, typename Alloc>
+bool operator<(const FlatTree<Key, Compare, Alloc>& lhs,
+               const FlatTree<Key, Compare, Alloc>& rhs) {
+    return tiny_stl::lexicographical_compare(lhs.begin(), lhs.end(),
+                                             rhs.begin(), rhs.end());
+}
+
+template <typename Key, typename Compare, typename Alloc>
+bool operator>(const FlatTree<Key, Compare, Alloc>& lhs,
+               const FlatTree<Key, Compare, Alloc>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Key, typename Compare, typename Alloc>
+bool operator<=(const FlatTree<Key, Compare, Alloc>& lhs,
+                const FlatTree<Key, Compare, Alloc>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Key, typename Compare, typename Alloc>
+bool operator>=(const FlatTree<Key, Compare, Alloc>& lhs,
+                const FlatTree<Key, Compare, Alloc>& rhs) {
+    return !(lhs < rhs);
+}
+
+} // namespace tiny_stl
@@ -6,6 +6,21 @@
 
 #include "utility.hpp"
 
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#if !defined(TINY_STL_NO_SIMD) &&                                            \
+    (defined(__SSE4_2__) ||                                                    \
+     (defined(_MSC_VER) && defined(_M_X64) && defined(__AVX__)))
+#define TINY_STL_HAS_CRC32 1
+#include <nmmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
 namespace tiny_stl {
 
 template <typename UnaryPred>
@@ -386,6 +401,19 @@ struct less {
     }
 };
 
+// a total order even for pointers into different arrays, where the raw
+// < is unspecified
+template <typename T>
+struct less<T*> {
+    using first_argument_type = T*;
+    using second_argument_type = T*;
+    using result_type = bool;
+
+    constexpr result_type operator()(T* lhs, T* rhs) const {
+        return std::less<T*>{}(lhs, rhs);
+    }
+};
+
 template <>
 struct less<void> {
     using is_transparent = int;
@@ -478,14 +506,230 @@ inline std::size_t hashFNV(const T* p, std::size_t count) noexcept {
     return ret;
 }
 
-template <typename Key>
+namespace details {
+
+// 64x64 -> 128 bits multiplication, lo/hi are replaced by the low/high
+// 64 bits of the product
+inline void hashMultiply128(std::uint64_t& lo, std::uint64_t& hi) noexcept {
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 r = static_cast<unsigned __int128>(lo) * hi;
+    lo = static_cast<std::uint64_t>(r);
+    hi = static_cast<std::uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    lo = _umul128(lo, hi, &hi);
+#else
+    const std::uint64_t ha = lo >> 32, hb = hi >> 32;
+    const std::uint64_t la = static_cast<std::uint32_t>(lo);
+    const std::uint64_t lb = static_cast<std::uint32_t>(hi);
+    const std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la;
+    const std::uint64_t rl = la * lb, t = rl + (rm0 << 32);
+    std::uint64_t c = t < rl;
+    lo = t + (rm1 << 32);
+    c += lo < t;
+    hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+inline std::uint64_t hashMultiplyMix(std::uint64_t a,
+                                     std::uint64_t b) noexcept {
+    hashMultiply128(a, b);
+    return a ^ b;
+}
+
+inline std::uint64_t hashRead64(const unsigned char* p) noexcept {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint64_t hashRead32(const unsigned char* p) noexcept {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 1~3 bytes, first/middle/last byte
+inline std::uint64_t hashRead3(const unsigned char* p,
+                               std::size_t n) noexcept {
+    return (static_cast<std::uint64_t>(p[0]) << 16) |
+           (static_cast<std::uint64_t>(p[n >> 1]) << 8) | p[n - 1];
+}
+
+// multiply-xorshift, for integers and pointers
+inline std::size_t hashInteger(std::uint64_t x) noexcept {
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ULL;
+    x ^= x >> 32;
+    return static_cast<std::size_t>(x);
+}
+
+// wyhash (final version 4), reads 8 bytes per step and 48 bytes per loop
+// in 3 independent lanes
+inline std::uint64_t hashWy(const void* key, std::size_t len,
+                            std::uint64_t seed) noexcept {
+    constexpr std::uint64_t s0 = 0x2d358dccaa6c78a5ULL;
+    constexpr std::uint64_t s1 = 0x8bb84b93962eacc9ULL;
+    constexpr std::uint64_t s2 = 0x4b33a62ed433d4a3ULL;
+    constexpr std::uint64_t s3 = 0x4d5a2da51de1aa47ULL;
+
+    const unsigned char* p = static_cast<const unsigned char*>(key);
+    seed ^= hashMultiplyMix(seed ^ s0, s1);
+    std::uint64_t a = 0;
+    std::uint64_t b = 0;
+    if (len <= 16) {
+        if (len >= 4) {
+            const std::size_t off = (len >> 3) << 2;
+            a = (hashRead32(p) << 32) | hashRead32(p + off);
+            b = (hashRead32(p + len - 4) << 32) |
+                hashRead32(p + len - 4 - off);
+        } else if (len > 0) {
+            a = hashRead3(p, len);
+        }
+    } else {
+        std::size_t i = len;
+        if (i > 48) {
+            std::uint64_t see1 = seed;
+            std::uint64_t see2 = seed;
+            do {
+                seed = hashMultiplyMix(hashRead64(p) ^ s1,
+                                       hashRead64(p + 8) ^ seed);
+                see1 = hashMultiplyMix(hashRead64(p + 16) ^ s2,
+                                       hashRead64(p + 24) ^ see1);
+                see2 = hashMultiplyMix(hashRead64(p + 32) ^ s3,
+                                       hashRead64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+
+        while (i > 16) {
+            seed = hashMultiplyMix(hashRead64(p) ^ s1,
+                                   hashRead64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+
+        // the last 16 bytes, may overlap with the previous step
+        a = hashRead64(p + i - 16);
+        b = hashRead64(p + i - 8);
+    }
+
+    a ^= s1;
+    b ^= seed;
+    hashMultiply128(a, b);
+    return hashMultiplyMix(a ^ s0 ^ len, b ^ s1);
+}
+
+#ifdef TINY_STL_HAS_CRC32
+// two hardware crc32c lanes over 16 bytes per step, crc32 alone has poor
+// high bits, so finish with the integer mixer
+inline std::uint64_t hashCrc32(const void* key, std::size_t len) noexcept {
+    const unsigned char* p = static_cast<const unsigned char*>(key);
+    std::uint64_t c0 = 0xffffffffULL;
+    std::uint64_t c1 = len;
+    std::size_t i = len;
+    for (; i >= 16; i -= 16, p += 16) {
+        c0 = _mm_crc32_u64(c0, hashRead64(p));
+        c1 = _mm_crc32_u64(c1, hashRead64(p + 8));
+    }
+
+    if (i >= 8) {
+        c0 = _mm_crc32_u64(c0, hashRead64(p));
+        p += 8;
+        i -= 8;
+    }
+
+    if (i >= 4) {
+        c1 = _mm_crc32_u32(static_cast<std::uint32_t>(c1),
+                           static_cast<std::uint32_t>(hashRead32(p)));
+        p += 4;
+        i -= 4;
+    }
+
+    for (; i > 0; --i, ++p)
+        c0 = _mm_crc32_u8(static_cast<std::uint32_t>(c0), *p);
+
+    return hashInteger((c0 << 32) | c1);
+}
+#endif // TINY_STL_HAS_CRC32
+
+} // namespace details
+
+// Byte hashing policies of hash<Key, Policy>, a policy provides
+//   static std::size_t hash_bytes(const void* p, std::size_t n) noexcept;
+// integers and pointers are always hashed by a multiply-xorshift mixer
+
+struct wyhash_policy {
+    static std::size_t hash_bytes(const void* p, std::size_t n) noexcept {
+        return static_cast<std::size_t>(details::hashWy(p, n, 0));
+    }
+};
+
+struct fnv1a_hash_policy {
+    static std::size_t hash_bytes(const void* p, std::size_t n) noexcept {
+        return hashFNV(static_cast<const unsigned char*>(p), n);
+    }
+};
+
+#ifdef TINY_STL_HAS_CRC32
+struct crc32_hash_policy {
+    static std::size_t hash_bytes(const void* p, std::size_t n) noexcept {
+        return static_cast<std::size_t>(details::hashCrc32(p, n));
+    }
+};
+#endif // TINY_STL_HAS_CRC32
+
+using default_hash_policy = wyhash_policy;
+
+namespace details {
+
+template <typename T>
+inline std::uint64_t hashToInteger(T val) noexcept {
+    return static_cast<std::uint64_t>(val);
+}
+
+template <typename T>
+inline std::uint64_t hashToInteger(T* ptr) noexcept {
+    return reinterpret_cast<std::uintptr_t>(ptr);
+}
+
+// integers, enums and pointers
+template <typename Key, typename Policy>
+inline std::size_t hashKey(const Key& key, true_type) noexcept {
+    return hashInteger(hashToInteger(key));
+}
+
+// floating point, +0.0 and -0.0 compare equal
+template <typename Key, typename Policy>
+inline std::size_t hashBytes(const Key& key, true_type) noexcept {
+    if (key == Key{})
+        return hashInteger(0);
+    return Policy::hash_bytes(&key, sizeof(Key));
+}
+
+template <typename Key, typename Policy>
+inline std::size_t hashBytes(const Key& key, false_type) noexcept {
+    return Policy::hash_bytes(&key, sizeof(Key));
+}
+
+template <typename Key, typename Policy>
+inline std::size_t hashKey(const Key& key, false_type) noexcept {
+    return hashBytes<Key, Policy>(key, is_floating_point<Key>{});
+}
+
+} // namespace details
+
+template <typename Key, typename Policy = default_hash_policy>
 struct hash {
     using argument_type = Key;
     using result_type = std::size_t;
 
     std::size_t operator()(const Key& key) const noexcept {
-        return hashFNV(&reinterpret_cast<const unsigned char&>(key),
-                       sizeof(Key));
+        using IsInteger =
+            bool_constant<is_integral<Key>::value || is_enum<Key>::value ||
+                          is_pointer<Key>::value>;
+        return details::hashKey<Key, Policy>(key, IsInteger{});
     }
 };
 
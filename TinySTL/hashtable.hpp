@@ -4,16 +4,70 @@
 
 #pragma once
 
+#include <cstdint>
+
+#if !defined(TINY_STL_NO_SIMD) &&                                            \
+    (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TINY_STL_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 #include "array.hpp"
 #include "forward_list.hpp"
 #include "vector.hpp"
 
 namespace tiny_stl {
 
-template <typename T, typename HashTableType>
+namespace details {
+
+// bucket node of HashTable in cache hash mode, the full hash value is
+// stored next to the value
+template <typename T>
+struct HashCachedNode {
+    T value;
+    std::size_t hash;
+
+    // forward_list constructs a value in its head node
+    HashCachedNode() : value(), hash(0) {
+    }
+
+    template <typename V>
+    HashCachedNode(std::size_t h, V&& val)
+        : value(tiny_stl::forward<V>(val)), hash(h) {
+    }
+};
+
+template <typename T>
+inline T& hashNodeValue(T& node) noexcept {
+    return node;
+}
+
+template <typename T>
+inline const T& hashNodeValue(const T& node) noexcept {
+    return node;
+}
+
+template <typename T>
+inline T& hashNodeValue(HashCachedNode<T>& node) noexcept {
+    return node.value;
+}
+
+template <typename T>
+inline const T& hashNodeValue(const HashCachedNode<T>& node) noexcept {
+    return node.value;
+}
+
+} // namespace details
+
+template <typename T, typename HashTableType, typename Node = T>
 struct HashIterator;
 
-template <typename T, typename HashTableType>
+template <typename T, typename HashTableType, typename Node = T>
 struct HashConstIterator {
     using iterator_category = forward_iterator_tag;
     using value_type = T;
@@ -22,24 +76,25 @@ struct HashConstIterator {
     using pointer = const T*;
 
     std::size_t idx_bucket;
-    FListConstIterator<T> iter;
+    FListConstIterator<Node> iter;
     HashTableType* hashtable;
 
     HashConstIterator() = default;
-    HashConstIterator(std::size_t idx, FListConstIterator<T> it,
+    HashConstIterator(std::size_t idx, FListConstIterator<Node> it,
                       HashTableType* ht)
         : idx_bucket(idx), iter(it), hashtable(ht) {
     }
 
     HashConstIterator(const HashConstIterator&) = default;
 
-    HashConstIterator(const HashIterator<T, remove_const_t<HashTableType>>& rhs)
+    HashConstIterator(
+        const HashIterator<T, remove_const_t<HashTableType>, Node>& rhs)
         : idx_bucket(rhs.idx_bucket), iter(rhs.iter.ptr),
           hashtable(static_cast<HashTableType*>(rhs.hashtable)) {
     }
 
     reference operator*() const {
-        return *iter;
+        return details::hashNodeValue<T>(*iter);
     }
 
     pointer operator->() const {
@@ -82,7 +137,7 @@ struct HashConstIterator {
     }
 };
 
-template <typename T, typename HashTableType>
+template <typename T, typename HashTableType, typename Node>
 struct HashIterator {
     using iterator_category = forward_iterator_tag;
     using value_type = T;
@@ -91,16 +146,16 @@ struct HashIterator {
     using pointer = T*;
 
     std::size_t idx_bucket;
-    FListIterator<T> iter;
+    FListIterator<Node> iter;
     HashTableType* hashtable;
 
     HashIterator() = default;
-    HashIterator(std::size_t idx, FListIterator<T> it, HashTableType* ht)
+    HashIterator(std::size_t idx, FListIterator<Node> it, HashTableType* ht)
         : idx_bucket(idx), iter(it), hashtable(ht) {
     }
 
     reference operator*() const {
-        return *iter;
+        return details::hashNodeValue<T>(*iter);
     }
 
     pointer operator->() const {
@@ -142,6 +197,56 @@ struct HashIterator {
     }
 };
 
+// local iterator of cache hash mode, hides the cached hash of nodes
+template <typename T, typename ListIter>
+struct HashCachedLocalIterator {
+    using iterator_category = forward_iterator_tag;
+    using value_type = remove_const_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using pointer = T*;
+
+    ListIter iter;
+
+    HashCachedLocalIterator() = default;
+    explicit HashCachedLocalIterator(ListIter it) : iter(it) {
+    }
+
+    // local_iterator -> const_local_iterator
+    template <typename U, typename I,
+              typename = enable_if_t<is_convertible<I, ListIter>::value>>
+    HashCachedLocalIterator(const HashCachedLocalIterator<U, I>& rhs)
+        : iter(rhs.iter) {
+    }
+
+    reference operator*() const {
+        return details::hashNodeValue<value_type>(*iter);
+    }
+
+    pointer operator->() const {
+        return pointer_traits<pointer>::pointer_to(**this);
+    }
+
+    HashCachedLocalIterator& operator++() {
+        ++iter;
+        return *this;
+    }
+
+    HashCachedLocalIterator operator++(int) {
+        HashCachedLocalIterator tmp = *this;
+        ++iter;
+        return tmp;
+    }
+
+    bool operator==(const HashCachedLocalIterator& rhs) const {
+        return iter == rhs.iter;
+    }
+
+    bool operator!=(const HashCachedLocalIterator& rhs) const {
+        return iter != rhs.iter;
+    }
+};
+
 namespace details {
 
 constexpr tiny_stl::array<std::size_t, 28> stlPrimes() {
@@ -161,14 +266,100 @@ inline std::size_t stlNextPrime(std::size_t n) {
 
     return (pos == pend) ? primes.back() : *pos;
 }
+
+inline unsigned countTrailingZeros(std::uint64_t x) noexcept {
+    assert(x != 0);
+#if defined(_MSC_VER) && defined(_WIN64)
+    unsigned long idx;
+    _BitScanForward64(&idx, x);
+    return static_cast<unsigned>(idx);
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    if (_BitScanForward(&idx, static_cast<unsigned long>(x)))
+        return static_cast<unsigned>(idx);
+    _BitScanForward(&idx, static_cast<unsigned long>(x >> 32));
+    return static_cast<unsigned>(idx) + 32;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+// fibonacci hashing, the high log2(count) bits of hash * 2^64 / phi.
+// count must be a power of 2
+inline std::size_t fibonacciIndex(std::size_t hash,
+                                  std::size_t count) noexcept {
+    const std::uint64_t product =
+        static_cast<std::uint64_t>(hash) * 0x9e3779b97f4a7c15ULL;
+    return static_cast<std::size_t>(product >>
+                                    (64 - countTrailingZeros(count)));
+}
+
+// Hash and KeyEqual both define is_transparent, K only makes the check
+// dependent on the member template
+template <typename Hash, typename KeyEqual, typename K, typename = void>
+struct IsTransparentHash : false_type {};
+
+template <typename Hash, typename KeyEqual, typename K>
+struct IsTransparentHash<Hash, KeyEqual, K,
+                         void_t<typename Hash::is_transparent,
+                                typename KeyEqual::is_transparent>>
+    : true_type {};
+
+template <typename Hash, typename KeyEqual, typename K>
+using EnableIfTransparentHash =
+    enable_if_t<IsTransparentHash<Hash, KeyEqual, K>::value>;
+
 } // namespace details
 
+// BucketPolicy of HashTable
+// bucket_count(n):         the bucket count used for at least n buckets
+// bucket_index(hash, cnt): the bucket of hash value
+// max_bucket_count():      the max bucket count
+
+// bucket count is a prime, index = hash % count
+struct prime_bucket_policy {
+    static std::size_t bucket_count(std::size_t n) noexcept {
+        return details::stlNextPrime(n);
+    }
+
+    static std::size_t bucket_index(std::size_t hash,
+                                    std::size_t count) noexcept {
+        return hash % count;
+    }
+
+    static std::size_t max_bucket_count() noexcept {
+        return details::stlPrimes().back();
+    }
+};
+
+// bucket count is a power of 2, index = fibonacci hashing of hash,
+// a multiplication and a shift instead of integer division
+struct power2_bucket_policy {
+    static std::size_t bucket_count(std::size_t n) noexcept {
+        std::size_t count = 16;
+        while (count < n && count < max_bucket_count())
+            count <<= 1;
+
+        return count;
+    }
+
+    static std::size_t bucket_index(std::size_t hash,
+                                    std::size_t count) noexcept {
+        return details::fibonacciIndex(hash, count);
+    }
+
+    static std::size_t max_bucket_count() noexcept {
+        return (static_cast<std::size_t>(-1) >> 1) + 1;
+    }
+};
+
+// cacheHash: store the full hash value in every node, rehash reuses it
+// and lookups compare it before calling KeyEqual. It costs one size_t per
+// element and pays off for keys that are expensive to hash or compare
 template <typename T, typename Hash, typename KeyEqual, typename Alloc,
-          bool isMap>
+          bool isMap, typename BucketPolicy = power2_bucket_policy,
+          bool cacheHash = false>
 class HashTable {
-    friend HashConstIterator<T, const HashTable>;
-    friend HashIterator<T, HashTable>;
-
 public:
     using key_type = typename AssociatedTypeHelper<T, isMap>::key_type;
     using mapped_type = typename AssociatedTypeHelper<T, isMap>::mapped_type;
@@ -181,20 +372,33 @@ public:
     using reference = value_type&;
     using const_reference = const value_type&;
     using AlTraits = allocator_traits<Alloc>;
-    using List = forward_list<T>;
+    using Node = conditional_t<cacheHash, details::HashCachedNode<T>, T>;
+    using List =
+        forward_list<Node, typename AlTraits::template rebind_alloc<Node>>;
     using pointer = typename AlTraits::pointer;
     using const_pointer = typename AlTraits::const_pointer;
 
-    using iterator = HashIterator<T, HashTable>;
-    using const_iterator = HashConstIterator<T, const HashTable>;
+    using iterator = HashIterator<T, HashTable, Node>;
+    using const_iterator = HashConstIterator<T, const HashTable, Node>;
+
+    using local_iterator =
+        conditional_t<cacheHash,
+                      HashCachedLocalIterator<T, typename List::iterator>,
+                      typename List::iterator>;
+    using const_local_iterator = conditional_t<
+        cacheHash,
+        HashCachedLocalIterator<const T, typename List::const_iterator>,
+        typename List::const_iterator>;
 
-    using local_iterator = typename forward_list<T>::iterator;
-    using const_local_iterator = typename forward_list<T>::const_iterator;
+    using AlFlist =
+        typename allocator_traits<Alloc>::template rebind_alloc<List>;
+    using Bucket = vector<List, AlFlist>;
+    using bucket_policy = BucketPolicy;
+    using Self =
+        HashTable<T, Hash, KeyEqual, Alloc, isMap, BucketPolicy, cacheHash>;
 
-    using AlFlist = typename allocator_traits<Alloc>::template rebind_alloc<
-        forward_list<T>>;
-    using Bucket = vector<forward_list<T>, AlFlist>;
-    using Self = HashTable<T, Hash, KeyEqual, Alloc, isMap>;
+    friend const_iterator;
+    friend iterator;
 
 public:
     Bucket buckets;
@@ -218,18 +422,76 @@ private:
         return getKey(val, tiny_stl::bool_constant<isMap>{});
     }
 
-    size_type getNthBucket(const T& val) const {
-        return hashfunc(get_key(val)) % buckets.size();
+    const key_type& nodeKey(const Node& node) const {
+        return get_key(details::hashNodeValue<T>(node));
+    }
+
+    size_type bucketIndex(std::size_t hash) const {
+        return BucketPolicy::bucket_index(hash, buckets.size());
+    }
+
+    template <typename K>
+    size_type getNthBucketK(const K& key) const {
+        return bucketIndex(hashfunc(key));
+    }
+
+    std::size_t nodeHash(const Node& node, true_type) const {
+        return node.hash;
+    }
+
+    std::size_t nodeHash(const Node& node, false_type) const {
+        return hashfunc(nodeKey(node));
+    }
+
+    std::size_t nodeHash(const Node& node) const {
+        return nodeHash(node, bool_constant<cacheHash>{});
+    }
+
+    // the cached hash rejects most of unequal keys without key_equ
+    template <typename K>
+    bool nodeEqual(const Node& node, const K& key, std::size_t hash,
+                   true_type) const {
+        return node.hash == hash && key_equ(nodeKey(node), key);
+    }
+
+    template <typename K>
+    bool nodeEqual(const Node& node, const K& key, std::size_t,
+                   false_type) const {
+        return key_equ(nodeKey(node), key);
+    }
+
+    template <typename K>
+    bool nodeEqual(const Node& node, const K& key, std::size_t hash) const {
+        return nodeEqual(node, key, hash, bool_constant<cacheHash>{});
     }
 
-    size_type getNthBucketK(const key_type& key) const {
-        return hashfunc(key) % buckets.size();
+    template <typename Value>
+    typename List::iterator
+    emplaceNode(size_type idx, typename List::const_iterator pos,
+                std::size_t hash, Value&& val, true_type) {
+        return buckets[idx].emplace_after(pos, hash,
+                                          tiny_stl::forward<Value>(val));
+    }
+
+    template <typename Value>
+    typename List::iterator
+    emplaceNode(size_type idx, typename List::const_iterator pos, std::size_t,
+                Value&& val, false_type) {
+        return buckets[idx].emplace_after(pos, tiny_stl::forward<Value>(val));
+    }
+
+    template <typename Value>
+    typename List::iterator emplaceNode(size_type idx,
+                                        typename List::const_iterator pos,
+                                        std::size_t hash, Value&& val) {
+        return emplaceNode(idx, pos, hash, tiny_stl::forward<Value>(val),
+                           bool_constant<cacheHash>{});
     }
 
     void init(size_type n) {
-        const size_type num_bucket = details::stlNextPrime(n);
+        const size_type num_bucket = BucketPolicy::bucket_count(n);
         buckets.reserve(num_bucket);
-        buckets.assign(num_bucket, List{});
+        buckets.assign(num_bucket, List(buckets.get_allocator()));
         maxfactor = 1.0f;
         num_elements = 0;
     }
@@ -238,7 +500,8 @@ private:
         buckets = rhs.buckets;
     }
 
-    size_type updateNextIter(const_local_iterator& iter, size_type idx) const {
+    size_type updateNextIter(typename List::const_iterator& iter,
+                             size_type idx) const {
         size_type iterIdx = idx;
         if (iter == buckets[iterIdx].end()) {
             for (;;) {
@@ -258,7 +521,7 @@ private:
         return iterIdx;
     }
 
-    size_type updateNextIter(local_iterator& iter, size_type idx) {
+    size_type updateNextIter(typename List::iterator& iter, size_type idx) {
         return static_cast<const Self&>(*this).updateNextIter(iter, idx);
     }
 
@@ -311,7 +574,7 @@ public:
     ~HashTable() noexcept = default;
 
     allocator_type get_allocator() const {
-        return allocator_type{};
+        return static_cast<allocator_type>(buckets.get_allocator());
     }
 
     iterator begin() noexcept {
@@ -323,7 +586,7 @@ public:
         if (idx == buckets.size())
             return end();
 
-        return iterator(idx, begin(idx), this);
+        return iterator(idx, buckets[idx].begin(), this);
     }
 
     const_iterator begin() const noexcept {
@@ -335,7 +598,7 @@ public:
         if (idx == buckets.size())
             return end();
 
-        return const_iterator(idx, begin(idx), this);
+        return const_iterator(idx, buckets[idx].begin(), this);
     }
 
     const_iterator cbegin() const noexcept {
@@ -376,49 +639,55 @@ private:
     template <typename Value>
     iterator insertEqualAux(Value&& val) {
         if (load_factor() > max_load_factor())
-            rehash(details::stlNextPrime(size()));
+            rehash(BucketPolicy::bucket_count(size() + 1));
 
         ++num_elements;
 
-        size_type idx = getNthBucket(val);
+        const std::size_t hash = hashfunc(get_key(val));
+        size_type idx = bucketIndex(hash);
 
-        for (auto cpos = cbegin(idx); cpos != cend(idx); ++cpos) {
-            if (key_equ(get_key(val), get_key(*cpos))) { // existing
-                auto pos = buckets[idx].insert_after(
-                    cpos, tiny_stl::forward<Value>(val));
+        for (auto cpos = buckets[idx].cbegin(); cpos != buckets[idx].cend();
+             ++cpos) {
+            if (nodeEqual(*cpos, get_key(val), hash)) { // existing
+                auto pos =
+                    emplaceNode(idx, cpos, hash, tiny_stl::forward<Value>(val));
 
                 return iterator(idx, pos, this);
             }
         }
 
         // not exist
-        auto pos = buckets[idx].insert_after(buckets[idx].before_begin(),
-                                             tiny_stl::forward<Value>(val));
+        auto pos = emplaceNode(idx, buckets[idx].cbefore_begin(), hash,
+                               tiny_stl::forward<Value>(val));
         return iterator(idx, pos, this);
     }
 
     template <typename Value>
     pair<iterator, bool> insertUniqueAux(Value&& val) {
-        size_type idx = getNthBucket(val);
+        const std::size_t hash = hashfunc(get_key(val));
+        size_type idx = bucketIndex(hash);
 
-        for (auto cpos = cbegin(idx); cpos != cend(idx); ++cpos) {
-            if (key_equ(get_key(val), get_key(*cpos))) { // existing
-                return make_pair(
+        for (auto cpos = buckets[idx].cbegin(); cpos != buckets[idx].cend();
+             ++cpos) {
+            if (nodeEqual(*cpos, get_key(val), hash)) { // existing
+                return tiny_stl::make_pair(
                     iterator(idx, buckets[idx].makeIter(cpos), this), false);
             }
         }
 
-        // not exist
-        ++num_elements;
-        if (load_factor() > max_load_factor()) {
-            rehash(details::stlNextPrime(size()));
-            idx = getNthBucket(val);
+        // not exist, rehash before counting the new element,
+        // rehash rebuilds num_elements
+        if (static_cast<float>(size() + 1) >
+            max_load_factor() * static_cast<float>(bucket_count())) {
+            rehash(BucketPolicy::bucket_count(size() + 1));
+            idx = bucketIndex(hash);
         }
+        ++num_elements;
 
-        auto pos = buckets[idx].insert_after(buckets[idx].before_begin(),
-                                             tiny_stl::forward<Value>(val));
+        auto pos = emplaceNode(idx, buckets[idx].cbefore_begin(), hash,
+                               tiny_stl::forward<Value>(val));
 
-        return make_pair(iterator(idx, pos, this), true);
+        return tiny_stl::make_pair(iterator(idx, pos, this), true);
     }
 
 protected:
@@ -462,13 +731,15 @@ protected:
         return insertUniqueAux(tiny_stl::move(val));
     }
 
-    size_type count_equal(const key_type& key) const {
-        auto range = equal_range(key);
-        return distance(range.first, range.second);
+    template <typename K>
+    size_type count_equal(const K& key) const {
+        auto range = equalRangeAux(key);
+        return tiny_stl::distance(range.first, range.second);
     }
 
-    size_type count_unique(const key_type& key) const {
-        auto iter = find(key);
+    template <typename K>
+    size_type count_unique(const K& key) const {
+        auto iter = findAux(key);
         return iter == end() ? 0 : 1;
     }
 
@@ -477,7 +748,7 @@ public:
         assert(pos != cend());
         --num_elements;
 
-        size_type idx = getNthBucket(*pos);
+        size_type idx = pos.idx_bucket;
         auto prev = buckets[idx].cbefore_begin(); // pos prev
         auto next = prev;
         // find pos prev
@@ -487,7 +758,7 @@ public:
 
         auto iter = buckets[idx].erase_after(prev); // erase pos
 
-        updateNextIter(iter, idx);
+        idx = updateNextIter(iter, idx);
 
         return iterator(idx, iter, this);
     }
@@ -506,14 +777,30 @@ public:
     }
 
     size_type erase(const key_type& key) {
-        auto range = static_cast<const Self*>(this)->equal_range(key);
-        size_type num = distance(range.first, range.second);
+        return eraseKey(key);
+    }
+
+    // iterators are not keys
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>,
+              typename = enable_if_t<!is_convertible<K, iterator>::value &&
+                                     !is_convertible<K, const_iterator>::value>>
+    size_type erase(K&& key) {
+        return eraseKey(key);
+    }
+
+private:
+    template <typename K>
+    size_type eraseKey(const K& key) {
+        auto range = static_cast<const Self*>(this)->equalRangeAux(key);
+        size_type num = tiny_stl::distance(range.first, range.second);
 
         erase(range.first, range.second);
 
         return num;
     }
 
+public:
     void swap(HashTable& rhs) {
         swapADL(hashfunc, rhs.hashfunc);
         swapADL(key_equ, rhs.key_equ);
@@ -522,87 +809,148 @@ public:
         buckets.swap(rhs.buckets);
     }
 
-public:
-    iterator find(const key_type& key) {
-        size_type idx = getNthBucketK(key);
-        for (auto pos = begin(idx); pos != end(idx); ++pos) {
-            if (key_equ(get_key(*pos), key))
+private:
+    template <typename K>
+    iterator findAux(const K& key) {
+        const std::size_t hash = hashfunc(key);
+        size_type idx = bucketIndex(hash);
+        for (auto pos = buckets[idx].begin(); pos != buckets[idx].end();
+             ++pos) {
+            if (nodeEqual(*pos, key, hash))
                 return iterator(idx, pos, this);
         }
 
         return end();
     }
 
-    const_iterator find(const key_type& key) const {
-        size_type idx = getNthBucketK(key);
-        for (auto pos = begin(idx); pos != end(idx); ++pos) {
-            if (key_equ(*pos, key))
+    template <typename K>
+    const_iterator findAux(const K& key) const {
+        const std::size_t hash = hashfunc(key);
+        size_type idx = bucketIndex(hash);
+        for (auto pos = buckets[idx].begin(); pos != buckets[idx].end();
+             ++pos) {
+            if (nodeEqual(*pos, key, hash))
                 return const_iterator(idx, pos, this);
         }
 
         return end();
     }
 
-    pair<iterator, iterator> equal_range(const key_type& key) {
-        size_type idx = getNthBucketK(key);
+    template <typename K>
+    pair<iterator, iterator> equalRangeAux(const K& key) {
+        const std::size_t hash = hashfunc(key);
+        size_type idx = bucketIndex(hash);
 
-        auto first = begin(idx);
-        for (; first != end(idx); ++first) {
-            if (key_equ(*first, key)) // find first
+        auto first = buckets[idx].begin();
+        for (; first != buckets[idx].end(); ++first) {
+            if (nodeEqual(*first, key, hash)) // find first
                 break;
         }
 
-        if (first == end(idx))
-            return make_pair(end(), end());
+        if (first == buckets[idx].end())
+            return tiny_stl::make_pair(end(), end());
 
         auto last = first;
 
-        for (++last; last != end(idx); ++last) {
-            if (!key_equ(*last, key)) // find last
+        for (++last; last != buckets[idx].end(); ++last) {
+            if (!nodeEqual(*last, key, hash)) // find last
                 break;
         }
 
         size_type lastIdx = updateNextIter(last, idx);
 
-        return make_pair(iterator(idx, first, this),
-                         iterator(lastIdx, last, this));
+        return tiny_stl::make_pair(iterator(idx, first, this),
+                                   iterator(lastIdx, last, this));
     }
 
-    pair<const_iterator, const_iterator>
-    equal_range(const key_type& key) const {
-        size_type idx = getNthBucketK(key);
+    template <typename K>
+    pair<const_iterator, const_iterator> equalRangeAux(const K& key) const {
+        const std::size_t hash = hashfunc(key);
+        size_type idx = bucketIndex(hash);
 
-        auto first = begin(idx);
-        for (; first != end(idx); ++first) {
-            if (key_equ(*first, key)) // find first
+        auto first = buckets[idx].begin();
+        for (; first != buckets[idx].end(); ++first) {
+            if (nodeEqual(*first, key, hash)) // find first
                 break;
         }
 
-        if (first == end(idx))
-            return make_pair(end(), end());
+        if (first == buckets[idx].end())
+            return tiny_stl::make_pair(end(), end());
 
         auto last = first;
 
-        for (++last; last != end(idx); ++last) {
-            if (!key_equ(*last, key)) // find last
+        for (++last; last != buckets[idx].end(); ++last) {
+            if (!nodeEqual(*last, key, hash)) // find last
                 break;
         }
 
         size_type lastIdx = updateNextIter(last, idx);
 
-        return make_pair(const_iterator(idx, first, this),
-                         const_iterator(lastIdx, last, this));
+        return tiny_stl::make_pair(const_iterator(idx, first, this),
+                                   const_iterator(lastIdx, last, this));
+    }
+
+public:
+    iterator find(const key_type& key) {
+        return findAux(key);
+    }
+
+    const_iterator find(const key_type& key) const {
+        return findAux(key);
+    }
+
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    iterator find(const K& key) {
+        return findAux(key);
+    }
+
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    const_iterator find(const K& key) const {
+        return findAux(key);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key) {
+        return equalRangeAux(key);
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type& key) const {
+        return equalRangeAux(key);
+    }
+
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    pair<iterator, iterator> equal_range(const K& key) {
+        return equalRangeAux(key);
+    }
+
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const {
+        return equalRangeAux(key);
+    }
+
+    bool contains(const key_type& key) const {
+        return find(key) != end();
+    }
+
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    bool contains(const K& key) const {
+        return find(key) != end();
     }
 
 public:
     local_iterator begin(size_type n) {
         assert(n < buckets.size());
-        return buckets[n].begin();
+        return local_iterator(buckets[n].begin());
     }
 
     const_local_iterator begin(size_type n) const {
         assert(n < buckets.size());
-        return buckets[n].begin();
+        return const_local_iterator(buckets[n].begin());
     }
 
     const_local_iterator cbegin(size_type n) const {
@@ -611,12 +959,12 @@ public:
 
     local_iterator end(size_type n) {
         assert(n < buckets.size());
-        return buckets[n].end();
+        return local_iterator(buckets[n].end());
     }
 
     const_local_iterator end(size_type n) const {
         assert(n < buckets.size());
-        return buckets[n].end();
+        return const_local_iterator(buckets[n].end());
     }
 
     const_local_iterator cend(size_type n) const {
@@ -628,8 +976,7 @@ public:
     }
 
     size_type max_bucket_count() const noexcept {
-        std::size_t size = details::stlPrimes().size();
-        return details::stlPrimes().back() >> 2;
+        return BucketPolicy::max_bucket_count();
     }
 
     size_type bucket_size(size_type n) const {
@@ -660,9 +1007,22 @@ public:
     void rehash(size_type n) {
         if (n <= size() / max_load_factor())
             return;
-        HashTable tmp(details::stlNextPrime(n));
-        for (const auto& val : *this)
-            tmp.insert_equal(val);
+        HashTable tmp(BucketPolicy::bucket_count(n), get_allocator(), hashfunc,
+                      key_equ);
+        // relink the nodes instead of copying them, an element goes to the
+        // front of its new bucket, so adjacent equal keys stay adjacent
+        for (auto& bucket : buckets) {
+            while (!bucket.empty()) {
+                const std::size_t hash = nodeHash(bucket.front());
+                List& dst = tmp.buckets[tmp.bucketIndex(hash)];
+                dst.splice_after(dst.cbefore_begin(), bucket,
+                                 bucket.cbefore_begin());
+            }
+        }
+
+        tmp.num_elements = num_elements;
+        tmp.maxfactor = maxfactor;
+        num_elements = 0;
         this->swap(tmp);
     }
 
@@ -680,25 +1040,947 @@ public:
 }; // HashTable
 
 template <typename T, typename Hash, typename KeyEqual, typename Alloc,
-          bool isMap>
-inline bool operator==(const HashTable<T, Hash, KeyEqual, Alloc, isMap>& lhs,
-                       const HashTable<T, Hash, KeyEqual, Alloc, isMap>& rhs) {
+          bool isMap, typename BucketPolicy, bool cacheHash>
+inline bool operator==(
+    const HashTable<T, Hash, KeyEqual, Alloc, isMap, BucketPolicy, cacheHash>&
+        lhs,
+    const HashTable<T, Hash, KeyEqual, Alloc, isMap, BucketPolicy, cacheHash>&
+        rhs) {
     return lhs.size() == rhs.size() &&
            equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
 template <typename T, typename Hash, typename KeyEqual, typename Alloc,
-          bool isMap>
-inline bool operator!=(const HashTable<T, Hash, KeyEqual, Alloc, isMap>& lhs,
-                       const HashTable<T, Hash, KeyEqual, Alloc, isMap>& rhs) {
+          bool isMap, typename BucketPolicy, bool cacheHash>
+inline bool operator!=(
+    const HashTable<T, Hash, KeyEqual, Alloc, isMap, BucketPolicy, cacheHash>&
+        lhs,
+    const HashTable<T, Hash, KeyEqual, Alloc, isMap, BucketPolicy, cacheHash>&
+        rhs) {
     return !(lhs == rhs);
 }
 
 template <typename T, typename Hash, typename KeyEqual, typename Alloc,
-          bool isMap>
-inline bool operator==(HashTable<T, Hash, KeyEqual, Alloc, isMap>& lhs,
-                       HashTable<T, Hash, KeyEqual, Alloc, isMap>& rhs) {
-    return lhs.swap(rhs);
+          bool isMap, typename BucketPolicy, bool cacheHash>
+inline void
+swap(HashTable<T, Hash, KeyEqual, Alloc, isMap, BucketPolicy, cacheHash>& lhs,
+     HashTable<T, Hash, KeyEqual, Alloc, isMap, BucketPolicy, cacheHash>& rhs) {
+    lhs.swap(rhs);
+}
+
+namespace details {
+
+// control byte of FlatHashTable slot
+// empty:    0b10000000
+// deleted:  0b11111110
+// sentinel: 0b11111111, one past the last slot, stops iterator
+// full:     0b0xxxxxxx, low 7 bits of hash value (H2)
+using FlatCtrl = signed char;
+
+constexpr FlatCtrl flatEmpty = -128;
+constexpr FlatCtrl flatDeleted = -2;
+constexpr FlatCtrl flatSentinel = -1;
+
+// probe a group of control bytes at once, the capacity is a multiple of it
+constexpr std::size_t flatGroupWidth = 16;
+constexpr std::size_t flatMinCapacity = flatGroupWidth;
+
+inline bool flatIsFull(FlatCtrl c) noexcept {
+    return c >= 0;
+}
+
+inline bool flatIsEmptyOrDeleted(FlatCtrl c) noexcept {
+    return c < flatSentinel;
+}
+
+// high bits select the probe start, low 7 bits are stored in control byte
+inline std::size_t flatH1(std::size_t hash) noexcept {
+    return hash >> 7;
+}
+
+inline FlatCtrl flatH2(std::size_t hash) noexcept {
+    return static_cast<FlatCtrl>(hash & 0x7f);
+}
+
+// map
+template <typename T>
+inline const typename T::first_type& flatKeyOf(const T& val, true_type) {
+    return val.first;
+}
+
+// set
+template <typename T>
+inline const T& flatKeyOf(const T& val, false_type) {
+    return val;
+}
+
+// control bytes shared by all tables without slots
+inline FlatCtrl* flatEmptyCtrl() noexcept {
+    static FlatCtrl ctrl[1] = {flatSentinel};
+    return ctrl;
+}
+
+inline std::uint32_t flatLowestBit(std::uint32_t mask) noexcept {
+    return countTrailingZeros(mask);
+}
+
+#ifdef TINY_STL_HAS_SSE2
+
+// bit i of the result is set if the ith control byte matches
+struct FlatGroup {
+    __m128i ctrl;
+
+    explicit FlatGroup(const FlatCtrl* pos)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {
+    }
+
+    std::uint32_t match(FlatCtrl h2) const {
+        const __m128i target = _mm_set1_epi8(h2);
+        return static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(target, ctrl)));
+    }
+
+    std::uint32_t matchEmpty() const {
+        return match(flatEmpty);
+    }
+
+    // empty and deleted are less than sentinel
+    std::uint32_t matchEmptyOrDeleted() const {
+        const __m128i sentinel = _mm_set1_epi8(flatSentinel);
+        return static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpgt_epi8(sentinel, ctrl)));
+    }
+};
+
+#else // !TINY_STL_HAS_SSE2
+
+struct FlatGroup {
+    const FlatCtrl* ctrl;
+
+    explicit FlatGroup(const FlatCtrl* pos) : ctrl(pos) {
+    }
+
+    std::uint32_t match(FlatCtrl h2) const {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < flatGroupWidth; ++i)
+            mask |= static_cast<std::uint32_t>(ctrl[i] == h2) << i;
+
+        return mask;
+    }
+
+    std::uint32_t matchEmpty() const {
+        return match(flatEmpty);
+    }
+
+    std::uint32_t matchEmptyOrDeleted() const {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < flatGroupWidth; ++i)
+            mask |= static_cast<std::uint32_t>(flatIsEmptyOrDeleted(ctrl[i]))
+                    << i;
+
+        return mask;
+    }
+};
+
+#endif // TINY_STL_HAS_SSE2
+
+// power of 2, the probe sequence use mask instead of modulo
+inline std::size_t flatNormalizeCapacity(std::size_t n) noexcept {
+    std::size_t cap = flatMinCapacity;
+    while (cap < n)
+        cap <<= 1;
+
+    return cap;
+}
+
+} // namespace details
+
+template <typename T>
+struct FlatHashIterator;
+
+template <typename T>
+struct FlatHashConstIterator {
+    using iterator_category = forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = const T&;
+    using pointer = const T*;
+
+    const details::FlatCtrl* ctrl;
+    T* slot;
+
+    FlatHashConstIterator() = default;
+    FlatHashConstIterator(const details::FlatCtrl* c, T* s)
+        : ctrl(c), slot(s) {
+    }
+
+    FlatHashConstIterator(const FlatHashConstIterator&) = default;
+
+    FlatHashConstIterator(const FlatHashIterator<T>& rhs)
+        : ctrl(rhs.ctrl), slot(rhs.slot) {
+    }
+
+    reference operator*() const {
+        return *slot;
+    }
+
+    pointer operator->() const {
+        return pointer_traits<pointer>::pointer_to(**this);
+    }
+
+    // the sentinel is neither empty nor deleted
+    void skipEmptyOrDeleted() {
+        while (details::flatIsEmptyOrDeleted(*ctrl)) {
+            ++ctrl;
+            ++slot;
+        }
+    }
+
+    FlatHashConstIterator& operator++() {
+        ++ctrl;
+        ++slot;
+        skipEmptyOrDeleted();
+        return *this;
+    }
+
+    FlatHashConstIterator operator++(int) {
+        FlatHashConstIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(const FlatHashConstIterator& rhs) const {
+        return slot == rhs.slot;
+    }
+
+    bool operator!=(const FlatHashConstIterator& rhs) const {
+        return slot != rhs.slot;
+    }
+};
+
+template <typename T>
+struct FlatHashIterator {
+    using iterator_category = forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using pointer = T*;
+
+    const details::FlatCtrl* ctrl;
+    T* slot;
+
+    FlatHashIterator() = default;
+    FlatHashIterator(const details::FlatCtrl* c, T* s) : ctrl(c), slot(s) {
+    }
+
+    reference operator*() const {
+        return *slot;
+    }
+
+    pointer operator->() const {
+        return pointer_traits<pointer>::pointer_to(**this);
+    }
+
+    void skipEmptyOrDeleted() {
+        while (details::flatIsEmptyOrDeleted(*ctrl)) {
+            ++ctrl;
+            ++slot;
+        }
+    }
+
+    FlatHashIterator& operator++() {
+        ++ctrl;
+        ++slot;
+        skipEmptyOrDeleted();
+        return *this;
+    }
+
+    FlatHashIterator operator++(int) {
+        FlatHashIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(const FlatHashIterator& rhs) const {
+        return slot == rhs.slot;
+    }
+
+    bool operator!=(const FlatHashIterator& rhs) const {
+        return slot != rhs.slot;
+    }
+};
+
+// Open addressing hash table, elements are stored in a flat slot array.
+// Each slot has a control byte (see details::FlatCtrl), the lookup compares
+// a group of 16 control bytes with H2 at once (SSE2 or scalar fallback),
+// and only calls KeyEqual when the 7-bit H2 matches.
+// Only unique keys are supported.
+template <typename T, typename Hash, typename KeyEqual, typename Alloc,
+          bool isMap>
+class FlatHashTable {
+public:
+    using key_type = typename AssociatedTypeHelper<T, isMap>::key_type;
+    using mapped_type = typename AssociatedTypeHelper<T, isMap>::mapped_type;
+    using value_type = T;
+    using size_type = typename Alloc::size_type;
+    using difference_type = typename Alloc::difference_type;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Alloc;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using AlTraits = allocator_traits<Alloc>;
+    using pointer = typename AlTraits::pointer;
+    using const_pointer = typename AlTraits::const_pointer;
+
+    using iterator = FlatHashIterator<T>;
+    using const_iterator = FlatHashConstIterator<T>;
+
+    using AlCtrl = typename allocator_traits<Alloc>::template rebind_alloc<
+        details::FlatCtrl>;
+    using AlSlot = typename allocator_traits<Alloc>::template rebind_alloc<T>;
+    using AlSlotTraits = allocator_traits<AlSlot>;
+    using Self = FlatHashTable<T, Hash, KeyEqual, Alloc, isMap>;
+
+public:
+    // num_slots + 1 control bytes, the last one is sentinel
+    details::FlatCtrl* ctrl;
+    T* slots;
+    size_type num_slots;
+    size_type num_elements;
+    // number of empty slots can be filled before rehash
+    size_type growth_left;
+    float maxfactor;
+    hasher hashfunc;
+    key_equal key_equ;
+    AlSlot alloc;
+
+private:
+    // map
+    const key_type& getKey(const T& val, true_type) const {
+        return val.first;
+    }
+
+    // set
+    const key_type& getKey(const T& val, false_type) const {
+        return val;
+    }
+
+    const key_type& get_key(const T& val) const {
+        return getKey(val, tiny_stl::bool_constant<isMap>{});
+    }
+
+    // keep at least one empty slot, the probe loop will stop
+    size_type growthLimit(size_type cap) const {
+        const auto limit = static_cast<size_type>(cap * maxfactor);
+        return limit < cap ? limit : cap - 1;
+    }
+
+    size_type capacityFor(size_type n) const {
+        size_type cap = details::flatMinCapacity;
+        while (growthLimit(cap) < n)
+            cap <<= 1;
+
+        return cap;
+    }
+
+    iterator makeIter(size_type idx) {
+        return iterator(ctrl + idx, slots + idx);
+    }
+
+    const_iterator makeIter(size_type idx) const {
+        return const_iterator(ctrl + idx, slots + idx);
+    }
+
+    void resetCtrl() {
+        ::memset(ctrl, details::flatEmpty, num_slots);
+        ctrl[num_slots] = details::flatSentinel;
+        growth_left = growthLimit(num_slots) - num_elements;
+    }
+
+    void initEmpty() noexcept {
+        ctrl = details::flatEmptyCtrl();
+        slots = nullptr;
+        num_slots = 0;
+        num_elements = 0;
+        growth_left = 0;
+    }
+
+    // the old arrays are untouched if allocation fails
+    void allocateSlots(size_type cap) {
+        AlCtrl alctrl(alloc);
+        details::FlatCtrl* newCtrl = alctrl.allocate(cap + 1);
+        try {
+            slots = alloc.allocate(cap);
+        } catch (...) {
+            alctrl.deallocate(newCtrl, cap + 1);
+            throw;
+        }
+        ctrl = newCtrl;
+        num_slots = cap;
+        resetCtrl();
+    }
+
+    void deallocateSlots() {
+        if (num_slots != 0) {
+            AlCtrl alctrl(alloc);
+            alctrl.deallocate(ctrl, num_slots + 1);
+            alloc.deallocate(slots, num_slots);
+        }
+    }
+
+    void destroySlots() {
+        for (size_type i = 0; i != num_slots; ++i) {
+            if (details::flatIsFull(ctrl[i]))
+                AlSlotTraits::destroy(alloc, slots + i);
+        }
+    }
+
+    void tidy() {
+        destroySlots();
+        deallocateSlots();
+        initEmpty();
+    }
+
+    // Ref is T&& to move the elements out of rhs one by one
+    template <typename Ref = const T&>
+    void copyAux(const FlatHashTable& rhs) {
+        if (rhs.num_slots == 0)
+            return;
+
+        allocateSlots(rhs.num_slots);
+        size_type i = 0;
+        try {
+            for (; i != num_slots; ++i) {
+                if (details::flatIsFull(rhs.ctrl[i]))
+                    AlSlotTraits::construct(alloc, slots + i,
+                                            static_cast<Ref>(rhs.slots[i]));
+            }
+        } catch (...) {
+            for (size_type j = 0; j != i; ++j) {
+                if (details::flatIsFull(rhs.ctrl[j]))
+                    AlSlotTraits::destroy(alloc, slots + j);
+            }
+            deallocateSlots();
+            initEmpty();
+            throw;
+        }
+
+        ::memcpy(ctrl, rhs.ctrl, num_slots + 1);
+        num_elements = rhs.num_elements;
+        growth_left = rhs.growth_left;
+    }
+
+    void stealFrom(FlatHashTable& rhs) noexcept {
+        ctrl = rhs.ctrl;
+        slots = rhs.slots;
+        num_slots = rhs.num_slots;
+        num_elements = rhs.num_elements;
+        growth_left = rhs.growth_left;
+        rhs.initEmpty();
+    }
+
+    size_type groupMask() const {
+        return num_slots / details::flatGroupWidth - 1;
+    }
+
+    // triangular probing over groups from H1, it visits every group
+    // because the number of groups is a power of 2.
+    // return num_slots if not found
+    template <typename K>
+    size_type findIndex(const K& key, std::size_t hash) const {
+        if (num_slots == 0)
+            return num_slots;
+
+        const size_type mask = groupMask();
+        const details::FlatCtrl h2 = details::flatH2(hash);
+        size_type group = details::flatH1(hash) & mask;
+        for (size_type step = 1;; ++step) {
+            const size_type offset = group * details::flatGroupWidth;
+            const details::FlatGroup g(ctrl + offset);
+            for (std::uint32_t bits = g.match(h2); bits != 0;
+                 bits &= bits - 1) {
+                const size_type idx = offset + details::flatLowestBit(bits);
+                if (key_equ(get_key(slots[idx]), key))
+                    return idx;
+            }
+
+            if (g.matchEmpty() != 0)
+                return num_slots;
+
+            group = (group + step) & mask;
+        }
+    }
+
+    // return 0 if there is no slot, prepareInsert will grow the table
+    size_type findFirstNonFull(std::size_t hash) const {
+        if (num_slots == 0)
+            return 0;
+
+        const size_type mask = groupMask();
+        size_type group = details::flatH1(hash) & mask;
+        for (size_type step = 1;; ++step) {
+            const size_type offset = group * details::flatGroupWidth;
+            const std::uint32_t bits =
+                details::FlatGroup(ctrl + offset).matchEmptyOrDeleted();
+            if (bits != 0)
+                return offset + details::flatLowestBit(bits);
+
+            group = (group + step) & mask;
+        }
+    }
+
+    void rehashAux(size_type newCapacity) {
+        details::FlatCtrl* oldCtrl = ctrl;
+        T* oldSlots = slots;
+        const size_type oldNumSlots = num_slots;
+
+        allocateSlots(newCapacity);
+        for (size_type i = 0; i != oldNumSlots; ++i) {
+            if (!details::flatIsFull(oldCtrl[i]))
+                continue;
+
+            const std::size_t hash = hashfunc(get_key(oldSlots[i]));
+            const size_type idx = findFirstNonFull(hash);
+            ctrl[idx] = details::flatH2(hash);
+            AlSlotTraits::construct(alloc, slots + idx,
+                                    tiny_stl::move(oldSlots[i]));
+            AlSlotTraits::destroy(alloc, oldSlots + i);
+        }
+
+        if (oldNumSlots != 0) {
+            AlCtrl alctrl(alloc);
+            alctrl.deallocate(oldCtrl, oldNumSlots + 1);
+            alloc.deallocate(oldSlots, oldNumSlots);
+        }
+    }
+
+    void grow() {
+        // too many deleted slots, rehash in place to drop them
+        if (num_slots != 0 && num_elements <= growthLimit(num_slots) / 2)
+            rehashAux(num_slots);
+        else
+            rehashAux(num_slots == 0 ? details::flatMinCapacity
+                                     : num_slots << 1);
+    }
+
+    // mark a slot as full, the caller constructs the element
+    size_type prepareInsert(std::size_t hash) {
+        size_type idx = findFirstNonFull(hash);
+        if (growth_left == 0 && ctrl[idx] != details::flatDeleted) {
+            grow();
+            idx = findFirstNonFull(hash);
+        }
+
+        if (ctrl[idx] == details::flatEmpty)
+            --growth_left;
+        ctrl[idx] = details::flatH2(hash);
+        ++num_elements;
+
+        return idx;
+    }
+
+    void eraseMeta(size_type idx) {
+        --num_elements;
+        // no probe sequence passes through a group with empty slot
+        const size_type offset =
+            idx / details::flatGroupWidth * details::flatGroupWidth;
+        if (details::FlatGroup(ctrl + offset).matchEmpty() != 0) {
+            ctrl[idx] = details::flatEmpty;
+            ++growth_left;
+        } else {
+            ctrl[idx] = details::flatDeleted;
+        }
+    }
+
+    template <typename... Args>
+    void constructSlot(size_type idx, Args&&... args) {
+        try {
+            AlSlotTraits::construct(alloc, slots + idx,
+                                    tiny_stl::forward<Args>(args)...);
+        } catch (...) {
+            eraseMeta(idx);
+            throw;
+        }
+    }
+
+public:
+    FlatHashTable(size_type n, const Alloc& al = Alloc(),
+                  const hasher& hf = hasher(),
+                  const key_equal& equ = key_equal())
+        : maxfactor(0.875f), hashfunc(hf), key_equ(equ),
+          alloc(static_cast<AlSlot>(al)) {
+        initEmpty();
+        if (n != 0)
+            allocateSlots(details::flatNormalizeCapacity(n));
+    }
+
+    FlatHashTable(const FlatHashTable& rhs)
+        : maxfactor(rhs.maxfactor), hashfunc(rhs.hashfunc),
+          key_equ(rhs.key_equ),
+          alloc(AlSlotTraits::select_on_container_copy_construction(
+              rhs.alloc)) {
+        initEmpty();
+        copyAux(rhs);
+    }
+
+    FlatHashTable(const FlatHashTable& rhs, const Alloc& al)
+        : maxfactor(rhs.maxfactor), hashfunc(rhs.hashfunc),
+          key_equ(rhs.key_equ), alloc(static_cast<AlSlot>(al)) {
+        initEmpty();
+        copyAux(rhs);
+    }
+
+    FlatHashTable(FlatHashTable&& rhs) noexcept
+        : maxfactor(rhs.maxfactor), hashfunc(rhs.hashfunc),
+          key_equ(rhs.key_equ), alloc(tiny_stl::move(rhs.alloc)) {
+        stealFrom(rhs);
+    }
+
+    FlatHashTable& operator=(const FlatHashTable& rhs) {
+        assert(this != tiny_stl::addressof(rhs));
+        FlatHashTable tmp(rhs);
+        this->swap(tmp);
+
+        return *this;
+    }
+
+    FlatHashTable& operator=(FlatHashTable&& rhs) {
+        assert(this != tiny_stl::addressof(rhs));
+        tidy();
+        hashfunc = rhs.hashfunc;
+        key_equ = rhs.key_equ;
+        maxfactor = rhs.maxfactor;
+        if (AlSlotTraits::propagate_on_container_move_assignment::value)
+            alloc = rhs.alloc;
+
+        if (alloc == rhs.alloc) {
+            stealFrom(rhs);
+        } else { // the arrays of rhs can only go back to rhs.alloc
+            copyAux<T&&>(rhs);
+            rhs.tidy();
+        }
+
+        return *this;
+    }
+
+    ~FlatHashTable() noexcept {
+        destroySlots();
+        deallocateSlots();
+    }
+
+    allocator_type get_allocator() const {
+        return static_cast<allocator_type>(alloc);
+    }
+
+    iterator begin() noexcept {
+        iterator iter(ctrl, slots);
+        iter.skipEmptyOrDeleted();
+        return iter;
+    }
+
+    const_iterator begin() const noexcept {
+        const_iterator iter(ctrl, slots);
+        iter.skipEmptyOrDeleted();
+        return iter;
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return makeIter(num_slots);
+    }
+
+    const_iterator end() const noexcept {
+        return makeIter(num_slots);
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_type size() const noexcept {
+        return num_elements;
+    }
+
+    bool empty() const noexcept {
+        return num_elements == 0;
+    }
+
+    size_type max_size() const noexcept {
+        return static_cast<std::size_t>(-1) / sizeof(T);
+    }
+
+    // keep the slot array
+    void clear() noexcept {
+        if (num_slots == 0)
+            return;
+
+        destroySlots();
+        num_elements = 0;
+        resetCtrl();
+    }
+
+private:
+    template <typename Value>
+    pair<iterator, bool> insertUniqueAux(Value&& val) {
+        const std::size_t hash = hashfunc(get_key(val));
+        size_type idx = findIndex(get_key(val), hash);
+        if (idx != num_slots)
+            return tiny_stl::make_pair(makeIter(idx), false);
+
+        idx = prepareInsert(hash);
+        constructSlot(idx, tiny_stl::forward<Value>(val));
+
+        return tiny_stl::make_pair(makeIter(idx), true);
+    }
+
+protected:
+    pair<iterator, bool> insert_unique(const value_type& val) {
+        return insertUniqueAux(val);
+    }
+
+    pair<iterator, bool> insert_unique(value_type&& val) {
+        return insertUniqueAux(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert_unique(InIter first, InIter last) {
+        for (; first != last; ++first)
+            insertUniqueAux(*first);
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> emplace_unique(Args&&... args) {
+        T val(tiny_stl::forward<Args>(args)...);
+        return insertUniqueAux(tiny_stl::move(val));
+    }
+
+    // map only, hash the key once for operator[]
+    template <typename K>
+    iterator findOrEmplaceKey(K&& key) {
+        const std::size_t hash = hashfunc(key);
+        size_type idx = findIndex(key, hash);
+        if (idx == num_slots) {
+            idx = prepareInsert(hash);
+            constructSlot(idx, tiny_stl::forward<K>(key), mapped_type{});
+        }
+
+        return makeIter(idx);
+    }
+
+    template <typename K>
+    size_type count_unique(const K& key) const {
+        return num_elements != 0 && findIndex(key, hashfunc(key)) != num_slots
+                   ? 1
+                   : 0;
+    }
+
+public:
+    iterator erase(const_iterator pos) {
+        assert(pos != cend());
+        const size_type idx = static_cast<size_type>(pos.slot - slots);
+        AlSlotTraits::destroy(alloc, slots + idx);
+        eraseMeta(idx);
+
+        iterator next = makeIter(idx);
+        next.skipEmptyOrDeleted();
+        return next;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last)
+            first = erase(first);
+
+        return makeIter(static_cast<size_type>(last.slot - slots));
+    }
+
+    size_type erase(const key_type& key) {
+        return eraseKey(key);
+    }
+
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>,
+              typename = enable_if_t<!is_convertible<K, iterator>::value &&
+                                     !is_convertible<K, const_iterator>::value>>
+    size_type erase(K&& key) {
+        return eraseKey(key);
+    }
+
+private:
+    template <typename K>
+    size_type eraseKey(const K& key) {
+        const size_type idx = findIndex(key, hashfunc(key));
+        if (idx == num_slots)
+            return 0;
+
+        AlSlotTraits::destroy(alloc, slots + idx);
+        eraseMeta(idx);
+        return 1;
+    }
+
+public:
+    void swap(FlatHashTable& rhs) {
+        swapADL(ctrl, rhs.ctrl);
+        swapADL(slots, rhs.slots);
+        swapADL(num_slots, rhs.num_slots);
+        swapADL(num_elements, rhs.num_elements);
+        swapADL(growth_left, rhs.growth_left);
+        swapADL(maxfactor, rhs.maxfactor);
+        swapADL(hashfunc, rhs.hashfunc);
+        swapADL(key_equ, rhs.key_equ);
+        swapAlloc(alloc, rhs.alloc);
+    }
+
+private:
+    template <typename K>
+    size_type findAux(const K& key) const {
+        return empty() ? num_slots : findIndex(key, hashfunc(key));
+    }
+
+    // unique keys, [pos, pos + 1) or empty
+    template <typename Iter>
+    static pair<Iter, Iter> rangeOf(Iter pos, Iter last) {
+        if (pos == last)
+            return tiny_stl::make_pair(pos, pos);
+
+        Iter next = pos;
+        return tiny_stl::make_pair(pos, ++next);
+    }
+
+public:
+    iterator find(const key_type& key) {
+        const size_type idx = findAux(key);
+        return idx == num_slots ? end() : makeIter(idx);
+    }
+
+    const_iterator find(const key_type& key) const {
+        const size_type idx = findAux(key);
+        return idx == num_slots ? end() : makeIter(idx);
+    }
+
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    iterator find(const K& key) {
+        const size_type idx = findAux(key);
+        return idx == num_slots ? end() : makeIter(idx);
+    }
+
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    const_iterator find(const K& key) const {
+        const size_type idx = findAux(key);
+        return idx == num_slots ? end() : makeIter(idx);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key) {
+        return rangeOf(find(key), end());
+    }
+
+    pair<const_iterator, const_iterator>
+    equal_range(const key_type& key) const {
+        return rangeOf(find(key), end());
+    }
+
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    pair<iterator, iterator> equal_range(const K& key) {
+        return rangeOf(find(key), end());
+    }
+
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    pair<const_iterator, const_iterator> equal_range(const K& key) const {
+        return rangeOf(find(key), end());
+    }
+
+    bool contains(const key_type& key) const {
+        return findAux(key) != num_slots;
+    }
+
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    bool contains(const K& key) const {
+        return findAux(key) != num_slots;
+    }
+
+public:
+    size_type bucket_count() const noexcept {
+        return num_slots;
+    }
+
+    size_type max_bucket_count() const noexcept {
+        return max_size();
+    }
+
+    float load_factor() const {
+        return num_slots == 0 ? 0.0f
+                              : static_cast<float>(size()) /
+                                    static_cast<float>(bucket_count());
+    }
+
+    float max_load_factor() const {
+        return maxfactor;
+    }
+
+    void max_load_factor(float mlf) {
+        if (mlf > 0.0f && mlf < 1.0f) {
+            maxfactor = mlf;
+            rehashAux(capacityFor(size()));
+        }
+    }
+
+    void rehash(size_type n) {
+        size_type newCapacity = details::flatNormalizeCapacity(n);
+        const size_type minCapacity = capacityFor(size());
+        if (newCapacity < minCapacity)
+            newCapacity = minCapacity;
+
+        if (newCapacity != num_slots)
+            rehashAux(newCapacity);
+    }
+
+    void reserve(size_type n) {
+        if (n > size() + growth_left)
+            rehashAux(capacityFor(n));
+    }
+
+    hasher hash_function() const {
+        return hashfunc;
+    }
+
+    key_equal key_eq() const {
+        return key_equ;
+    }
+}; // FlatHashTable
+
+template <typename T, typename Hash, typename KeyEqual, typename Alloc,
+          bool isMap>
+inline bool
+operator==(const FlatHashTable<T, Hash, KeyEqual, Alloc, isMap>& lhs,
+           const FlatHashTable<T, Hash, KeyEqual, Alloc, isMap>& rhs) {
+    if (lhs.size() != rhs.size())
+        return false;
+
+    // the iteration order depends on the history of insertion
+    for (auto iter = lhs.begin(); iter != lhs.end(); ++iter) {
+        auto pos = rhs.find(
+            details::flatKeyOf(*iter, tiny_stl::bool_constant<isMap>{}));
+        if (pos == rhs.end() || !(*pos == *iter))
+            return false;
+    }
+
+    return true;
+}
+
+template <typename T, typename Hash, typename KeyEqual, typename Alloc,
+          bool isMap>
+inline bool
+operator!=(const FlatHashTable<T, Hash, KeyEqual, Alloc, isMap>& lhs,
+           const FlatHashTable<T, Hash, KeyEqual, Alloc, isMap>& rhs) {
+    return !(lhs == rhs);
 }
 
 } // namespace tiny_stl
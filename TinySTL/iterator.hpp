@@ -197,7 +197,7 @@ public:
     constexpr pointer operator->() const {
         Iter tmp = current;
         --tmp;
-        return (operator_arrow(tmp, is_pointer<Iter>()));
+        return (details::operator_arrow(tmp, is_pointer<Iter>()));
     }
 
     constexpr Self& operator++() {
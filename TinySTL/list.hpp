@@ -916,6 +916,11 @@ private:
     }
 }; // class list<T, Alloc>
 
+// the sentinel node is on the heap
+template <typename T, typename Alloc>
+struct is_trivially_relocatable<list<T, Alloc>>
+    : is_trivially_relocatable<typename ListBase<T, Alloc>::AlNode> {};
+
 template <typename T, typename Alloc>
 inline bool operator==(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs) {
     return lhs.size() == rhs.size() &&
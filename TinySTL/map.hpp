@@ -134,7 +134,7 @@ public:
     T& operator[](const Key& key) {
         iterator pos = this->find(key);
         if (pos == this->end())
-            return this->insert(make_pair(key, T{})).first->second;
+            return this->insert(tiny_stl::make_pair(key, T{})).first->second;
 
         return pos->second;
     }
@@ -142,7 +142,7 @@ public:
     T& operator[](Key&& key) {
         iterator pos = this->find(key);
         if (pos == this->end())
-            return this->insert(make_pair(tiny_stl::move(key), T{}))
+            return this->insert(tiny_stl::make_pair(tiny_stl::move(key), T{}))
                 .first->second;
 
         return pos->second;
@@ -171,11 +171,36 @@ public:
         this->insert_unique(ilist.begin(), ilist.end());
     }
 
+    iterator insert(const_iterator hint, const value_type& val) {
+        return this->insert_unique(hint, val);
+    }
+
+    template <typename P,
+              typename = enable_if_t<is_constructible<value_type, P&&>::value>>
+    iterator insert(const_iterator hint, P&& val) {
+        return this->insert_unique(hint, tiny_stl::forward<P>(val));
+    }
+
+    iterator insert(const_iterator hint, value_type&& val) {
+        return this->insert_unique(hint, tiny_stl::move(val));
+    }
+
+    template <typename Range>
+    void insert_range(Range&& rg) {
+        this->insert_unique(rg.begin(), rg.end());
+    }
+
     template <typename... Args>
     pair<iterator, bool> emplace(Args&&... args) {
         return this->emplace_unique(tiny_stl::forward<Args>(args)...);
     }
 
+    template <typename... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args) {
+        return this->emplace_hint_unique(hint,
+                                         tiny_stl::forward<Args>(args)...);
+    }
+
     void swap(map& rhs) {
         Base::swap(rhs);
     }
@@ -309,17 +334,17 @@ public:
         return *this;
     }
 
-    pair<iterator, bool> insert(const value_type& val) {
+    iterator insert(const value_type& val) {
         return this->insert_equal(val);
     }
 
     template <typename P,
               typename = enable_if_t<is_constructible<value_type, P&&>::value>>
-    pair<iterator, bool> insert(P&& val) {
+    iterator insert(P&& val) {
         return this->insert_equal(tiny_stl::forward<P>(val));
     }
 
-    pair<iterator, bool> insert(value_type&& val) {
+    iterator insert(value_type&& val) {
         return this->insert_equal(tiny_stl::move(val));
     }
 
@@ -332,11 +357,36 @@ public:
         this->insert_equal(ilist.begin(), ilist.end());
     }
 
+    iterator insert(const_iterator hint, const value_type& val) {
+        return this->insert_equal(hint, val);
+    }
+
+    template <typename P,
+              typename = enable_if_t<is_constructible<value_type, P&&>::value>>
+    iterator insert(const_iterator hint, P&& val) {
+        return this->insert_equal(hint, tiny_stl::forward<P>(val));
+    }
+
+    iterator insert(const_iterator hint, value_type&& val) {
+        return this->insert_equal(hint, tiny_stl::move(val));
+    }
+
+    template <typename Range>
+    void insert_range(Range&& rg) {
+        this->insert_equal(rg.begin(), rg.end());
+    }
+
     template <typename... Args>
-    pair<iterator, bool> emplace(Args&&... args) {
+    iterator emplace(Args&&... args) {
         return this->emplace_equal(tiny_stl::forward<Args>(args)...);
     }
 
+    template <typename... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args) {
+        return this->emplace_hint_equal(hint,
+                                        tiny_stl::forward<Args>(args)...);
+    }
+
     void swap(multimap& rhs) {
         Base::swap(rhs);
     }
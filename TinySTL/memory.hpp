@@ -290,7 +290,9 @@ inline FwdIter uninitAllocDefaultNAux(FwdIter first, Size n, Alloc&,
 template <typename FwdIter, typename Size, typename Alloc>
 inline FwdIter uninitAllocDefaultNAux(FwdIter first, Size n, Alloc& alloc,
                                       false_type) {
-    alloc.construct(tiny_stl::addressof(*first));
+    for (; n > 0; --n, ++first)
+        alloc.construct(tiny_stl::addressof(*first));
+
     return first;
 }
 
@@ -345,6 +347,24 @@ inline FwdIter uninitializedAllocMove(InIter first, InIter last,
     return newFirst;
 }
 
+// the elements of a container can move to new storage with memcpy, the
+// old bytes are released without destructor calls
+template <typename Alloc, typename T = typename Alloc::value_type>
+using UseRelocate =
+    typename conjunction<is_trivially_relocatable<T>,
+                         UseDefaultConstruct<Alloc, T*, T&&>,
+                         UseDefaultDestroy<Alloc, T*>>::type;
+
+// memcpy [first, last) to raw memory, the source must not be destroyed
+template <typename T>
+inline T* uninitializedRelocate(T* first, T* last, T* dst) noexcept {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n != 0)
+        std::memcpy(static_cast<void*>(dst), static_cast<const void*>(first),
+                    n * sizeof(T));
+    return dst + n;
+}
+
 template <typename T>
 struct GetFirstParameter;
 
@@ -1054,13 +1074,13 @@ template <typename T, typename... Args,
           typename = enable_if_t<std::extent<T>::value != 0>>
 void make_unique(Args&&...) = delete;
 
-template <typename T, typename D>
-struct hash<unique_ptr<T, D>> {
+template <typename T, typename D, typename Policy>
+struct hash<unique_ptr<T, D>, Policy> {
     using argument_type = unique_ptr<T, D>;
     using result_type = std::size_t;
 
     std::size_t operator()(const unique_ptr<T, D>& up) const noexcept {
-        return hash<T>{}(*up);
+        return hash<T, Policy>{}(*up);
     }
 };
 
@@ -1175,6 +1195,16 @@ class shared_ptr;
 template <typename T>
 class weak_ptr;
 
+template <typename T, typename D>
+struct is_trivially_relocatable<unique_ptr<T, D>>
+    : is_trivially_relocatable<D> {};
+
+template <typename T>
+struct is_trivially_relocatable<shared_ptr<T>> : true_type {};
+
+template <typename T>
+struct is_trivially_relocatable<weak_ptr<T>> : true_type {};
+
 // reference MSVC implement
 
 // reference count abstract base class
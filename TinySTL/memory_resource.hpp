@@ -0,0 +1,654 @@
+﻿// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#include "memory.hpp"
+
+namespace tiny_stl {
+
+namespace details {
+
+inline std::size_t alignUp(std::size_t n, std::size_t alignment) noexcept {
+    return (n + alignment - 1) & ~(alignment - 1);
+}
+
+inline bool isPowerOf2(std::size_t n) noexcept {
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+// operator new only guarantees max_align_t, over-aligned blocks are
+// over-allocated and the original pointer is kept in front of the block
+inline void* newAligned(std::size_t bytes, std::size_t alignment) {
+    if (alignment <= alignof(std::max_align_t))
+        return ::operator new(bytes);
+
+    if (bytes > std::numeric_limits<std::size_t>::max() - alignment -
+                    sizeof(void*))
+        throw std::bad_alloc{};
+
+    void* raw = ::operator new(bytes + alignment + sizeof(void*));
+    std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+    addr = (addr + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+    void* p = reinterpret_cast<void*>(addr);
+    static_cast<void**>(p)[-1] = raw;
+    return p;
+}
+
+inline void deleteAligned(void* p, std::size_t alignment) noexcept {
+    if (alignment <= alignof(std::max_align_t))
+        ::operator delete(p);
+    else
+        ::operator delete(static_cast<void**>(p)[-1]);
+}
+
+} // namespace details
+
+namespace pmr {
+
+class memory_resource {
+private:
+    static constexpr std::size_t maxAlign = alignof(std::max_align_t);
+
+public:
+    virtual ~memory_resource() = default;
+
+    void* allocate(std::size_t bytes, std::size_t alignment = maxAlign) {
+        return do_allocate(bytes, alignment);
+    }
+
+    void deallocate(void* p, std::size_t bytes,
+                    std::size_t alignment = maxAlign) {
+        do_deallocate(p, bytes, alignment);
+    }
+
+    bool is_equal(const memory_resource& rhs) const noexcept {
+        return do_is_equal(rhs);
+    }
+
+private:
+    virtual void* do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+    virtual void do_deallocate(void* p, std::size_t bytes,
+                               std::size_t alignment) = 0;
+    virtual bool do_is_equal(const memory_resource& rhs) const noexcept = 0;
+}; // class memory_resource
+
+inline bool operator==(const memory_resource& lhs,
+                       const memory_resource& rhs) noexcept {
+    return &lhs == &rhs || lhs.is_equal(rhs);
+}
+
+inline bool operator!=(const memory_resource& lhs,
+                       const memory_resource& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+class NewDeleteResource : public memory_resource {
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        return details::newAligned(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t, std::size_t alignment) override {
+        details::deleteAligned(p, alignment);
+    }
+
+    bool do_is_equal(const memory_resource& rhs) const noexcept override {
+        return this == &rhs;
+    }
+}; // class NewDeleteResource
+
+class NullResource : public memory_resource {
+private:
+    void* do_allocate(std::size_t, std::size_t) override {
+        throw std::bad_alloc{};
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {
+    }
+
+    bool do_is_equal(const memory_resource& rhs) const noexcept override {
+        return this == &rhs;
+    }
+}; // class NullResource
+
+// the resources are leaked on purpose, containers with static storage
+// duration may use them after exit
+inline memory_resource* new_delete_resource() noexcept {
+    static memory_resource* res = new NewDeleteResource;
+    return res;
+}
+
+inline memory_resource* null_memory_resource() noexcept {
+    static memory_resource* res = new NullResource;
+    return res;
+}
+
+inline std::atomic<memory_resource*>& defaultResource() noexcept {
+    static std::atomic<memory_resource*> res{new_delete_resource()};
+    return res;
+}
+
+inline memory_resource* set_default_resource(memory_resource* r) noexcept {
+    if (r == nullptr)
+        r = new_delete_resource();
+    return defaultResource().exchange(r);
+}
+
+inline memory_resource* get_default_resource() noexcept {
+    return defaultResource().load();
+}
+
+// bump pointer arena, deallocate is a no-op and all memory is given back
+// at once by release() or the destructor
+class monotonic_buffer_resource : public memory_resource {
+private:
+    // header at the front of every chunk from upstream
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* next;
+        std::size_t size;
+    };
+
+    static constexpr std::size_t defaultSize = 1024;
+
+    memory_resource* upstream;
+    void* initBuffer = nullptr;
+    std::size_t initSize = 0;
+    char* cur = nullptr;
+    std::size_t space = 0;
+    std::size_t nextSize;
+    Chunk* chunks = nullptr;
+
+public:
+    monotonic_buffer_resource()
+        : monotonic_buffer_resource(get_default_resource()) {
+    }
+
+    explicit monotonic_buffer_resource(memory_resource* up)
+        : upstream(up), nextSize(defaultSize) {
+    }
+
+    explicit monotonic_buffer_resource(std::size_t initialSize)
+        : monotonic_buffer_resource(initialSize, get_default_resource()) {
+    }
+
+    monotonic_buffer_resource(std::size_t initialSize, memory_resource* up)
+        : upstream(up), nextSize(initialSize == 0 ? 1 : initialSize) {
+    }
+
+    monotonic_buffer_resource(void* buffer, std::size_t bufferSize)
+        : monotonic_buffer_resource(buffer, bufferSize,
+                                    get_default_resource()) {
+    }
+
+    monotonic_buffer_resource(void* buffer, std::size_t bufferSize,
+                              memory_resource* up)
+        : upstream(up), initBuffer(buffer), initSize(bufferSize),
+          cur(static_cast<char*>(buffer)), space(bufferSize),
+          nextSize(bufferSize == 0 ? defaultSize : bufferSize * 2) {
+    }
+
+    monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+    monotonic_buffer_resource&
+    operator=(const monotonic_buffer_resource&) = delete;
+
+    ~monotonic_buffer_resource() override {
+        release();
+    }
+
+    // frees every chunk in O(chunks) and rewinds to the initial buffer
+    void release() noexcept {
+        while (chunks != nullptr) {
+            Chunk* next = chunks->next;
+            upstream->deallocate(chunks, chunks->size, alignof(Chunk));
+            chunks = next;
+        }
+
+        cur = static_cast<char*>(initBuffer);
+        space = initSize;
+    }
+
+    memory_resource* upstream_resource() const noexcept {
+        return upstream;
+    }
+
+private:
+    // bump cur, nullptr if the current buffer is too small
+    void* tryBump(std::size_t bytes, std::size_t alignment) noexcept {
+        std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(cur);
+        std::size_t pad = static_cast<std::size_t>(
+            ((addr + alignment - 1) & ~(std::uintptr_t(alignment) - 1)) -
+            addr);
+        if (cur == nullptr || pad > space || bytes > space - pad)
+            return nullptr;
+
+        void* p = cur + pad;
+        cur += pad + bytes;
+        space -= pad + bytes;
+        return p;
+    }
+
+    // geometric growth, so n allocations cost O(log n) upstream calls
+    void newChunk(std::size_t bytes, std::size_t alignment) {
+        std::size_t need = bytes + alignment;
+        if (need < bytes)
+            throw std::bad_alloc{};
+
+        constexpr std::size_t maxGrow =
+            std::numeric_limits<std::size_t>::max() / 2;
+        std::size_t size = nextSize;
+        while (size < need && size <= maxGrow)
+            size *= 2;
+        if (size < need)
+            size = need;
+
+        if (size > std::numeric_limits<std::size_t>::max() - sizeof(Chunk))
+            throw std::bad_alloc{};
+
+        std::size_t total = size + sizeof(Chunk);
+        void* mem = upstream->allocate(total, alignof(Chunk));
+        Chunk* chunk = static_cast<Chunk*>(mem);
+        chunk->next = chunks;
+        chunk->size = total;
+        chunks = chunk;
+
+        cur = reinterpret_cast<char*>(chunk + 1);
+        space = size;
+        if (size <= maxGrow)
+            nextSize = size * 2;
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        assert(details::isPowerOf2(alignment));
+        if (bytes == 0)
+            bytes = 1;
+
+        void* p = tryBump(bytes, alignment);
+        if (p == nullptr) {
+            newChunk(bytes, alignment);
+            p = tryBump(bytes, alignment);
+        }
+
+        return p;
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {
+        // memory is reclaimed by release()
+    }
+
+    bool do_is_equal(const memory_resource& rhs) const noexcept override {
+        return this == &rhs;
+    }
+}; // class monotonic_buffer_resource
+
+struct pool_options {
+    std::size_t max_blocks_per_chunk = 0;
+    std::size_t largest_required_pool_block = 0;
+};
+
+// size class pools, each keeps a free list of blocks carved from chunks
+// of the upstream resource. Blocks bigger than the largest pool go to
+// upstream directly. Not thread safe, see pool_allocator for that.
+class unsynchronized_pool_resource : public memory_resource {
+private:
+    static constexpr std::size_t minBlockSize = 8;
+    static constexpr std::size_t defaultLargestBlock = 4096;
+    static constexpr std::size_t defaultMaxBlocks = 1024;
+    static constexpr std::size_t minChunkBlocks = 8;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* next;
+        std::size_t size;
+    };
+
+    struct Pool {
+        FreeBlock* freeList = nullptr;
+        Chunk* chunks = nullptr;
+        std::size_t chunkBlocks = minChunkBlocks;
+    };
+
+    // header right before an oversized block, keeps them releasable
+    struct alignas(std::max_align_t) LargeBlock {
+        LargeBlock* prev;
+        LargeBlock* next;
+        void* base;
+        std::size_t size;
+        std::size_t alignment;
+    };
+
+    memory_resource* upstream;
+    pool_options opts;
+    Pool* pools = nullptr;
+    std::size_t poolCount = 0;
+    LargeBlock* larges = nullptr;
+
+public:
+    unsynchronized_pool_resource()
+        : unsynchronized_pool_resource(pool_options{},
+                                       get_default_resource()) {
+    }
+
+    explicit unsynchronized_pool_resource(memory_resource* up)
+        : unsynchronized_pool_resource(pool_options{}, up) {
+    }
+
+    explicit unsynchronized_pool_resource(const pool_options& options)
+        : unsynchronized_pool_resource(options, get_default_resource()) {
+    }
+
+    unsynchronized_pool_resource(const pool_options& options,
+                                 memory_resource* up)
+        : upstream(up), opts(normalize(options)) {
+    }
+
+    unsynchronized_pool_resource(const unsynchronized_pool_resource&) =
+        delete;
+    unsynchronized_pool_resource&
+    operator=(const unsynchronized_pool_resource&) = delete;
+
+    ~unsynchronized_pool_resource() override {
+        release();
+    }
+
+    void release() noexcept {
+        for (std::size_t i = 0; i < poolCount; ++i) {
+            Chunk* chunk = pools[i].chunks;
+            while (chunk != nullptr) {
+                Chunk* next = chunk->next;
+                upstream->deallocate(chunk, chunk->size, alignof(Chunk));
+                chunk = next;
+            }
+        }
+
+        if (pools != nullptr) {
+            upstream->deallocate(pools, poolCount * sizeof(Pool),
+                                 alignof(Pool));
+            pools = nullptr;
+            poolCount = 0;
+        }
+
+        while (larges != nullptr) {
+            LargeBlock* next = larges->next;
+            upstream->deallocate(larges->base, larges->size,
+                                 larges->alignment);
+            larges = next;
+        }
+    }
+
+    memory_resource* upstream_resource() const noexcept {
+        return upstream;
+    }
+
+    pool_options options() const noexcept {
+        return opts;
+    }
+
+private:
+    static pool_options normalize(pool_options options) noexcept {
+        if (options.max_blocks_per_chunk == 0)
+            options.max_blocks_per_chunk = defaultMaxBlocks;
+        if (options.max_blocks_per_chunk < minChunkBlocks)
+            options.max_blocks_per_chunk = minChunkBlocks;
+
+        std::size_t largest = options.largest_required_pool_block;
+        if (largest == 0)
+            largest = defaultLargestBlock;
+        std::size_t block = minBlockSize;
+        while (block < largest)
+            block *= 2;
+        options.largest_required_pool_block = block;
+
+        return options;
+    }
+
+    // pool i holds blocks of minBlockSize << i bytes
+    std::size_t poolIndex(std::size_t blockSize) const noexcept {
+        std::size_t i = 0;
+        for (std::size_t size = minBlockSize; size < blockSize; size *= 2)
+            ++i;
+        return i;
+    }
+
+    void createPools() {
+        std::size_t count = poolIndex(opts.largest_required_pool_block) + 1;
+        void* mem = upstream->allocate(count * sizeof(Pool), alignof(Pool));
+        pools = static_cast<Pool*>(mem);
+        for (std::size_t i = 0; i < count; ++i)
+            details::constructHelper(pools + i);
+        poolCount = count;
+    }
+
+    void refill(Pool& pool, std::size_t blockSize) {
+        std::size_t blocks = pool.chunkBlocks;
+        std::size_t total = sizeof(Chunk) + blocks * blockSize;
+        void* mem = upstream->allocate(total, alignof(Chunk));
+        Chunk* chunk = static_cast<Chunk*>(mem);
+        chunk->next = pool.chunks;
+        chunk->size = total;
+        pool.chunks = chunk;
+
+        // thread the new blocks onto the free list back to front, so the
+        // first allocations walk the chunk in address order
+        char* first = reinterpret_cast<char*>(chunk + 1);
+        for (std::size_t i = blocks; i > 0; --i) {
+            FreeBlock* block =
+                reinterpret_cast<FreeBlock*>(first + (i - 1) * blockSize);
+            block->next = pool.freeList;
+            pool.freeList = block;
+        }
+
+        if (pool.chunkBlocks < opts.max_blocks_per_chunk)
+            pool.chunkBlocks = tiny_stl::min(pool.chunkBlocks * 2,
+                                             opts.max_blocks_per_chunk);
+    }
+
+    void* allocateLarge(std::size_t bytes, std::size_t alignment) {
+        std::size_t align = tiny_stl::max(alignment, alignof(LargeBlock));
+        std::size_t header = details::alignUp(sizeof(LargeBlock), align);
+        if (bytes > std::numeric_limits<std::size_t>::max() - header)
+            throw std::bad_alloc{};
+
+        char* base = static_cast<char*>(upstream->allocate(header + bytes,
+                                                           align));
+        LargeBlock* large = reinterpret_cast<LargeBlock*>(base + header) - 1;
+        large->prev = nullptr;
+        large->next = larges;
+        large->base = base;
+        large->size = header + bytes;
+        large->alignment = align;
+        if (larges != nullptr)
+            larges->prev = large;
+        larges = large;
+
+        return base + header;
+    }
+
+    void deallocateLarge(void* p) noexcept {
+        LargeBlock* large = static_cast<LargeBlock*>(p) - 1;
+        if (large->prev != nullptr)
+            large->prev->next = large->next;
+        else
+            larges = large->next;
+        if (large->next != nullptr)
+            large->next->prev = large->prev;
+
+        upstream->deallocate(large->base, large->size, large->alignment);
+    }
+
+    // blocks are powers of 2 at least as large as the alignment, so
+    // every block in a max_align_t aligned chunk is suitably aligned
+    std::size_t blockSizeOf(std::size_t bytes,
+                            std::size_t alignment) const noexcept {
+        std::size_t size = tiny_stl::max(bytes, alignment);
+        std::size_t block = minBlockSize;
+        while (block < size)
+            block *= 2;
+        return block;
+    }
+
+    bool isPooled(std::size_t bytes, std::size_t alignment) const noexcept {
+        return alignment <= alignof(std::max_align_t) &&
+               bytes <= opts.largest_required_pool_block;
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        assert(details::isPowerOf2(alignment));
+        if (!isPooled(bytes, alignment))
+            return allocateLarge(bytes, alignment);
+
+        if (pools == nullptr)
+            createPools();
+
+        std::size_t blockSize = blockSizeOf(bytes, alignment);
+        Pool& pool = pools[poolIndex(blockSize)];
+        if (pool.freeList == nullptr)
+            refill(pool, blockSize);
+
+        FreeBlock* block = pool.freeList;
+        pool.freeList = block->next;
+        return block;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes,
+                       std::size_t alignment) override {
+        if (!isPooled(bytes, alignment)) {
+            deallocateLarge(p);
+            return;
+        }
+
+        Pool& pool = pools[poolIndex(blockSizeOf(bytes, alignment))];
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = pool.freeList;
+        pool.freeList = block;
+    }
+
+    bool do_is_equal(const memory_resource& rhs) const noexcept override {
+        return this == &rhs;
+    }
+}; // class unsynchronized_pool_resource
+
+// stateful allocator that forwards to a memory_resource, containers that
+// share a resource compare equal and can splice and move nodes
+template <typename T>
+class polymorphic_allocator {
+public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    template <typename U>
+    struct rebind {
+        using other = polymorphic_allocator<U>;
+    };
+
+private:
+    memory_resource* res;
+
+public:
+    polymorphic_allocator() noexcept : res(get_default_resource()) {
+    }
+
+    polymorphic_allocator(memory_resource* r) noexcept : res(r) {
+        assert(r != nullptr);
+    }
+
+    polymorphic_allocator(const polymorphic_allocator&) = default;
+
+    template <typename U>
+    polymorphic_allocator(const polymorphic_allocator<U>& rhs) noexcept
+        : res(rhs.resource()) {
+    }
+
+    // the containers assign allocators under a runtime propagate_* check,
+    // so the assignment has to compile even though it is never taken
+    polymorphic_allocator& operator=(const polymorphic_allocator&) = default;
+
+    T* allocate(std::size_t n) {
+        if (n > max_size())
+            throw std::bad_alloc{};
+        return static_cast<T*>(res->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        res->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    // uses-allocator construction, an element taking a trailing
+    // polymorphic_allocator lives in the same resource as its container
+    template <typename Obj, typename... Args>
+    void construct(Obj* p, Args&&... args) {
+        constructAux(
+            tiny_stl::bool_constant<
+                uses_allocator<Obj, polymorphic_allocator>::value &&
+                is_constructible<Obj, Args...,
+                                 const polymorphic_allocator&>::value>{},
+            p, tiny_stl::forward<Args>(args)...);
+    }
+
+    template <typename Obj>
+    void destroy(Obj* p) {
+        tiny_stl::destroy_at(p);
+    }
+
+    size_type max_size() const noexcept {
+        return std::numeric_limits<std::size_t>::max() / sizeof(T);
+    }
+
+    // a copied container goes back to the default resource
+    polymorphic_allocator select_on_container_copy_construction() const {
+        return polymorphic_allocator();
+    }
+
+    memory_resource* resource() const noexcept {
+        return res;
+    }
+
+private:
+    template <typename Obj, typename... Args>
+    void constructAux(true_type, Obj* p, Args&&... args) {
+        details::constructHelper(p, tiny_stl::forward<Args>(args)..., *this);
+    }
+
+    template <typename Obj, typename... Args>
+    void constructAux(false_type, Obj* p, Args&&... args) {
+        details::constructHelper(p, tiny_stl::forward<Args>(args)...);
+    }
+}; // class polymorphic_allocator<T>
+
+template <typename T, typename U>
+inline bool operator==(const polymorphic_allocator<T>& lhs,
+                       const polymorphic_allocator<U>& rhs) noexcept {
+    return *lhs.resource() == *rhs.resource();
+}
+
+template <typename T, typename U>
+inline bool operator!=(const polymorphic_allocator<T>& lhs,
+                       const polymorphic_allocator<U>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+} // namespace pmr
+
+// only a pointer to the resource
+template <typename T>
+struct is_trivially_relocatable<pmr::polymorphic_allocator<T>> : true_type {};
+
+} // namespace tiny_stl
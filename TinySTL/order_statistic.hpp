@@ -0,0 +1,444 @@
+﻿// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "rbtree.hpp"
+
+namespace tiny_stl {
+
+// set and map whose nodes keep the size of their subtree, nth and rank
+// are O(log n) instead of walking the iterators
+
+template <typename Key, typename Compare = tiny_stl::less<Key>,
+          typename Alloc = tiny_stl::allocator<Key>>
+class order_statistic_set
+    : public RBTree<Key, Compare, Alloc, false, true> {
+public:
+    using allocator_type = Alloc;
+
+private:
+    using Base = RBTree<Key, Compare, allocator_type, false, true>;
+    using AlTraits = allocator_traits<allocator_type>;
+    using AlNode = typename Base::AlNode;
+    using AlNodeTraits = typename Base::AlNodeTraits;
+
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = typename Alloc::size_type;
+    using difference_type = typename Alloc::difference_type;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename AlTraits::pointer;
+    using const_pointer = typename AlTraits::const_pointer;
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+    using reverse_iterator = typename Base::reverse_iterator;
+    using const_reverse_iterator = typename Base::const_reverse_iterator;
+
+public:
+    order_statistic_set() : order_statistic_set(Compare()) {
+    }
+
+    explicit order_statistic_set(const Compare& cmp,
+                                 const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+    }
+
+    explicit order_statistic_set(const Alloc& alloc)
+        : Base(key_compare(), alloc) {
+    }
+
+    template <typename InIter>
+    order_statistic_set(InIter first, InIter last, const key_compare& cmp,
+                        const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_unique(first, last);
+    }
+
+    template <typename InIter>
+    order_statistic_set(InIter first, InIter last, const Alloc& alloc)
+        : Base(key_compare(), alloc) {
+        this->insert_unique(first, last);
+    }
+
+    order_statistic_set(const order_statistic_set& rhs)
+        : Base(rhs, AlTraits::select_on_container_copy_construction(
+                        rhs.get_allocator())) {
+    }
+
+    order_statistic_set(const order_statistic_set& rhs, const Alloc& alloc)
+        : Base(rhs, alloc) {
+    }
+
+    order_statistic_set(order_statistic_set&& rhs)
+        : Base(tiny_stl::move(rhs)) {
+    }
+
+    order_statistic_set(order_statistic_set&& rhs, const Alloc& alloc)
+        : Base(tiny_stl::move(rhs), alloc) {
+    }
+
+    order_statistic_set(std::initializer_list<value_type> ilist,
+                        const Compare& cmp = Compare(),
+                        const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_unique(ilist.begin(), ilist.end());
+    }
+
+    order_statistic_set(std::initializer_list<value_type> ilist,
+                        const Alloc& alloc)
+        : order_statistic_set(ilist, Compare(), alloc) {
+    }
+
+    order_statistic_set& operator=(const order_statistic_set& rhs) {
+        Base::operator=(rhs);
+        return *this;
+    }
+
+    order_statistic_set& operator=(order_statistic_set&& rhs) {
+        Base::operator=(tiny_stl::move(rhs));
+        return *this;
+    }
+
+    order_statistic_set& operator=(std::initializer_list<value_type> ilist) {
+        order_statistic_set tmp(ilist);
+        this->swap(tmp);
+        return *this;
+    }
+
+    pair<iterator, bool> insert(const value_type& val) {
+        return this->insert_unique(val);
+    }
+
+    pair<iterator, bool> insert(value_type&& val) {
+        return this->insert_unique(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert(InIter first, InIter last) {
+        this->insert_unique(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        this->insert_unique(ilist.begin(), ilist.end());
+    }
+
+    iterator insert(const_iterator hint, const value_type& val) {
+        return this->insert_unique(hint, val);
+    }
+
+    iterator insert(const_iterator hint, value_type&& val) {
+        return this->insert_unique(hint, tiny_stl::move(val));
+    }
+
+    template <typename Range>
+    void insert_range(Range&& rg) {
+        this->insert_unique(rg.begin(), rg.end());
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+        return this->emplace_unique(tiny_stl::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args) {
+        return this->emplace_hint_unique(hint,
+                                         tiny_stl::forward<Args>(args)...);
+    }
+
+    // the k-th smallest value, end() if k >= size()
+    iterator nth(size_type k) {
+        return iterator(this->nthAux(k));
+    }
+
+    const_iterator nth(size_type k) const {
+        return const_iterator(this->nthAux(k));
+    }
+
+    // the number of the values less than key
+    size_type rank(const key_type& key) const {
+        return this->rankAux(key);
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    size_type rank(const K& key) const {
+        return this->rankAux(key);
+    }
+
+    void swap(order_statistic_set& rhs) {
+        Base::swap(rhs);
+    }
+
+    key_compare key_comp() const {
+        return key_compare{};
+    }
+
+    value_compare value_comp() const {
+        return value_compare{};
+    }
+}; // order_statistic_set
+
+template <typename Key, typename Compare, typename Alloc>
+inline void
+swap(order_statistic_set<Key, Compare, Alloc>& lhs,
+     order_statistic_set<Key, Compare, Alloc>& rhs)
+    noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+template <typename Key, typename T, typename Compare = less<Key>,
+          typename Alloc = allocator<pair<Key, T>>>
+class order_statistic_map
+    : public RBTree<pair<Key, T>, Compare, Alloc, true, true> {
+public:
+    using allocator_type = Alloc;
+
+private:
+    using Base = RBTree<pair<Key, T>, Compare, Alloc, true, true>;
+    using AlTraits = allocator_traits<allocator_type>;
+    using AlNode = typename Base::AlNode;
+    using AlNodeTraits = typename Base::AlNodeTraits;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = pair<const Key, T>;
+    using size_type = typename Alloc::size_type;
+    using difference_type = typename Alloc::difference_type;
+    using key_compare = Compare;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename AlTraits::pointer;
+    using const_pointer = typename AlTraits::const_pointer;
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+    using reverse_iterator = typename Base::reverse_iterator;
+    using const_reverse_iterator = typename Base::const_reverse_iterator;
+
+public:
+    class value_compare {
+        friend order_statistic_map;
+
+    protected:
+        Compare mCmp;
+
+        value_compare(Compare c) : mCmp(c) {
+        }
+
+    public:
+        bool operator()(const value_type& lhs, const value_type& rhs) const {
+            return mCmp(lhs.first, rhs.first);
+        }
+    };
+
+public:
+    order_statistic_map() : order_statistic_map(Compare()) {
+    }
+
+    explicit order_statistic_map(const Compare& cmp,
+                                 const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+    }
+
+    explicit order_statistic_map(const Alloc& alloc) : Base(Compare(), alloc) {
+    }
+
+    template <typename InIter>
+    order_statistic_map(InIter first, InIter last,
+                        const Compare& cmp = Compare(),
+                        const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_unique(first, last);
+    }
+
+    template <typename InIter>
+    order_statistic_map(InIter first, InIter last, const Alloc& alloc)
+        : Base(Compare(), alloc) {
+        this->insert_unique(first, last);
+    }
+
+    order_statistic_map(const order_statistic_map& rhs)
+        : Base(rhs, AlTraits::select_on_container_copy_construction(
+                        rhs.get_allocator())) {
+    }
+
+    order_statistic_map(const order_statistic_map& rhs, const Alloc& alloc)
+        : Base(rhs, alloc) {
+    }
+
+    order_statistic_map(order_statistic_map&& rhs) noexcept
+        : Base(tiny_stl::move(rhs)) {
+    }
+
+    order_statistic_map(order_statistic_map&& rhs, const Alloc& alloc)
+        : Base(tiny_stl::move(rhs), alloc) {
+    }
+
+    order_statistic_map(std::initializer_list<value_type> ilist,
+                        const Compare& cmp = Compare(),
+                        const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+        this->insert_unique(ilist.begin(), ilist.end());
+    }
+
+    order_statistic_map(std::initializer_list<value_type> ilist,
+                        const Alloc& alloc)
+        : order_statistic_map(ilist, Compare(), alloc) {
+    }
+
+    order_statistic_map& operator=(const order_statistic_map& rhs) {
+        Base::operator=(rhs);
+        return *this;
+    }
+
+    order_statistic_map& operator=(order_statistic_map&& rhs) {
+        Base::operator=(tiny_stl::move(rhs));
+        return *this;
+    }
+
+    order_statistic_map& operator=(std::initializer_list<value_type> ilist) {
+        order_statistic_map tmp(ilist);
+        this->swap(tmp);
+        return *this;
+    }
+
+    T& at(const Key& key) {
+        iterator pos = this->find(key);
+        if (pos == this->end())
+            xRange();
+
+        return pos->second;
+    }
+
+    const T& at(const Key& key) const {
+        const_iterator pos = this->find(key);
+        if (pos == this->end())
+            xRange();
+
+        return pos->second;
+    }
+
+    T& operator[](const Key& key) {
+        iterator pos = this->find(key);
+        if (pos == this->end())
+            return this->insert(tiny_stl::make_pair(key, T{})).first->second;
+
+        return pos->second;
+    }
+
+    T& operator[](Key&& key) {
+        iterator pos = this->find(key);
+        if (pos == this->end())
+            return this->insert(tiny_stl::make_pair(tiny_stl::move(key), T{}))
+                .first->second;
+
+        return pos->second;
+    }
+
+    pair<iterator, bool> insert(const value_type& val) {
+        return this->insert_unique(val);
+    }
+
+    template <typename P,
+              typename = enable_if_t<is_constructible<value_type, P&&>::value>>
+    pair<iterator, bool> insert(P&& val) {
+        return this->insert_unique(tiny_stl::forward<P>(val));
+    }
+
+    pair<iterator, bool> insert(value_type&& val) {
+        return this->insert_unique(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert(InIter first, InIter last) {
+        this->insert_unique(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        this->insert_unique(ilist.begin(), ilist.end());
+    }
+
+    iterator insert(const_iterator hint, const value_type& val) {
+        return this->insert_unique(hint, val);
+    }
+
+    template <typename P,
+              typename = enable_if_t<is_constructible<value_type, P&&>::value>>
+    iterator insert(const_iterator hint, P&& val) {
+        return this->insert_unique(hint, tiny_stl::forward<P>(val));
+    }
+
+    iterator insert(const_iterator hint, value_type&& val) {
+        return this->insert_unique(hint, tiny_stl::move(val));
+    }
+
+    template <typename Range>
+    void insert_range(Range&& rg) {
+        this->insert_unique(rg.begin(), rg.end());
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+        return this->emplace_unique(tiny_stl::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args) {
+        return this->emplace_hint_unique(hint,
+                                         tiny_stl::forward<Args>(args)...);
+    }
+
+    // the k-th smallest value, end() if k >= size()
+    iterator nth(size_type k) {
+        return iterator(this->nthAux(k));
+    }
+
+    const_iterator nth(size_type k) const {
+        return const_iterator(this->nthAux(k));
+    }
+
+    // the number of the values less than key
+    size_type rank(const key_type& key) const {
+        return this->rankAux(key);
+    }
+
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    size_type rank(const K& key) const {
+        return this->rankAux(key);
+    }
+
+    void swap(order_statistic_map& rhs) {
+        Base::swap(rhs);
+    }
+
+    key_compare key_comp() const {
+        return key_compare{};
+    }
+
+    value_compare value_comp() const {
+        return value_compare{key_comp()};
+    }
+
+private:
+    [[noreturn]] static void xRange() {
+        throw "order_statistic_map<Key, T>, key is not exist";
+    }
+}; // order_statistic_map
+
+template <typename Key, typename T, typename Cmp, typename Alloc>
+inline void
+swap(order_statistic_map<Key, T, Cmp, Alloc>& lhs,
+     order_statistic_map<Key, T, Cmp, Alloc>& rhs)
+    noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+} // namespace tiny_stl
@@ -0,0 +1,238 @@
+﻿// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <new>
+
+#include "allocators.hpp"
+
+namespace tiny_stl {
+
+namespace details {
+
+// Free list allocator of one block size. Blocks are carved out of slabs,
+// freed blocks are pushed to the free list and reused. Slabs are never
+// returned to the system, same as the SGI node allocator, so a block may
+// be freed by any container of any thread.
+class NodePool {
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // slab header, keeps the slab chain reachable
+    struct alignas(std::max_align_t) Slab {
+        Slab* next;
+    };
+
+    static constexpr std::size_t minSlabBlocks = 32;
+    static constexpr std::size_t maxSlabBlocks = 4096;
+
+    FreeBlock* freeList = nullptr;
+    char* cur = nullptr;
+    char* last = nullptr;
+    Slab* slabs = nullptr;
+    std::size_t blockSize;
+    std::size_t slabBlocks = minSlabBlocks;
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+
+    void acquire() noexcept {
+        while (lock.test_and_set(std::memory_order_acquire)) {
+            // spin, the critical sections are a few instructions
+        }
+    }
+
+    void release() noexcept {
+        lock.clear(std::memory_order_release);
+    }
+
+    // the next slab doubles the block count
+    void refill() {
+        void* mem = ::operator new(sizeof(Slab) + blockSize * slabBlocks);
+        Slab* slab = static_cast<Slab*>(mem);
+        slab->next = slabs;
+        slabs = slab;
+        cur = reinterpret_cast<char*>(slab + 1);
+        last = cur + blockSize * slabBlocks;
+        if (slabBlocks < maxSlabBlocks)
+            slabBlocks *= 2;
+    }
+
+public:
+    explicit NodePool(std::size_t size) noexcept : blockSize(size) {
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    void* allocate() {
+        acquire();
+        void* p = nullptr;
+        if (freeList != nullptr) {
+            p = freeList;
+            freeList = freeList->next;
+        } else {
+            if (cur == last) {
+                try {
+                    refill();
+                } catch (...) {
+                    release();
+                    throw;
+                }
+            }
+
+            p = cur;
+            cur += blockSize;
+        }
+        release();
+
+        return p;
+    }
+
+    void deallocate(void* p) noexcept {
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        acquire();
+        block->next = freeList;
+        freeList = block;
+        release();
+    }
+}; // class NodePool
+
+// larger objects are not nodes, use operator new
+constexpr std::size_t poolMaxBlockSize = 256;
+
+constexpr std::size_t poolRoundUp(std::size_t n, std::size_t align) {
+    return (n + align - 1) / align * align;
+}
+
+// a block holds an object of T or a free list pointer
+template <typename T>
+constexpr std::size_t poolBlockSize() {
+    return poolRoundUp(
+        sizeof(T) > sizeof(void*) ? sizeof(T) : sizeof(void*),
+        alignof(T) > alignof(void*) ? alignof(T) : alignof(void*));
+}
+
+// one pool per block size, shared by every pool_allocator<T> with the same
+// block size. The pool is leaked on purpose, static objects may still
+// free nodes after it would have been destroyed
+template <std::size_t BlockSize>
+inline NodePool& nodePool() {
+    static NodePool* pool = new NodePool(BlockSize);
+    return *pool;
+}
+
+} // namespace details
+
+// allocator for node based containers (list, forward_list, map, set,
+// unordered_*), single objects come from a size class pool, arrays and
+// large objects from operator new
+template <typename T>
+class pool_allocator {
+public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using propagate_on_container_move_assignment = tiny_stl::true_type;
+    using is_always_equal = tiny_stl::true_type;
+
+private:
+    static constexpr std::size_t blockSize = details::poolBlockSize<T>();
+    static constexpr bool usePool = blockSize <= details::poolMaxBlockSize &&
+                                    alignof(T) <= alignof(std::max_align_t);
+
+public:
+    pool_allocator() noexcept {
+    }
+
+    pool_allocator(const pool_allocator&) noexcept {
+    }
+
+    template <typename Other>
+    pool_allocator(const pool_allocator<Other>&) noexcept {
+    }
+
+    template <typename Other>
+    pool_allocator& operator=(const pool_allocator<Other>&) noexcept {
+        return *this;
+    }
+
+    template <typename U>
+    struct rebind {
+        using other = pool_allocator<U>;
+    };
+
+    pointer allocate(size_type n) {
+        if (usePool && n == 1)
+            return static_cast<pointer>(
+                details::nodePool<blockSize>().allocate());
+
+        if (n > max_size())
+            throw std::bad_alloc{};
+
+        return static_cast<pointer>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(pointer p, size_type n) noexcept {
+        if (usePool && n == 1)
+            details::nodePool<blockSize>().deallocate(p);
+        else
+            ::operator delete(p);
+    }
+
+    pointer address(reference x) const noexcept {
+        return tiny_stl::addressof(x);
+    }
+
+    const_pointer address(const_reference x) const noexcept {
+        return tiny_stl::addressof(x);
+    }
+
+    template <typename Obj, typename... Args>
+    void construct(Obj* p, Args&&... args) {
+        details::constructHelper(p, tiny_stl::forward<Args>(args)...);
+    }
+
+    template <typename Obj>
+    void destroy(Obj* ptr) {
+        tiny_stl::destroy_at(ptr);
+    }
+
+    size_type max_size() const noexcept {
+        return (std::numeric_limits<std::size_t>::max() / sizeof(T));
+    }
+}; // class pool_allocator<T>
+
+// the pools are shared per block size, the allocator itself is stateless
+template <typename T>
+struct is_trivially_relocatable<pool_allocator<T>> : true_type {};
+
+template <typename T>
+constexpr std::size_t pool_allocator<T>::blockSize;
+
+template <typename T>
+constexpr bool pool_allocator<T>::usePool;
+
+template <typename T, typename U>
+inline bool operator==(const pool_allocator<T>&,
+                       const pool_allocator<U>&) noexcept {
+    return true;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const pool_allocator<T>& lhs,
+                       const pool_allocator<U>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+} // namespace tiny_stl
@@ -7,6 +7,7 @@
 #include <initializer_list>
 
 #include "memory.hpp"
+#include "vector.hpp"
 
 namespace tiny_stl {
 
@@ -14,8 +15,15 @@ namespace {
 
 enum class Color : uint16_t { RED, BLACK };
 
-template <typename T>
-struct RBTNode {
+struct RBTNodeNoSize {};
+
+// the number of nodes in the subtree, for the order statistic tree
+struct RBTNodeSize {
+    std::size_t size;
+};
+
+template <typename T, bool counted = false>
+struct RBTNode : conditional_t<counted, RBTNodeSize, RBTNodeNoSize> {
     using IsNil = uint16_t;
     Color color;
     IsNil isNil; // 1 is nil, 0 is not nil
@@ -25,16 +33,57 @@ struct RBTNode {
     T value;
 };
 
+// the subtree sizes are only kept by the counted nodes, the nil node is 0
+template <typename T>
+inline void rbTreeSetSize(RBTNode<T, false>*, std::size_t) noexcept {
+}
+
 template <typename T>
-inline RBTNode<T>* rbTreeMinValue(RBTNode<T>* ptr) {
+inline void rbTreeSetSize(RBTNode<T, true>* ptr, std::size_t n) noexcept {
+    ptr->size = n;
+}
+
+template <typename T>
+inline void rbTreeUpdateSize(RBTNode<T, false>*) noexcept {
+}
+
+template <typename T>
+inline void rbTreeUpdateSize(RBTNode<T, true>* ptr) noexcept {
+    ptr->size = ptr->left->size + ptr->right->size + 1;
+}
+
+// a node is linked below ptr
+template <typename T>
+inline void rbTreeIncreasePath(RBTNode<T, false>*) noexcept {
+}
+
+template <typename T>
+inline void rbTreeIncreasePath(RBTNode<T, true>* ptr) noexcept {
+    for (; !ptr->isNil; ptr = ptr->parent)
+        ++ptr->size;
+}
+
+// a node is unlinked below ptr
+template <typename T>
+inline void rbTreeDecreasePath(RBTNode<T, false>*) noexcept {
+}
+
+template <typename T>
+inline void rbTreeDecreasePath(RBTNode<T, true>* ptr) noexcept {
+    for (; !ptr->isNil; ptr = ptr->parent)
+        --ptr->size;
+}
+
+template <typename NodePtr>
+inline NodePtr rbTreeMinValue(NodePtr ptr) {
     while (!ptr->left->isNil)
         ptr = ptr->left;
 
     return ptr;
 }
 
-template <typename T>
-inline RBTNode<T>* rbTreeMaxValue(RBTNode<T>* ptr) {
+template <typename NodePtr>
+inline NodePtr rbTreeMaxValue(NodePtr ptr) {
     while (!ptr->right->isNil)
         ptr = ptr->right;
 
@@ -49,9 +98,9 @@ inline RBTNode<T>* rbTreeMaxValue(RBTNode<T>* ptr) {
 //         ↙  ↘                       ↙ ↘
 //         b    c                      a    b
 //
-template <typename T>
-inline void rbTreeLeftRotate(RBTNode<T>*& root, RBTNode<T>* x) {
-    RBTNode<T>* y = x->right;
+template <typename NodePtr>
+inline void rbTreeLeftRotate(NodePtr& root, NodePtr x) {
+    NodePtr y = x->right;
 
     x->right = y->left;
     if (!y->left->isNil)
@@ -68,6 +117,9 @@ inline void rbTreeLeftRotate(RBTNode<T>*& root, RBTNode<T>* x) {
 
     x->parent = y;
     y->left = x;
+
+    rbTreeUpdateSize(x);
+    rbTreeUpdateSize(y);
 }
 
 //        |                                 |
@@ -77,9 +129,9 @@ inline void rbTreeLeftRotate(RBTNode<T>*& root, RBTNode<T>* x) {
 //   ↙ ↘                                   ↙ ↘
 //  a    b                                  b    c
 //
-template <typename T>
-inline void rbTreeRightRotate(RBTNode<T>*& root, RBTNode<T>* y) {
-    RBTNode<T>* x = y->left;
+template <typename NodePtr>
+inline void rbTreeRightRotate(NodePtr& root, NodePtr y) {
+    NodePtr x = y->left;
 
     y->left = x->right;
     if (!x->right->isNil)
@@ -96,11 +148,14 @@ inline void rbTreeRightRotate(RBTNode<T>*& root, RBTNode<T>* y) {
 
     x->right = y;
     y->parent = x;
+
+    rbTreeUpdateSize(y);
+    rbTreeUpdateSize(x);
 }
 
 } // namespace
 
-template <typename T>
+template <typename T, bool counted = false>
 struct RBTreeConstIterator {
     using iterator_category = bidirectional_iterator_tag;
     using value_type = T;
@@ -108,7 +163,7 @@ struct RBTreeConstIterator {
     using pointer = const T*;
     using reference = const T&;
 
-    using Ptr = RBTNode<T>*;
+    using Ptr = RBTNode<T, counted>*;
 
     Ptr ptr = nullptr;
 
@@ -184,16 +239,16 @@ struct RBTreeConstIterator {
 
 }; // RBTreeConstIterator
 
-template <typename T>
-struct RBTreeIterator : RBTreeConstIterator<T> {
+template <typename T, bool counted = false>
+struct RBTreeIterator : RBTreeConstIterator<T, counted> {
     using iterator_category = bidirectional_iterator_tag;
     using value_type = T;
     using difference_type = std::ptrdiff_t;
     using pointer = T*;
     using reference = T&;
 
-    using Ptr = RBTNode<T>*;
-    using Base = RBTreeConstIterator<T>;
+    using Ptr = RBTNode<T, counted>*;
+    using Base = RBTreeConstIterator<T, counted>;
 
     RBTreeIterator() : Base() {
     }
@@ -233,7 +288,7 @@ struct RBTreeIterator : RBTreeConstIterator<T> {
     }
 }; // RBTreeIterator
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, bool counted>
 class RBTreeBase {
 public:
     using value_type = T;
@@ -243,8 +298,8 @@ public:
 
 private:
     using AlTraits = allocator_traits<Alloc>;
-    using Node = RBTNode<T>;
-    using NodePtr = RBTNode<T>*;
+    using Node = RBTNode<T, counted>;
+    using NodePtr = RBTNode<T, counted>*;
     using AlNode = typename AlTraits::template rebind_alloc<Node>;
     using AlNodeTraits = allocator_traits<AlNode>;
 
@@ -253,9 +308,17 @@ protected:
     size_type mCount;
     AlNode alloc;
     Compare compare;
+    // nodes of a bulk build, allocated at once and freed by clear(). the
+    // erased ones wait in freeNodes (linked by parent) for later inserts,
+    // their memory is not given back before clear() or the destructor
+    NodePtr block;
+    size_type blockSize;
+    NodePtr freeNodes;
 
 public:
-    RBTreeBase() : mCount(0), alloc(), compare() {
+    RBTreeBase()
+        : mCount(0), alloc(), compare(), block(nullptr), blockSize(0),
+          freeNodes(nullptr) {
         createHeaderNode();
     }
 
@@ -264,7 +327,7 @@ public:
         typename = enable_if_t<!is_same<decay_t<Any_alloc>, RBTreeBase>::value>>
     RBTreeBase(const Compare& cmp, Any_alloc&& anyAlloc)
         : mCount(0), alloc(tiny_stl::forward<Any_alloc>(anyAlloc)),
-          compare(cmp) {
+          compare(cmp), block(nullptr), blockSize(0), freeNodes(nullptr) {
         createHeaderNode();
     }
 
@@ -281,6 +344,7 @@ private:
             header->parent = header;
             header->isNil = 1;
             header->color = Color::BLACK;
+            rbTreeSetSize(header, 0);
         } catch (...) {
             alloc.deallocate(header, 1);
             throw;
@@ -288,8 +352,10 @@ private:
     }
 }; // RBTreeBase
 
-template <typename T, typename Compare, typename Alloc, bool isMap>
-class RBTree : public RBTreeBase<T, Compare, Alloc> {
+// counted keeps the subtree sizes for nthAux and rankAux
+template <typename T, typename Compare, typename Alloc, bool isMap,
+          bool counted = false>
+class RBTree : public RBTreeBase<T, Compare, Alloc, counted> {
 public:
     using key_type = typename AssociatedTypeHelper<T, isMap>::key_type;
     using mapped_type = typename AssociatedTypeHelper<T, isMap>::mapped_type;
@@ -304,33 +370,64 @@ public:
     using const_pointer = const value_type*;
 
     using AlTraits = allocator_traits<Alloc>;
-    using Node = RBTNode<value_type>;
-    using NodePtr = RBTNode<value_type>*;
+    using Node = RBTNode<value_type, counted>;
+    using NodePtr = RBTNode<value_type, counted>*;
     using AlNode = typename AlTraits::template rebind_alloc<Node>;
     using AlNodeTraits = allocator_traits<AlNode>;
-    using Base = RBTreeBase<value_type, Compare, Alloc>;
+    using Base = RBTreeBase<value_type, Compare, Alloc, counted>;
 
-    using iterator = RBTreeIterator<value_type>;
-    using const_iterator = RBTreeConstIterator<value_type>;
+    using iterator = RBTreeIterator<value_type, counted>;
+    using const_iterator = RBTreeConstIterator<value_type, counted>;
     using reverse_iterator = tiny_stl::reverse_iterator<iterator>;
     using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>;
 
 private:
-    template <typename... Args>
-    NodePtr allocAndConstruct(Args&&... args) {
-        NodePtr p = this->alloc.allocate(1);
+    // p may come from a different allocation than the block
+    bool inBlock(NodePtr p) const noexcept {
+        const tiny_stl::less<NodePtr> ptrLess;
+        return this->block != nullptr && !ptrLess(p, this->block) &&
+               ptrLess(p, this->block + this->blockSize);
+    }
+
+    NodePtr getNode() {
+        NodePtr p = this->freeNodes;
+        if (p == nullptr)
+            return this->alloc.allocate(1);
+
+        this->freeNodes = p->parent;
+        return p;
+    }
 
+    void putNode(NodePtr p) noexcept {
+        if (inBlock(p)) {
+            p->parent = this->freeNodes;
+            this->freeNodes = p;
+        } else {
+            this->alloc.deallocate(p, 1);
+        }
+    }
+
+    template <typename... Args>
+    void constructNode(NodePtr p, Args&&... args) {
         p->color = Color::RED;
         p->isNil = 0;
         p->parent = this->header;
         p->left = this->header;
         p->right = this->header;
+        rbTreeSetSize(p, 1);
+
+        this->alloc.construct(tiny_stl::addressof(p->value),
+                              tiny_stl::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    NodePtr allocAndConstruct(Args&&... args) {
+        NodePtr p = getNode();
 
         try {
-            this->alloc.construct(tiny_stl::addressof(p->value),
-                                  tiny_stl::forward<Args>(args)...);
+            constructNode(p, tiny_stl::forward<Args>(args)...);
         } catch (...) {
-            this->alloc.deallocate(p, 1);
+            putNode(p);
             throw;
         }
 
@@ -340,7 +437,7 @@ private:
     void destroyAndFree(NodePtr p) {
         if (p != nullptr) {
             this->alloc.destroy(tiny_stl::addressof(p->value));
-            this->alloc.deallocate(p, 1);
+            putNode(p);
         }
     }
 
@@ -430,6 +527,7 @@ private:
 
             p->left = copyNodes(rhsRoot->left, p);
             p->right = copyNodes(rhsRoot->right, p);
+            rbTreeUpdateSize(p);
         }
 
         return newheader;
@@ -448,10 +546,17 @@ private:
         }
     }
 
-    void moveAux(RBTree&& rhs) {
-        tiny_stl::swapADL(this->compare, rhs.compare);
+    void swapNodes(RBTree& rhs) noexcept {
         tiny_stl::swapADL(this->header, rhs.header);
         tiny_stl::swapADL(this->mCount, rhs.mCount);
+        tiny_stl::swapADL(this->block, rhs.block);
+        tiny_stl::swapADL(this->blockSize, rhs.blockSize);
+        tiny_stl::swapADL(this->freeNodes, rhs.freeNodes);
+    }
+
+    void moveAux(RBTree&& rhs) {
+        tiny_stl::swapADL(this->compare, rhs.compare);
+        swapNodes(rhs);
     }
 
     void rbTreeFixupForInsert(NodePtr& root, NodePtr z) {
@@ -639,7 +744,7 @@ public:
     template <typename K, typename Cmp = Compare,
               typename = typename Cmp::is_transparent>
     const_iterator lower_bound(const K& val) const {
-        return iterator(lowBoundAux(val));
+        return const_iterator(lowBoundAux(val));
     }
 
     iterator upper_bound(const key_type& val) {
@@ -688,7 +793,8 @@ public:
         return tiny_stl::distance(range.first, range.second);
     }
 
-    template <typename K>
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
     size_type count(const K& key) const {
         pair<const_iterator, const_iterator> range = equal_range(key);
         return tiny_stl::distance(range.first, range.second);
@@ -717,46 +823,67 @@ public:
     template <typename K, typename Cmp = Compare,
               typename = typename Cmp::is_transparent>
     const_iterator find(const K& val) const {
-        iterator pos = lower_bound(val);
+        const_iterator pos = lower_bound(val);
         return (pos == end() || this->compare(val, get_key(pos.ptr))) ? end()
                                                                       : pos;
     }
 
-private:
-    iterator insertAux(NodePtr z) {
-        NodePtr x = getRoot();
-        NodePtr y = this->header;
-
-        if (y->left->isNil || this->compare(get_key(z), get_key(y->left)))
-            y->left = z;
+    bool contains(const key_type& key) const {
+        return find(key) != end();
+    }
 
-        if (y->right->isNil || !this->compare(get_key(z), get_key(y->right)))
-            y->right = z;
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
 
+private:
+    // the parent of key in the subtree x, equivalent keys go to the right.
+    // for unique, an equivalent node is returned in dup instead
+    NodePtr insertPos(NodePtr x, const key_type& key, bool unique,
+                      bool& left, NodePtr& dup) const {
+        NodePtr y = this->header;
+        left = true;
         while (!x->isNil) {
             y = x;
-            if (this->compare(get_key(z), get_key(x)))
-                x = x->left;
-            else
-                x = x->right;
+            left = this->compare(key, get_key(x));
+            x = left ? x->left : x->right;
+        }
+
+        if (unique) {
+            NodePtr prev = y;
+            if (left)
+                prev = y == this->header->left ? nullptr
+                                               : (--const_iterator(y)).ptr;
+            if (prev != nullptr && !this->compare(get_key(prev), key)) {
+                dup = prev;
+                return nullptr;
+            }
         }
 
-        z->parent = y;
+        return y;
+    }
 
-        if (y->isNil) {
+    // links z as a child of parent and rebalances
+    iterator linkNode(NodePtr z, NodePtr parent, bool left) {
+        z->parent = parent;
+
+        if (parent->isNil) {
             getRoot() = z;
             this->header->left = z;
             this->header->right = z;
-        } else if (this->compare(get_key(z), get_key(y))) {
-            y->left = z;
-            if (this->compare(get_key(z), get_key(this->header->left)))
+        } else if (left) {
+            parent->left = z;
+            if (parent == this->header->left)
                 this->header->left = z; // z.key < min_value
         } else {
-            y->right = z;
-            if (!this->compare(get_key(z), get_key(this->header->right)))
+            parent->right = z;
+            if (parent == this->header->right)
                 this->header->right = z; // z.key >= max_value
         }
 
+        rbTreeIncreasePath(parent);
         rbTreeFixupForInsert(getRoot(), z);
 
         ++this->mCount;
@@ -764,26 +891,369 @@ private:
         return iterator(z);
     }
 
+    iterator insertAux(NodePtr z) {
+        bool left;
+        NodePtr dup = nullptr;
+        NodePtr parent = insertPos(getRoot(), get_key(z), false, left, dup);
+
+        return linkNode(z, parent, left);
+    }
+
+    // z is freed if its key is in the tree
+    pair<iterator, bool> insertUniqueNode(NodePtr z) {
+        bool left;
+        NodePtr dup = nullptr;
+        NodePtr parent = insertPos(getRoot(), get_key(z), true, left, dup);
+        if (dup != nullptr) {
+            destroyAndFree(z);
+            return tiny_stl::make_pair(iterator(dup), false);
+        }
+
+        return tiny_stl::make_pair(linkNode(z, parent, left), true);
+    }
+
     template <typename Value>
     iterator insertEqualAux(Value&& val) {
         NodePtr z = allocAndConstruct(tiny_stl::forward<Value>(val));
         return insertAux(z);
     }
 
+    // one descent finds both the parent and the equivalent key, no node is
+    // allocated for a key in the tree
     template <typename Value>
-    pair<iterator, bool> insertUniqueAux(Value&& val) {
-        T value(tiny_stl::forward<Value>(val));
-        iterator pos = find(getKeyFromValue(val));
+    pair<iterator, bool> insertUniqueAux(const key_type& key, Value&& val) {
+        bool left;
+        NodePtr dup = nullptr;
+        NodePtr parent = insertPos(getRoot(), key, true, left, dup);
+        if (dup != nullptr)
+            return tiny_stl::make_pair(iterator(dup), false);
+
+        NodePtr z = allocAndConstruct(tiny_stl::forward<Value>(val));
+        return tiny_stl::make_pair(linkNode(z, parent, left), true);
+    }
+
+    pair<iterator, bool> insertUniqueAux(const T& val) {
+        return insertUniqueAux(getKeyFromValue(val), val);
+    }
+
+    pair<iterator, bool> insertUniqueAux(T&& val) {
+        return insertUniqueAux(getKeyFromValue(val), tiny_stl::move(val));
+    }
+
+    // a goes before b, equivalent keys go after the existing ones
+    bool keyBefore(const key_type& a, const key_type& b, bool unique) const {
+        return unique ? this->compare(a, b) : !this->compare(b, a);
+    }
+
+    // the parent of key if it goes right before hint, or right after it,
+    // O(1) amortized. nullptr if it does not, then the caller descends
+    // from the root. for unique, an adjacent equivalent node is returned
+    // in dup
+    NodePtr hintPos(NodePtr hint, const key_type& key, bool unique,
+                    bool& left, NodePtr& dup) const {
+        left = false;
+        if (hint->isNil) { // end()
+            if (this->mCount == 0) {
+                left = true;
+                return this->header;
+            }
 
-        if (pos != end()) {
-            return make_pair(pos, false);
+            NodePtr last = this->header->right;
+            if (keyBefore(get_key(last), key, unique))
+                return last;
+            if (unique && !this->compare(key, get_key(last)))
+                dup = last;
+            return nullptr;
         }
 
-        NodePtr z = allocAndConstruct(tiny_stl::move(value));
-        return make_pair(insertAux(z), true);
+        if (keyBefore(key, get_key(hint), unique)) {
+            if (hint == this->header->left) {
+                left = true;
+                return hint;
+            }
+
+            NodePtr prev = (--const_iterator(hint)).ptr;
+            if (keyBefore(get_key(prev), key, unique)) {
+                // one of prev->right and hint->left is nil
+                if (prev->right->isNil)
+                    return prev;
+                left = true;
+                return hint;
+            }
+            if (unique && !this->compare(key, get_key(prev)))
+                dup = prev;
+            return nullptr;
+        }
+
+        if (unique && !this->compare(get_key(hint), key)) {
+            dup = hint;
+            return nullptr;
+        }
+
+        if (hint == this->header->right)
+            return hint;
+
+        NodePtr next = (++const_iterator(hint)).ptr;
+        if (keyBefore(key, get_key(next), unique)) {
+            if (hint->right->isNil)
+                return hint;
+            left = true;
+            return next;
+        }
+        if (unique && !this->compare(get_key(next), key))
+            dup = next;
+        return nullptr;
+    }
+
+    // z is freed if unique and its key is in the tree
+    iterator insertHintNode(NodePtr hint, NodePtr z, bool unique) {
+        bool left;
+        NodePtr dup = nullptr;
+        NodePtr parent = hintPos(hint, get_key(z), unique, left, dup);
+        if (parent != nullptr)
+            return linkNode(z, parent, left);
+
+        if (dup != nullptr) {
+            destroyAndFree(z);
+            return iterator(dup);
+        }
+
+        return unique ? insertUniqueNode(z).first : insertAux(z);
+    }
+
+    // the hinted inserts of map, set and order_statistic end here.
+    // O(1) amortized if val goes right before or after hint
+    template <typename Value>
+    iterator insertHintAux(const_iterator hint, Value&& val, bool unique) {
+        NodePtr z = allocAndConstruct(tiny_stl::forward<Value>(val));
+        return insertHintNode(hint.ptr, z, unique);
+    }
+
+    // the parent of key, which is not less than the key of finger. climbs
+    // from finger to the smallest subtree that holds the key, the walk is
+    // O(log d) amortized for d nodes between finger and the key
+    NodePtr fingerPos(NodePtr finger, const key_type& key, bool unique,
+                      bool& left, NodePtr& dup) const {
+        if (unique && !this->compare(get_key(finger), key)) {
+            dup = finger;
+            return nullptr;
+        }
+
+        // right after finger, equivalent keys still go after the existing
+        // ones as insertAux does
+        const NodePtr next = finger == this->header->right
+                                 ? this->header
+                                 : (++const_iterator(finger)).ptr;
+        if (next->isNil || this->compare(key, get_key(next))) {
+            // one of finger->right and next->left is nil
+            left = !finger->right->isNil;
+            return left ? next : finger;
+        }
+
+        NodePtr x = finger;
+        while (x != getRoot()) {
+            NodePtr p = x->parent;
+            if (x == p->left && this->compare(key, get_key(p)))
+                break;
+            x = p;
+        }
+
+        return insertPos(x, key, unique, left, dup);
+    }
+
+    // constructs the nodes of the batch, sorts them and links them from
+    // left to right, each one is searched from the one linked before it.
+    // an ascending batch costs O(1) amortized per value
+    template <typename InIter>
+    void insertBatch(InIter first, InIter last, bool unique) {
+        using AlPtr =
+            typename AlNodeTraits::template rebind_alloc<NodePtr>;
+        vector<NodePtr, AlPtr> nodes{AlPtr(this->alloc)};
+        size_type linked = 0;
+
+        try {
+            for (; first != last; ++first) {
+                NodePtr z = allocAndConstruct(*first);
+                try {
+                    nodes.push_back(z);
+                } catch (...) {
+                    destroyAndFree(z);
+                    throw;
+                }
+            }
+
+            // stable, the first of the equivalent values comes first
+            tiny_stl::stable_sort(
+                nodes.begin(), nodes.end(), [this](NodePtr a, NodePtr b) {
+                    return this->compare(get_key(a), get_key(b));
+                });
+
+            NodePtr finger = nullptr;
+            for (; linked < nodes.size(); ++linked) {
+                NodePtr z = nodes[linked];
+                bool left;
+                NodePtr dup = nullptr;
+                NodePtr parent =
+                    finger == nullptr
+                        ? insertPos(getRoot(), get_key(z), unique, left, dup)
+                        : fingerPos(finger, get_key(z), unique, left, dup);
+                if (dup != nullptr) {
+                    destroyAndFree(z);
+                    finger = dup;
+                } else {
+                    linkNode(z, parent, left);
+                    finger = z;
+                }
+            }
+        } catch (...) {
+            for (; linked < nodes.size(); ++linked)
+                destroyAndFree(nodes[linked]);
+            throw;
+        }
+    }
+
+    // links nodes[first, last) into a perfectly balanced subtree. only the
+    // nodes of the deepest level are red, every path has the same number
+    // of black nodes
+    NodePtr linkBalanced(NodePtr nodes, size_type first, size_type last,
+                         NodePtr parent, size_type depth,
+                         size_type redDepth) {
+        if (first == last)
+            return this->header;
+
+        const size_type mid = first + (last - first) / 2;
+        NodePtr p = nodes + mid;
+        p->color = depth == redDepth ? Color::RED : Color::BLACK;
+        p->isNil = 0;
+        p->parent = parent;
+        p->left = linkBalanced(nodes, first, mid, p, depth + 1, redDepth);
+        p->right = linkBalanced(nodes, mid + 1, last, p, depth + 1, redDepth);
+        rbTreeSetSize(p, last - first);
+
+        return p;
+    }
+
+    // O(n) build of an empty tree. the values are constructed in one block
+    // in sorted order, as long as the input is sorted; the rest of the
+    // range is inserted as a batch into the spare nodes of the block
+    template <typename FwdIter>
+    void bulkBuild(FwdIter first, FwdIter last, size_type n, bool unique) {
+        NodePtr nodes = this->alloc.allocate(n);
+        size_type used = 0;
+        bool pending = false; // nodes[used] holds a value
+        try {
+            for (; first != last; ++first) {
+                NodePtr p = nodes + used;
+                this->alloc.construct(tiny_stl::addressof(p->value), *first);
+                pending = true;
+                if (used == 0 || this->compare(get_key(p - 1), get_key(p)))
+                    ++used;
+                else if (this->compare(get_key(p), get_key(p - 1)))
+                    break; // not sorted
+                else if (unique) // equivalent, keep the first
+                    this->alloc.destroy(tiny_stl::addressof(p->value));
+                else
+                    ++used;
+                pending = false;
+            }
+        } catch (...) {
+            if (pending)
+                this->alloc.destroy(tiny_stl::addressof(nodes[used].value));
+            for (size_type i = 0; i < used; ++i)
+                this->alloc.destroy(tiny_stl::addressof(nodes[i].value));
+            this->alloc.deallocate(nodes, n);
+            throw;
+        }
+
+        if (pending) // the first unsorted value, inserted again below
+            this->alloc.destroy(tiny_stl::addressof(nodes[used].value));
+
+        this->block = nodes;
+        this->blockSize = n;
+
+        size_type redDepth = 0; // floor(log2(used))
+        while ((size_type(2) << redDepth) <= used)
+            ++redDepth;
+        NodePtr root = linkBalanced(nodes, 0, used, this->header, 0, redDepth);
+        root->color = Color::BLACK;
+        getRoot() = root;
+        this->header->left = nodes;
+        this->header->right = nodes + (used - 1);
+        this->mCount = used;
+
+        for (size_type i = n; i > used; --i) {
+            nodes[i - 1].parent = this->freeNodes;
+            this->freeNodes = nodes + (i - 1);
+        }
+
+        if (first != last)
+            insertBatch(first, last, unique);
+    }
+
+    template <typename InIter>
+    void insertRangeAux(InIter first, InIter last, bool unique, false_type) {
+        insertBatch(first, last, unique);
+    }
+
+    // forward iterators
+    template <typename FwdIter>
+    void insertRangeAux(FwdIter first, FwdIter last, bool unique, true_type) {
+        if (this->mCount == 0) {
+            const auto n = tiny_stl::distance(first, last);
+            if (n > 0 && static_cast<size_type>(n) <=
+                             AlNodeTraits::max_size(this->alloc)) {
+                clear(); // frees the block of the erased nodes
+                bulkBuild(first, last, static_cast<size_type>(n), unique);
+                return;
+            }
+        }
+
+        insertRangeAux(first, last, unique, false_type{});
+    }
+
+    template <typename InIter>
+    void insertRange(InIter first, InIter last, bool unique) {
+        using Category = typename iterator_traits<InIter>::iterator_category;
+        insertRangeAux(first, last, unique,
+                       is_convertible<Category, forward_iterator_tag>{});
     }
 
 protected:
+    // the k-th value in order, header if k >= size(). only for counted
+    NodePtr nthAux(size_type k) const {
+        NodePtr p = getRoot();
+        while (!p->isNil) {
+            const size_type leftSize = p->left->size;
+            if (k < leftSize) {
+                p = p->left;
+            } else if (k == leftSize) {
+                return p;
+            } else {
+                k -= leftSize + 1;
+                p = p->right;
+            }
+        }
+
+        return this->header;
+    }
+
+    // the number of values less than key. only for counted
+    template <typename K>
+    size_type rankAux(const K& key) const {
+        size_type rank = 0;
+        NodePtr p = getRoot();
+        while (!p->isNil) {
+            if (this->compare(get_key(p), key)) {
+                rank += p->left->size + 1;
+                p = p->right;
+            } else {
+                p = p->left;
+            }
+        }
+
+        return rank;
+    }
+
     iterator insert_equal(const value_type& val) {
         return insertEqualAux(val);
     }
@@ -792,10 +1262,19 @@ protected:
         return insertEqualAux(tiny_stl::move(val));
     }
 
+    // sorted input into an empty tree is built in O(n), other ranges are
+    // sorted and merged into the tree as a batch
     template <typename InIter>
     void insert_equal(InIter first, InIter last) {
-        for (; first != last; ++first)
-            insertEqualAux(*first);
+        insertRange(first, last, false);
+    }
+
+    iterator insert_equal(const_iterator hint, const value_type& val) {
+        return insertHintAux(hint, val, false);
+    }
+
+    iterator insert_equal(const_iterator hint, value_type&& val) {
+        return insertHintAux(hint, tiny_stl::move(val), false);
     }
 
     pair<iterator, bool> insert_unique(const value_type& val) {
@@ -808,18 +1287,38 @@ protected:
 
     template <typename InIter>
     void insert_unique(InIter first, InIter last) {
-        for (; first != last; ++first)
-            insertUniqueAux(*first);
+        insertRange(first, last, true);
+    }
+
+    iterator insert_unique(const_iterator hint, const value_type& val) {
+        return insertHintAux(hint, val, true);
+    }
+
+    iterator insert_unique(const_iterator hint, value_type&& val) {
+        return insertHintAux(hint, tiny_stl::move(val), true);
     }
 
     template <typename... Args>
     iterator emplace_equal(Args&&... args) {
-        return insertEqualAux(tiny_stl::forward<Args>(args)...);
+        return insertAux(allocAndConstruct(tiny_stl::forward<Args>(args)...));
     }
 
     template <typename... Args>
     pair<iterator, bool> emplace_unique(Args&&... args) {
-        return insertUniqueAux(tiny_stl::forward<Args>(args)...);
+        return insertUniqueNode(
+            allocAndConstruct(tiny_stl::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    iterator emplace_hint_equal(const_iterator hint, Args&&... args) {
+        NodePtr z = allocAndConstruct(tiny_stl::forward<Args>(args)...);
+        return insertHintNode(hint.ptr, z, false);
+    }
+
+    template <typename... Args>
+    iterator emplace_hint_unique(const_iterator hint, Args&&... args) {
+        NodePtr z = allocAndConstruct(tiny_stl::forward<Args>(args)...);
+        return insertHintNode(hint.ptr, z, true);
     }
 
 private:
@@ -835,7 +1334,8 @@ private:
         v->parent = u->parent;
     }
 
-    // erase node z
+    // erase node z. header is also the nil leaf, so x->parent = y may
+    // overwrite header->parent, work on a local root and store it at the end
     void eraseAux(NodePtr root, NodePtr z) {
         NodePtr y = z;
         NodePtr x = nullptr;
@@ -848,12 +1348,18 @@ private:
         if (z == this->header->right)
             this->header->right = (--iterator(z)).ptr;
 
+        // the removed position is z's, or y's if y replaces z
+        if (z->left->isNil || z->right->isNil)
+            rbTreeDecreasePath(z->parent);
+        else
+            rbTreeDecreasePath(rbTreeMinValue(z->right)->parent);
+
         if (z->left->isNil) { // z has not left child
             x = z->right;
-            transplantForErase(getRoot(), z, z->right);
+            transplantForErase(root, z, z->right);
         } else if (z->right->isNil) { // z has not right child
             x = z->left;
-            transplantForErase(getRoot(), z, z->left);
+            transplantForErase(root, z, z->left);
         } else { // z has left and right child
             y = rbTreeMinValue(z->right);
             yOriginColor = y->color;
@@ -862,15 +1368,16 @@ private:
             if (y->parent == z) {
                 x->parent = y;
             } else {
-                transplantForErase(getRoot(), y, y->right);
+                transplantForErase(root, y, y->right);
                 y->right = z->right;
                 y->right->parent = y;
             }
 
-            transplantForErase(getRoot(), z, y);
+            transplantForErase(root, z, y);
             y->left = z->left;
             y->left->parent = y;
             y->color = z->color;
+            rbTreeUpdateSize(y);
         }
 
         if (yOriginColor == Color::BLACK)
@@ -913,6 +1420,20 @@ public:
         return num;
     }
 
+    // iterators are not keys
+    template <typename K, typename Cmp = Compare,
+              typename = typename Cmp::is_transparent,
+              typename = enable_if_t<!is_convertible<K, iterator>::value &&
+                                     !is_convertible<K, const_iterator>::value>>
+    size_type erase(K&& key) {
+        auto ppos = equal_range(key);
+        size_type num = tiny_stl::distance(ppos.first, ppos.second);
+
+        erase(ppos.first, ppos.second);
+
+        return num;
+    }
+
 public:
     iterator begin() noexcept {
         return iterator(this->header->left);
@@ -969,7 +1490,8 @@ private:
             p = p->left;
             AlNodeTraits::destroy(this->alloc,
                                   tiny_stl::addressof(root->value));
-            this->alloc.deallocate(root, 1);
+            if (!inBlock(root))
+                this->alloc.deallocate(root, 1);
         }
     }
 
@@ -980,6 +1502,13 @@ public:
         this->header->right = this->header;
         this->header->parent = this->header;
         this->mCount = 0;
+
+        if (this->block != nullptr) {
+            this->alloc.deallocate(this->block, this->blockSize);
+            this->block = nullptr;
+            this->blockSize = 0;
+        }
+        this->freeNodes = nullptr;
     }
 
     void swap(RBTree& rhs) noexcept(AlTraits::is_always_equal::value&&
@@ -989,48 +1518,53 @@ public:
         if (allocator_traits<Alloc>::propagate_on_container_swap::value)
             tiny_stl::swapAlloc(this->alloc, rhs.alloc);
 
-        tiny_stl::swapADL(this->header, rhs.header);
         tiny_stl::swapADL(this->compare, rhs.compare);
-        tiny_stl::swapADL(this->mCount, rhs.mCount);
+        swapNodes(rhs);
     }
 
 }; // RBTree
 
-template <typename T, typename Compare, typename Alloc, bool isMap>
-bool operator==(const RBTree<T, Compare, Alloc, isMap>& lhs,
-                const RBTree<T, Compare, Alloc, isMap>& rhs) {
+template <typename T, typename Compare, typename Alloc, bool isMap,
+          bool counted>
+bool operator==(const RBTree<T, Compare, Alloc, isMap, counted>& lhs,
+                const RBTree<T, Compare, Alloc, isMap, counted>& rhs) {
     return lhs.size() == rhs.size() &&
            tiny_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <typename T, typename Compare, typename Alloc, bool isMap>
-bool operator!=(const RBTree<T, Compare, Alloc, isMap>& lhs,
-                const RBTree<T, Compare, Alloc, isMap>& rhs) {
+template <typename T, typename Compare, typename Alloc, bool isMap,
+          bool counted>
+bool operator!=(const RBTree<T, Compare, Alloc, isMap, counted>& lhs,
+                const RBTree<T, Compare, Alloc, isMap, counted>& rhs) {
     return !(lhs == rhs);
 }
 
-template <typename T, typename Compare, typename Alloc, bool isMap>
-bool operator<(const RBTree<T, Compare, Alloc, isMap>& lhs,
-               const RBTree<T, Compare, Alloc, isMap>& rhs) {
+template <typename T, typename Compare, typename Alloc, bool isMap,
+          bool counted>
+bool operator<(const RBTree<T, Compare, Alloc, isMap, counted>& lhs,
+               const RBTree<T, Compare, Alloc, isMap, counted>& rhs) {
     return tiny_stl::lexicographical_compare(lhs.begin(), lhs.end(),
                                              rhs.begin(), rhs.end());
 }
 
-template <typename T, typename Compare, typename Alloc, bool isMap>
-bool operator>(const RBTree<T, Compare, Alloc, isMap>& lhs,
-               const RBTree<T, Compare, Alloc, isMap>& rhs) {
+template <typename T, typename Compare, typename Alloc, bool isMap,
+          bool counted>
+bool operator>(const RBTree<T, Compare, Alloc, isMap, counted>& lhs,
+               const RBTree<T, Compare, Alloc, isMap, counted>& rhs) {
     return rhs < lhs;
 }
 
-template <typename T, typename Compare, typename Alloc, bool isMap>
-bool operator<=(const RBTree<T, Compare, Alloc, isMap>& lhs,
-                const RBTree<T, Compare, Alloc, isMap>& rhs) {
+template <typename T, typename Compare, typename Alloc, bool isMap,
+          bool counted>
+bool operator<=(const RBTree<T, Compare, Alloc, isMap, counted>& lhs,
+                const RBTree<T, Compare, Alloc, isMap, counted>& rhs) {
     return !(rhs < lhs);
 }
 
-template <typename T, typename Compare, typename Alloc, bool isMap>
-bool operator>=(const RBTree<T, Compare, Alloc, isMap>& lhs,
-                const RBTree<T, Compare, Alloc, isMap>& rhs) {
+template <typename T, typename Compare, typename Alloc, bool isMap,
+          bool counted>
+bool operator>=(const RBTree<T, Compare, Alloc, isMap, counted>& lhs,
+                const RBTree<T, Compare, Alloc, isMap, counted>& rhs) {
     return !(lhs < rhs);
 }
 
@@ -0,0 +1,495 @@
+﻿// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <ostream>
+
+#include "cow_string.hpp"
+#include "string.hpp"
+#include "string_view.hpp"
+#include "vector.hpp"
+
+namespace tiny_stl {
+
+namespace details {
+
+// a node of rope, never modified after construction and shared by the
+// ropes and their substrings through the reference count
+template <typename CharT>
+struct RopeNode : public extra::RCObject<> {
+    std::size_t size;
+    int height; // 0 for the leaves
+    extra::RCPtr<RopeNode> left;
+    extra::RCPtr<RopeNode> right;
+    CharT* chars; // the text of a leaf, nullptr for the inner nodes
+
+    RopeNode(const CharT* s, std::size_t n)
+        : size(n), height(0), left(), right(), chars(new CharT[n]) {
+        tiny_stl::copy(s, s + n, chars);
+    }
+
+    RopeNode(const extra::RCPtr<RopeNode>& l,
+             const extra::RCPtr<RopeNode>& r)
+        : size(l->size + r->size),
+          height(tiny_stl::max(l->height, r->height) + 1), left(l), right(r),
+          chars(nullptr) {
+    }
+
+    ~RopeNode() {
+        delete[] chars;
+    }
+};
+
+} // namespace details
+
+// a string stored as an AVL tree of immutable chunks of at most MAX_LEAF
+// characters. append, insert, erase and substr are O(log n) and share the
+// untouched chunks with the source, copies are O(1). Any modification of
+// a rope invalidates its chunk iterators
+template <typename CharT, typename Traits = std::char_traits<CharT>>
+class rope {
+public:
+    static_assert(is_same<typename Traits::char_type, CharT>::value,
+                  "char type error");
+
+    using traits_type = Traits;
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using string_view_type = basic_string_view<CharT, Traits>;
+    using string_type = basic_string<CharT, Traits>;
+
+    static const size_type npos = static_cast<size_type>(-1);
+
+private:
+    using Node = details::RopeNode<CharT>;
+    using NodePtr = extra::RCPtr<Node>;
+
+    // small enough to copy on a split, large enough for a fast scan
+    static const size_type MAX_LEAF = 512;
+
+    NodePtr root;
+
+public:
+    // yields the chunks from left to right as string views
+    class chunk_iterator {
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = string_view_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = value_type;
+
+    private:
+        vector<const Node*> pending; // the right subtrees not visited yet
+        const Node* leaf;
+        size_type offset; // the position of leaf in the rope
+
+        void descend(const Node* node) {
+            while (node->height > 0) {
+                pending.push_back(node->right.get());
+                node = node->left.get();
+            }
+            leaf = node;
+        }
+
+    public:
+        chunk_iterator() : pending(), leaf(nullptr), offset(0) {
+        }
+
+        chunk_iterator(const Node* node, size_type pos)
+            : pending(), leaf(nullptr), offset(pos) {
+            if (node != nullptr)
+                descend(node);
+        }
+
+        // the position of the current chunk in the rope
+        size_type position() const noexcept {
+            return offset;
+        }
+
+        value_type operator*() const {
+            return value_type(leaf->chars, leaf->size);
+        }
+
+        chunk_iterator& operator++() {
+            offset += leaf->size;
+            if (pending.empty()) {
+                leaf = nullptr;
+            } else {
+                const Node* node = pending.back();
+                pending.pop_back();
+                descend(node);
+            }
+
+            return *this;
+        }
+
+        chunk_iterator operator++(int) {
+            chunk_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        // a chunk can occur several times, the position tells them apart
+        bool operator==(const chunk_iterator& rhs) const noexcept {
+            return offset == rhs.offset;
+        }
+
+        bool operator!=(const chunk_iterator& rhs) const noexcept {
+            return !(*this == rhs);
+        }
+    }; // class chunk_iterator
+
+public:
+    rope() : root() {
+    }
+
+    rope(const CharT* s) : root(build(s, Traits::length(s))) {
+    }
+
+    rope(const CharT* s, size_type count) : root(build(s, count)) {
+    }
+
+    rope(string_view_type sv) : root(build(sv.data(), sv.size())) {
+    }
+
+    rope(const string_type& str) : root(build(str.data(), str.size())) {
+    }
+
+    // the copy only adds a reference to the root
+    rope(const rope&) = default;
+    rope& operator=(const rope&) = default;
+
+    rope(rope&& rhs) noexcept : root(tiny_stl::move(rhs.root)) {
+    }
+
+    rope& operator=(rope&& rhs) noexcept {
+        root = tiny_stl::move(rhs.root);
+        return *this;
+    }
+
+    size_type size() const noexcept {
+        return root.get() == nullptr ? 0 : root->size;
+    }
+
+    size_type length() const noexcept {
+        return size();
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    void clear() noexcept {
+        root = NodePtr();
+    }
+
+    // O(log n)
+    CharT operator[](size_type pos) const {
+        assert(pos < size());
+
+        const Node* node = root.get();
+        while (node->height > 0) {
+            const size_type leftSize = node->left->size;
+            if (pos < leftSize) {
+                node = node->left.get();
+            } else {
+                pos -= leftSize;
+                node = node->right.get();
+            }
+        }
+
+        return node->chars[pos];
+    }
+
+    CharT at(size_type pos) const {
+        if (pos >= size())
+            xRange();
+
+        return (*this)[pos];
+    }
+
+    CharT front() const {
+        return (*this)[0];
+    }
+
+    CharT back() const {
+        return (*this)[size() - 1];
+    }
+
+    chunk_iterator chunk_begin() const {
+        return chunk_iterator(root.get(), 0);
+    }
+
+    chunk_iterator chunk_end() const {
+        return chunk_iterator(nullptr, size());
+    }
+
+    // O(log n), shares the chunks with *this
+    rope substr(size_type pos = 0, size_type count = npos) const {
+        if (pos > size())
+            xRange();
+
+        count = tiny_stl::min(count, size() - pos);
+        NodePtr prefix, rest, middle, suffix;
+        split(root, pos, prefix, rest);
+        split(rest, count, middle, suffix);
+        return rope(tiny_stl::move(middle));
+    }
+
+    rope& append(const rope& rhs) {
+        root = join(root, rhs.root);
+        return *this;
+    }
+
+    rope& append(const CharT* s, size_type count) {
+        root = join(root, build(s, count));
+        return *this;
+    }
+
+    void push_back(CharT ch) {
+        append(&ch, 1);
+    }
+
+    rope& operator+=(const rope& rhs) {
+        return append(rhs);
+    }
+
+    rope& operator+=(CharT ch) {
+        push_back(ch);
+        return *this;
+    }
+
+    rope& insert(size_type pos, const rope& str) {
+        return replace(pos, 0, str);
+    }
+
+    rope& erase(size_type pos = 0, size_type count = npos) {
+        return replace(pos, count, rope());
+    }
+
+    // O(log n), replaces [pos, pos + count) with str
+    rope& replace(size_type pos, size_type count, const rope& str) {
+        if (pos > size())
+            xRange();
+
+        count = tiny_stl::min(count, size() - pos);
+        NodePtr prefix, rest, middle, suffix;
+        split(root, pos, prefix, rest);
+        split(rest, count, middle, suffix);
+        root = join(join(prefix, str.root), suffix);
+        return *this;
+    }
+
+    string_type str() const {
+        string_type res;
+        res.reserve(size());
+        for (auto iter = chunk_begin(); iter != chunk_end(); ++iter)
+            res.append((*iter).data(), (*iter).size());
+
+        return res;
+    }
+
+    void swap(rope& rhs) noexcept {
+        tiny_stl::swap(root, rhs.root);
+    }
+
+private:
+    explicit rope(NodePtr&& node) : root(tiny_stl::move(node)) {
+    }
+
+    static NodePtr makeNode(const NodePtr& l, const NodePtr& r) {
+        return NodePtr(new Node(l, r));
+    }
+
+    static NodePtr makeLeaf(const CharT* s, size_type n) {
+        return NodePtr(new Node(s, n));
+    }
+
+    static NodePtr mergeLeaves(const Node* l, const Node* r) {
+        CharT buf[MAX_LEAF];
+        tiny_stl::copy(l->chars, l->chars + l->size, buf);
+        tiny_stl::copy(r->chars, r->chars + r->size, buf + l->size);
+        return makeLeaf(buf, l->size + r->size);
+    }
+
+    static bool canMerge(const NodePtr& l, const NodePtr& r) {
+        return l->height == 0 && r->height == 0 &&
+               l->size + r->size <= MAX_LEAF;
+    }
+
+    // full leaves and a perfectly balanced tree
+    static NodePtr build(const CharT* s, size_type n) {
+        if (n == 0)
+            return NodePtr();
+
+        return buildAux(s, n, (n + MAX_LEAF - 1) / MAX_LEAF);
+    }
+
+    static NodePtr buildAux(const CharT* s, size_type n, size_type leaves) {
+        if (leaves == 1)
+            return makeLeaf(s, n);
+
+        const size_type leftLeaves = leaves / 2;
+        const size_type leftSize = leftLeaves * MAX_LEAF;
+        return makeNode(buildAux(s, leftSize, leftLeaves),
+                        buildAux(s + leftSize, n - leftSize,
+                                 leaves - leftLeaves));
+    }
+
+    // the heights of l and r differ by 2 at most
+    static NodePtr balance(const NodePtr& l, const NodePtr& r) {
+        if (l->height > r->height + 1) {
+            if (l->left->height >= l->right->height)
+                return makeNode(l->left, makeNode(l->right, r));
+
+            return makeNode(makeNode(l->left, l->right->left),
+                            makeNode(l->right->right, r));
+        }
+
+        if (r->height > l->height + 1) {
+            if (r->right->height >= r->left->height)
+                return makeNode(makeNode(l, r->left), r->right);
+
+            return makeNode(makeNode(l, r->left->left),
+                            makeNode(r->left->right, r->right));
+        }
+
+        return makeNode(l, r);
+    }
+
+    // O(|height(l) - height(r)| + 1), the taller tree is walked down to
+    // the height of the other one
+    static NodePtr join(const NodePtr& l, const NodePtr& r) {
+        if (l.get() == nullptr)
+            return r;
+        if (r.get() == nullptr)
+            return l;
+
+        if (canMerge(l, r))
+            return mergeLeaves(l.get(), r.get());
+
+        // fill the last chunk of l or the first chunk of r
+        if (r->height == 0 && l->height == 1 && canMerge(l->right, r))
+            return makeNode(l->left, mergeLeaves(l->right.get(), r.get()));
+        if (l->height == 0 && r->height == 1 && canMerge(l, r->left))
+            return makeNode(mergeLeaves(l.get(), r->left.get()), r->right);
+
+        if (l->height > r->height + 1)
+            return balance(l->left, join(l->right, r));
+        if (r->height > l->height + 1)
+            return balance(join(l, r->left), r->right);
+
+        return makeNode(l, r);
+    }
+
+    // [0, pos) to l and [pos, size) to r, O(log n) in total since the
+    // heights of the joined trees increase along the path
+    static void split(const NodePtr& node, size_type pos, NodePtr& l,
+                      NodePtr& r) {
+        if (node.get() == nullptr || pos == 0) {
+            l = NodePtr();
+            r = node;
+            return;
+        }
+
+        if (pos >= node->size) {
+            l = node;
+            r = NodePtr();
+            return;
+        }
+
+        if (node->height == 0) {
+            l = makeLeaf(node->chars, pos);
+            r = makeLeaf(node->chars + pos, node->size - pos);
+            return;
+        }
+
+        NodePtr rest;
+        const size_type leftSize = node->left->size;
+        if (pos <= leftSize) {
+            split(node->left, pos, l, rest);
+            r = join(rest, node->right);
+        } else {
+            split(node->right, pos - leftSize, rest, r);
+            l = join(node->left, rest);
+        }
+    }
+
+    [[noreturn]] static void xRange() {
+        throw "invalid tiny_stl::rope<CharT> subscript";
+    }
+}; // class rope<CharT, Traits>
+
+template <typename CharT, typename Traits>
+inline rope<CharT, Traits> operator+(const rope<CharT, Traits>& lhs,
+                                     const rope<CharT, Traits>& rhs) {
+    rope<CharT, Traits> res(lhs);
+    res.append(rhs);
+    return res;
+}
+
+// compares the chunk sequences, which may be cut at different positions
+template <typename CharT, typename Traits>
+inline bool operator==(const rope<CharT, Traits>& lhs,
+                       const rope<CharT, Traits>& rhs) {
+    if (lhs.size() != rhs.size())
+        return false;
+
+    auto iter1 = lhs.chunk_begin();
+    auto iter2 = rhs.chunk_begin();
+    std::size_t off1 = 0;
+    std::size_t off2 = 0;
+    while (iter1 != lhs.chunk_end()) {
+        const auto chunk1 = *iter1;
+        const auto chunk2 = *iter2;
+        const std::size_t n =
+            tiny_stl::min(chunk1.size() - off1, chunk2.size() - off2);
+        if (Traits::compare(chunk1.data() + off1, chunk2.data() + off2, n) !=
+            0)
+            return false;
+
+        off1 += n;
+        off2 += n;
+        if (off1 == chunk1.size()) {
+            ++iter1;
+            off1 = 0;
+        }
+        if (off2 == chunk2.size()) {
+            ++iter2;
+            off2 = 0;
+        }
+    }
+
+    return true;
+}
+
+template <typename CharT, typename Traits>
+inline bool operator!=(const rope<CharT, Traits>& lhs,
+                       const rope<CharT, Traits>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename CharT, typename Traits>
+inline void swap(rope<CharT, Traits>& lhs,
+                 rope<CharT, Traits>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+template <typename CharT, typename Traits>
+std::basic_ostream<CharT, Traits>&
+operator<<(std::basic_ostream<CharT, Traits>& os,
+           const rope<CharT, Traits>& str) {
+    for (auto iter = str.chunk_begin(); iter != str.chunk_end(); ++iter)
+        os.write((*iter).data(), static_cast<std::streamsize>((*iter).size()));
+
+    return os;
+}
+
+using crope = rope<char>;
+using wrope = rope<wchar_t>;
+
+} // namespace tiny_stl
@@ -0,0 +1,234 @@
+﻿// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "algorithm.hpp"
+#include "unordered_map.hpp"
+#include "vector.hpp"
+
+namespace tiny_stl {
+
+// searchers for tiny_stl::search(first, last, searcher), the tables of
+// the pattern are built once and reused for every haystack.
+// the pattern range must outlive the searcher
+
+template <typename FwdIter, typename BinaryPred = equal_to<>>
+class default_searcher {
+private:
+    FwdIter patFirst;
+    FwdIter patLast;
+    BinaryPred pred;
+
+public:
+    default_searcher(FwdIter first, FwdIter last,
+                     BinaryPred p = BinaryPred())
+        : patFirst(first), patLast(last), pred(p) {
+    }
+
+    template <typename FwdIter2>
+    pair<FwdIter2, FwdIter2> operator()(FwdIter2 first, FwdIter2 last) const {
+        first = tiny_stl::search(first, last, patFirst, patLast, pred);
+        if (first == last)
+            return pair<FwdIter2, FwdIter2>(last, last);
+
+        FwdIter2 matchLast = first;
+        tiny_stl::advance(matchLast, tiny_stl::distance(patFirst, patLast));
+        return pair<FwdIter2, FwdIter2>(first, matchLast);
+    }
+}; // class default_searcher<FwdIter, BinaryPred>
+
+namespace details {
+
+// 1 byte keys compared by identity index an array instead of hashing
+template <typename Key, typename Hash, typename BinaryPred>
+using IsByteSkipKey =
+    bool_constant<is_integral<Key>::value && sizeof(Key) == 1 &&
+                  is_same<Hash, hash<Key>>::value &&
+                  (is_same<BinaryPred, equal_to<Key>>::value ||
+                   is_same<BinaryPred, equal_to<>>::value)>;
+
+// the shift of each pattern character, defaultShift for the others
+template <typename Key, typename Diff, typename Hash, typename BinaryPred,
+          bool = IsByteSkipKey<Key, Hash, BinaryPred>::value>
+class SkipTable {
+private:
+    flat_unordered_map<Key, Diff, Hash, BinaryPred> table;
+    Diff defaultShift;
+
+public:
+    SkipTable(Diff count, Diff shift, const Hash& hf, const BinaryPred& pred)
+        : table(static_cast<std::size_t>(count), hf, pred),
+          defaultShift(shift) {
+    }
+
+    void set(const Key& key, Diff shift) {
+        table[key] = shift;
+    }
+
+    Diff get(const Key& key) const {
+        const auto iter = table.find(key);
+        return iter == table.end() ? defaultShift : iter->second;
+    }
+};
+
+template <typename Key, typename Diff, typename Hash, typename BinaryPred>
+class SkipTable<Key, Diff, Hash, BinaryPred, true> {
+private:
+    Diff table[256];
+
+public:
+    SkipTable(Diff, Diff shift, const Hash&, const BinaryPred&) {
+        tiny_stl::fill(table, table + 256, shift);
+    }
+
+    void set(Key key, Diff shift) noexcept {
+        table[static_cast<unsigned char>(key)] = shift;
+    }
+
+    Diff get(Key key) const noexcept {
+        return table[static_cast<unsigned char>(key)];
+    }
+};
+
+// the bad character rule of Horspool and Boyer-Moore, the distance from
+// the last occurrence in [0, m - 1) to the end
+template <typename RanIter, typename Table>
+inline void buildBadCharTable(RanIter first, IterDiffType<RanIter> m,
+                              Table& table) {
+    for (IterDiffType<RanIter> i = 0; i + 1 < m; ++i)
+        table.set(first[i], m - 1 - i);
+}
+
+} // namespace details
+
+// O(n / m) on average, O(nm) in the worst case
+template <typename RanIter,
+          typename Hash = hash<typename iterator_traits<RanIter>::value_type>,
+          typename BinaryPred = equal_to<>>
+class boyer_moore_horspool_searcher {
+private:
+    using Key = typename iterator_traits<RanIter>::value_type;
+    using Diff = typename iterator_traits<RanIter>::difference_type;
+
+    RanIter patFirst;
+    Diff patSize;
+    details::SkipTable<Key, Diff, Hash, BinaryPred> skip;
+    BinaryPred pred;
+
+public:
+    boyer_moore_horspool_searcher(RanIter first, RanIter last,
+                                  Hash hf = Hash(),
+                                  BinaryPred p = BinaryPred())
+        : patFirst(first), patSize(last - first),
+          skip(patSize, patSize, hf, p), pred(p) {
+        details::buildBadCharTable(first, patSize, skip);
+    }
+
+    template <typename RanIter2>
+    pair<RanIter2, RanIter2> operator()(RanIter2 first, RanIter2 last) const {
+        const Diff m = patSize;
+        if (m == 0)
+            return pair<RanIter2, RanIter2>(first, first);
+
+        for (; last - first >= m; first += skip.get(first[m - 1])) {
+            // compare from the end
+            for (Diff i = m - 1; pred(first[i], patFirst[i]); --i) {
+                if (i == 0)
+                    return pair<RanIter2, RanIter2>(first, first + m);
+            }
+        }
+
+        return pair<RanIter2, RanIter2>(last, last);
+    }
+}; // class boyer_moore_horspool_searcher<RanIter, Hash, BinaryPred>
+
+// the bad character and the good suffix rules, O(n / m) on average
+template <typename RanIter,
+          typename Hash = hash<typename iterator_traits<RanIter>::value_type>,
+          typename BinaryPred = equal_to<>>
+class boyer_moore_searcher {
+private:
+    using Key = typename iterator_traits<RanIter>::value_type;
+    using Diff = typename iterator_traits<RanIter>::difference_type;
+
+    RanIter patFirst;
+    Diff patSize;
+    details::SkipTable<Key, Diff, Hash, BinaryPred> badChar;
+    vector<Diff> goodSuffix;
+    BinaryPred pred;
+
+    // suffix[i]: the length of the longest common suffix of pat[0, i]
+    // and pat
+    void buildGoodSuffix() {
+        const Diff m = patSize;
+        const RanIter pat = patFirst;
+        vector<Diff> suffix(static_cast<std::size_t>(m));
+        suffix[m - 1] = m;
+        Diff g = m - 1;
+        Diff f = 0;
+        for (Diff i = m - 2; i >= 0; --i) {
+            if (i > g && suffix[i + m - 1 - f] < i - g) {
+                suffix[i] = suffix[i + m - 1 - f];
+            } else {
+                if (i < g)
+                    g = i;
+                f = i;
+                while (g >= 0 && pred(pat[g], pat[g + m - 1 - f]))
+                    --g;
+                suffix[i] = f - g;
+            }
+        }
+
+        // a prefix of pat is a suffix of the matched part
+        goodSuffix.assign(static_cast<std::size_t>(m), m);
+        Diff j = 0;
+        for (Diff i = m - 1; i >= 0; --i) {
+            if (suffix[i] == i + 1) {
+                for (; j < m - 1 - i; ++j) {
+                    if (goodSuffix[j] == m)
+                        goodSuffix[j] = m - 1 - i;
+                }
+            }
+        }
+
+        // the matched part occurs again in pat
+        for (Diff i = 0; i + 1 < m; ++i)
+            goodSuffix[m - 1 - suffix[i]] = m - 1 - i;
+    }
+
+public:
+    boyer_moore_searcher(RanIter first, RanIter last, Hash hf = Hash(),
+                         BinaryPred p = BinaryPred())
+        : patFirst(first), patSize(last - first),
+          badChar(patSize, patSize, hf, p), goodSuffix(), pred(p) {
+        if (patSize > 0) {
+            details::buildBadCharTable(first, patSize, badChar);
+            buildGoodSuffix();
+        }
+    }
+
+    template <typename RanIter2>
+    pair<RanIter2, RanIter2> operator()(RanIter2 first, RanIter2 last) const {
+        const Diff m = patSize;
+        if (m == 0)
+            return pair<RanIter2, RanIter2>(first, first);
+
+        while (last - first >= m) {
+            Diff i = m - 1;
+            while (pred(first[i], patFirst[i])) {
+                if (i == 0)
+                    return pair<RanIter2, RanIter2>(first, first + m);
+                --i;
+            }
+
+            const Diff badShift = badChar.get(first[i]) - (m - 1 - i);
+            first += tiny_stl::max(goodSuffix[i], badShift);
+        }
+
+        return pair<RanIter2, RanIter2>(last, last);
+    }
+}; // class boyer_moore_searcher<RanIter, Hash, BinaryPred>
+
+} // namespace tiny_stl
@@ -116,11 +116,30 @@ public:
         this->insert_unique(ilist.begin(), ilist.end());
     }
 
+    iterator insert(const_iterator hint, const value_type& val) {
+        return this->insert_unique(hint, val);
+    }
+
+    iterator insert(const_iterator hint, value_type&& val) {
+        return this->insert_unique(hint, tiny_stl::move(val));
+    }
+
+    template <typename Range>
+    void insert_range(Range&& rg) {
+        this->insert_unique(rg.begin(), rg.end());
+    }
+
     template <typename... Args>
     pair<iterator, bool> emplace(Args&&... args) {
         return this->emplace_unique(tiny_stl::forward<Args>(args)...);
     }
 
+    template <typename... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args) {
+        return this->emplace_hint_unique(hint,
+                                         tiny_stl::forward<Args>(args)...);
+    }
+
     void swap(set& rhs) {
         Base::swap(rhs);
     }
@@ -250,9 +269,28 @@ public:
         this->insert_equal(ilist.begin(), ilist.end());
     }
 
+    iterator insert(const_iterator hint, const value_type& val) {
+        return this->insert_equal(hint, val);
+    }
+
+    iterator insert(const_iterator hint, value_type&& val) {
+        return this->insert_equal(hint, tiny_stl::move(val));
+    }
+
+    template <typename Range>
+    void insert_range(Range&& rg) {
+        this->insert_equal(rg.begin(), rg.end());
+    }
+
     template <typename... Args>
     iterator emplace(Args&&... args) {
-        return this->insert_equal(tiny_stl::forward<Args>(args)...);
+        return this->emplace_equal(tiny_stl::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args) {
+        return this->emplace_hint_equal(hint,
+                                        tiny_stl::forward<Args>(args)...);
     }
 
     void swap(multiset& rhs) {
@@ -0,0 +1,77 @@
+﻿// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "vector.hpp"
+
+namespace tiny_stl {
+
+// vector with inline storage for N elements, the allocator is only used
+// once the size grows past N
+template <typename T, std::size_t N, typename Alloc = allocator<T>>
+class small_vector : public VectorImpl<T, Alloc, N> {
+    static_assert(N > 0, "use vector<T> without inline storage");
+
+private:
+    using Base = VectorImpl<T, Alloc, N>;
+
+public:
+    using Base::Base;
+
+    small_vector() noexcept(noexcept(Alloc())) : Base() {
+    }
+
+    small_vector& operator=(std::initializer_list<T> ilist) {
+        Base::operator=(ilist);
+        return *this;
+    }
+}; // class small_vector<T, N, Alloc>
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator==(const small_vector<T, N, Alloc>& lhs,
+                       const small_vector<T, N, Alloc>& rhs) {
+    return lhs.size() == rhs.size() &&
+           tiny_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator!=(const small_vector<T, N, Alloc>& lhs,
+                       const small_vector<T, N, Alloc>& rhs) {
+    return (!(lhs == rhs));
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator<(const small_vector<T, N, Alloc>& lhs,
+                      const small_vector<T, N, Alloc>& rhs) {
+    return tiny_stl::lexicographical_compare(lhs.begin(), lhs.end(),
+                                             rhs.begin(), rhs.end());
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator<=(const small_vector<T, N, Alloc>& lhs,
+                       const small_vector<T, N, Alloc>& rhs) {
+    return (!(rhs < lhs));
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator>(const small_vector<T, N, Alloc>& lhs,
+                      const small_vector<T, N, Alloc>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator>=(const small_vector<T, N, Alloc>& lhs,
+                       const small_vector<T, N, Alloc>& rhs) {
+    return (!(lhs < rhs));
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline void swap(small_vector<T, N, Alloc>& lhs,
+                 small_vector<T, N, Alloc>& rhs) noexcept(
+    noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+} // namespace tiny_stl
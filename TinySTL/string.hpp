@@ -5,6 +5,7 @@
 #pragma once
 
 #include "memory.hpp"
+#include "string_search.hpp"
 #include "string_view.hpp"
 #include <initializer_list>
 
@@ -162,6 +163,11 @@ struct StringIterator : StringConstIterator<T> {
         return *this;
     }
 
+    Self operator+(difference_type n) const {
+        Self tmp = *this;
+        return tmp += n;
+    }
+
     Self operator-(difference_type n) const {
         Self tmp = *this;
         return tmp -= n;
@@ -172,7 +178,7 @@ struct StringIterator : StringConstIterator<T> {
     }
 
     reference operator[](difference_type n) const {
-        return *(this->ptr + n);
+        return const_cast<reference>(this->ptr[n]);
     }
 }; // StringIterator<T>
 
@@ -304,7 +310,8 @@ public:
         init(rhs, pos, count);
     }
 
-    basic_string(const value_type* str, size_type count, const Alloc& a)
+    basic_string(const value_type* str, size_type count,
+                 const Alloc& a = Alloc())
         : allocVal(a) {
         initEmpty(); // for setting capacity
         init(str, count);
@@ -872,20 +879,20 @@ private:
         const bool isShortRhs = rhsVal.isShortString();
 
         if (isShortLhs) {
-            if (isShortRhs)
-                swapADL(lhsVal.data.ptr, rhsVal.data.ptr);
-            else
-                swapShortWithLong(lhsVal, rhsVal);
-        } else { // lhs is long string
             if (isShortRhs) {
-                swapShortWithLong(rhsVal, lhsVal);
-            } else {
                 value_type tmpBuf[StringValue::kBufferSize];
                 Traits::move(tmpBuf, lhsVal.data.buf, StringValue::kBufferSize);
                 Traits::move(lhsVal.data.buf, rhsVal.data.buf,
                              StringValue::kBufferSize);
                 Traits::move(rhsVal.data.buf, tmpBuf, StringValue::kBufferSize);
+            } else {
+                swapShortWithLong(lhsVal, rhsVal);
             }
+        } else { // lhs is long string
+            if (isShortRhs)
+                swapShortWithLong(rhsVal, lhsVal);
+            else
+                swapADL(lhsVal.data.ptr, rhsVal.data.ptr);
         }
 
         swapADL(lhsVal.size, rhsVal.size);
@@ -1117,7 +1124,7 @@ public:
                const size_type xCount) {
                 Traits::move(newPtr, oldPtr, xOldSize);
                 Traits::move(newPtr + xOldSize, xStr, xCount);
-                Traits::assign(newPtr[xOldSize + 1], value_type());
+                Traits::assign(newPtr[xOldSize + xCount], value_type());
             },
             str, count);
     }
@@ -1387,59 +1394,28 @@ public:
 private:
     size_type findHelper(const value_type* str, size_type pos,
                          size_type count) const noexcept {
-        // native find algorithm
-        size_type lhsSize = size();
-        if (count > lhsSize || pos > lhsSize - count)
+        const size_type lhsSize = size();
+        if (pos > lhsSize)
             return npos;
-        if (count == 0)
-            return pos;
-
-        for (size_type i = pos; i <= lhsSize - count; ++i) {
-            // mismatched the first character
-            if (!Traits::eq(data()[i], str[0]))
-                continue;
-
-            size_type j = 1;
-            for (; j < count; ++j) {
-                if (!Traits::eq(data()[i + j], str[j]))
-                    break;
-            }
-            if (j == count)
-                return i;
-        }
 
-        return npos;
+        const value_type* findAt = details::stringSearch<Traits>(
+            data() + pos, lhsSize - pos, str, count);
+        return findAt == nullptr ? npos
+                                 : static_cast<size_type>(findAt - data());
     }
 
-    // [0, pos]
+    // the last match starting in [0, pos]
     size_type rfindHelper(const value_type* str, size_type pos,
                           size_type count) const noexcept {
-        // native find algorithm
-        size_type lhsSize = size();
-        if (count > lhsSize || pos < count)
-            return npos;
-        if (lhsSize == 0)
+        const size_type lhsSize = size();
+        if (count > lhsSize)
             return npos;
-        if (count == 0)
-            return pos;
 
-        pos = tiny_stl::min(pos, lhsSize - 1);
-        // pos >= count
-        for (difference_type i = static_cast<difference_type>(pos); i >= 0;
-             --i) {
-            // mismatched the first character
-            if (!Traits::eq(data()[i], str[0]))
-                continue;
-
-            size_type j = 1;
-            for (; j < count; ++j) {
-                if (!Traits::eq(data()[i + j], str[j]))
-                    break;
-            }
-            if (j == count)
-                return i;
-        }
-        return npos;
+        pos = tiny_stl::min(pos, lhsSize - count);
+        const value_type* findAt =
+            details::stringSearchLast<Traits>(data(), pos + count, str, count);
+        return findAt == nullptr ? npos
+                                 : static_cast<size_type>(findAt - data());
     }
 
 public:
@@ -1457,9 +1433,7 @@ public:
     }
 
     size_type find(value_type ch, size_type pos = 0) const noexcept {
-        const value_type* findAt = Traits::find(data() + pos, size() - pos, ch);
-        return findAt == nullptr ? npos
-                                 : static_cast<size_type>(findAt - data());
+        return findHelper(&ch, pos, 1);
     }
 
     size_type rfind(const basic_string& str,
@@ -1473,14 +1447,113 @@ public:
     }
 
     size_type rfind(value_type ch, size_type pos = npos) const noexcept {
-        pos = tiny_stl::min(pos, size() - 1);
-        difference_type i = pos;
-        for (; i >= 0; --i) {
-            if (data()[i] == ch)
-                return static_cast<size_type>(i);
-        }
+        return rfindHelper(&ch, pos, 1);
+    }
 
-        return npos;
+private:
+    size_type findFirstOfHelper(const value_type* str, size_type pos,
+                                size_type count, bool inSet) const noexcept {
+        const size_type lhsSize = size();
+        if (pos >= lhsSize)
+            return npos;
+
+        const value_type* findAt = details::findFirstOf<Traits>(
+            data() + pos, lhsSize - pos, str, count, inSet);
+        return findAt == nullptr ? npos
+                                 : static_cast<size_type>(findAt - data());
+    }
+
+    // [0, pos]
+    size_type findLastOfHelper(const value_type* str, size_type pos,
+                               size_type count, bool inSet) const noexcept {
+        const size_type lhsSize = size();
+        if (lhsSize == 0)
+            return npos;
+
+        pos = tiny_stl::min(pos, lhsSize - 1);
+        const value_type* findAt =
+            details::findLastOf<Traits>(data(), pos + 1, str, count, inSet);
+        return findAt == nullptr ? npos
+                                 : static_cast<size_type>(findAt - data());
+    }
+
+public:
+    size_type find_first_of(const basic_string& str,
+                            size_type pos = 0) const noexcept {
+        return findFirstOfHelper(str.data(), pos, str.size(), true);
+    }
+
+    size_type find_first_of(const value_type* str, size_type pos,
+                            size_type count) const noexcept {
+        return findFirstOfHelper(str, pos, count, true);
+    }
+
+    size_type find_first_of(const value_type* str,
+                            size_type pos = 0) const noexcept {
+        return findFirstOfHelper(str, pos, Traits::length(str), true);
+    }
+
+    size_type find_first_of(value_type ch, size_type pos = 0) const noexcept {
+        return findFirstOfHelper(&ch, pos, 1, true);
+    }
+
+    size_type find_first_not_of(const basic_string& str,
+                                size_type pos = 0) const noexcept {
+        return findFirstOfHelper(str.data(), pos, str.size(), false);
+    }
+
+    size_type find_first_not_of(const value_type* str, size_type pos,
+                                size_type count) const noexcept {
+        return findFirstOfHelper(str, pos, count, false);
+    }
+
+    size_type find_first_not_of(const value_type* str,
+                                size_type pos = 0) const noexcept {
+        return findFirstOfHelper(str, pos, Traits::length(str), false);
+    }
+
+    size_type find_first_not_of(value_type ch,
+                                size_type pos = 0) const noexcept {
+        return findFirstOfHelper(&ch, pos, 1, false);
+    }
+
+    size_type find_last_of(const basic_string& str,
+                           size_type pos = npos) const noexcept {
+        return findLastOfHelper(str.data(), pos, str.size(), true);
+    }
+
+    size_type find_last_of(const value_type* str, size_type pos,
+                           size_type count) const noexcept {
+        return findLastOfHelper(str, pos, count, true);
+    }
+
+    size_type find_last_of(const value_type* str,
+                           size_type pos = npos) const noexcept {
+        return findLastOfHelper(str, pos, Traits::length(str), true);
+    }
+
+    size_type find_last_of(value_type ch, size_type pos = npos) const noexcept {
+        return findLastOfHelper(&ch, pos, 1, true);
+    }
+
+    size_type find_last_not_of(const basic_string& str,
+                               size_type pos = npos) const noexcept {
+        return findLastOfHelper(str.data(), pos, str.size(), false);
+    }
+
+    size_type find_last_not_of(const value_type* str, size_type pos,
+                               size_type count) const noexcept {
+        return findLastOfHelper(str, pos, count, false);
+    }
+
+    size_type find_last_not_of(const value_type* str,
+                               size_type pos = npos) const noexcept {
+        return findLastOfHelper(str, pos, Traits::length(str), false);
+    }
+
+    size_type find_last_not_of(value_type ch,
+                               size_type pos = npos) const noexcept {
+        return findLastOfHelper(&ch, pos, 1, false);
     }
 
 private:
@@ -1521,6 +1594,11 @@ private:
     }
 };
 
+// the short string buffer is found through capacity, not a pointer
+template <typename CharT, typename Traits, typename Alloc>
+struct is_trivially_relocatable<basic_string<CharT, Traits, Alloc>>
+    : is_trivially_relocatable<Alloc> {};
+
 template <typename CharT, typename Traits, typename Alloc>
 basic_string<CharT, Traits, Alloc>
 operator+(const basic_string<CharT, Traits, Alloc>& lhs,
@@ -1720,14 +1798,14 @@ operator>>(std::basic_istream<CharT, Traits>& is,
     return is;
 }
 
-template <typename CharT, typename Traits, typename Alloc>
-struct hash<basic_string<CharT, Traits, Alloc>> {
+template <typename CharT, typename Traits, typename Alloc, typename Policy>
+struct hash<basic_string<CharT, Traits, Alloc>, Policy> {
     using argument_type = basic_string<CharT, Traits, Alloc>;
     using result_type = std::size_t;
 
     std::size_t
     operator()(const basic_string<CharT, Traits, Alloc>& str) const noexcept {
-        return tiny_stl::hashFNV(str.c_str(), str.size());
+        return Policy::hash_bytes(str.c_str(), str.size() * sizeof(CharT));
     }
 };
 
@@ -0,0 +1,540 @@
+﻿// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if !defined(TINY_STL_NO_SIMD) &&                                            \
+    (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TINY_STL_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if !defined(TINY_STL_NO_SIMD) && (defined(__SSSE3__) || defined(__AVX__))
+#define TINY_STL_HAS_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+#if !defined(TINY_STL_NO_SIMD) && defined(__AVX2__)
+#define TINY_STL_HAS_AVX2 1
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "type_traits.hpp"
+
+namespace tiny_stl {
+
+namespace details {
+
+// substring search shared by basic_string, cow_basic_string and
+// basic_string_view.
+// bytes with std::char_traits: the first and the last character of the
+// needle filter 16/32 positions per step, long needles switch to Horspool
+// when the filter passes too many false candidates.
+// other characters or traits: Traits::find for the first character, then
+// Traits::compare
+template <typename CharT, typename Traits>
+using IsByteTraits =
+    bool_constant<sizeof(CharT) == 1 &&
+                  is_same<Traits, std::char_traits<CharT>>::value>;
+
+inline unsigned lowestBit32(std::uint32_t mask) noexcept {
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return static_cast<unsigned>(idx);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline unsigned highestBit32(std::uint32_t mask) noexcept {
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanReverse(&idx, mask);
+    return static_cast<unsigned>(idx);
+#else
+    return 31 - static_cast<unsigned>(__builtin_clz(mask));
+#endif
+}
+
+#if defined(TINY_STL_HAS_AVX2)
+
+struct ByteBlock {
+    static const std::size_t WIDTH = 32;
+
+    __m256i bytes;
+
+    explicit ByteBlock(unsigned char ch)
+        : bytes(_mm256_set1_epi8(static_cast<char>(ch))) {
+    }
+
+    // bit i is set if pos[i] == the broadcast character
+    std::uint32_t match(const unsigned char* pos) const noexcept {
+        const __m256i block =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+        return static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, bytes)));
+    }
+};
+
+#elif defined(TINY_STL_HAS_SSE2)
+
+struct ByteBlock {
+    static const std::size_t WIDTH = 16;
+
+    __m128i bytes;
+
+    explicit ByteBlock(unsigned char ch)
+        : bytes(_mm_set1_epi8(static_cast<char>(ch))) {
+    }
+
+    std::uint32_t match(const unsigned char* pos) const noexcept {
+        const __m128i block =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        return static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(block, bytes)));
+    }
+};
+
+#else // !TINY_STL_HAS_SSE2
+
+// scalar fallback, 8 bytes per step
+struct ByteBlock {
+    static const std::size_t WIDTH = 8;
+
+    unsigned char ch;
+
+    explicit ByteBlock(unsigned char c) : ch(c) {
+    }
+
+    std::uint32_t match(const unsigned char* pos) const noexcept {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < WIDTH; ++i)
+            mask |= static_cast<std::uint32_t>(pos[i] == ch) << i;
+        return mask;
+    }
+};
+
+#endif // TINY_STL_HAS_AVX2
+
+static const std::size_t HORSPOOL_MIN = 64;
+
+inline const unsigned char* horspoolSearch(const unsigned char* hay,
+                                           std::size_t n,
+                                           const unsigned char* s,
+                                           std::size_t m) noexcept {
+    if (m > n)
+        return nullptr;
+
+    std::size_t skip[256];
+    for (std::size_t i = 0; i < 256; ++i)
+        skip[i] = m;
+    for (std::size_t i = 0; i + 1 < m; ++i)
+        skip[s[i]] = m - 1 - i;
+
+    const unsigned char last = s[m - 1];
+    for (std::size_t i = 0; i <= n - m;) {
+        const unsigned char ch = hay[i + m - 1];
+        if (ch == last && std::memcmp(hay + i, s, m - 1) == 0)
+            return hay + i;
+        i += skip[ch];
+    }
+
+    return nullptr;
+}
+
+// 1 <= m <= n
+inline const unsigned char* byteSearch(const unsigned char* hay,
+                                       std::size_t n, const unsigned char* s,
+                                       std::size_t m) noexcept {
+    if (m == 1)
+        return static_cast<const unsigned char*>(std::memchr(hay, s[0], n));
+
+    const ByteBlock first(s[0]);
+    const ByteBlock last(s[m - 1]);
+    const std::size_t end = n - m + 1; // candidate positions [0, end)
+    std::size_t misses = 0;
+    std::size_t i = 0;
+    for (; i + ByteBlock::WIDTH <= end; i += ByteBlock::WIDTH) {
+        std::uint32_t mask = first.match(hay + i) & last.match(hay + i + m - 1);
+        while (mask != 0) {
+            const std::size_t pos = i + lowestBit32(mask);
+            if (std::memcmp(hay + pos + 1, s + 1, m - 2) == 0)
+                return hay + pos;
+            mask &= mask - 1;
+
+            // the filter keeps failing on a long needle, skip by Horspool
+            if (m >= HORSPOOL_MIN && ++misses * 8 > pos + 256) {
+                return horspoolSearch(hay + pos + 1, n - pos - 1, s, m);
+            }
+        }
+    }
+
+    for (; i < end; ++i) {
+        if (hay[i] == s[0] && hay[i + m - 1] == s[m - 1] &&
+            std::memcmp(hay + i + 1, s + 1, m - 2) == 0)
+            return hay + i;
+    }
+
+    return nullptr;
+}
+
+// the last match, 1 <= m <= n
+inline const unsigned char* byteSearchLast(const unsigned char* hay,
+                                           std::size_t n,
+                                           const unsigned char* s,
+                                           std::size_t m) noexcept {
+    const ByteBlock first(s[0]);
+    const ByteBlock last(s[m - 1]);
+    std::size_t end = n - m + 1;
+    for (; end >= ByteBlock::WIDTH; end -= ByteBlock::WIDTH) {
+        const std::size_t i = end - ByteBlock::WIDTH;
+        std::uint32_t mask = first.match(hay + i) & last.match(hay + i + m - 1);
+        while (mask != 0) {
+            const unsigned bit = highestBit32(mask);
+            const std::size_t pos = i + bit;
+            if (m == 1 || std::memcmp(hay + pos + 1, s + 1, m - 2) == 0)
+                return hay + pos;
+            mask &= ~(std::uint32_t{1} << bit);
+        }
+    }
+
+    while (end-- > 0) {
+        if (hay[end] == s[0] && hay[end + m - 1] == s[m - 1] &&
+            (m == 1 || std::memcmp(hay + end + 1, s + 1, m - 2) == 0))
+            return hay + end;
+    }
+
+    return nullptr;
+}
+
+template <typename Traits, typename CharT>
+inline const CharT* stringSearchAux(const CharT* hay, std::size_t n,
+                                    const CharT* s, std::size_t m,
+                                    true_type) noexcept {
+    return reinterpret_cast<const CharT*>(
+        byteSearch(reinterpret_cast<const unsigned char*>(hay), n,
+                   reinterpret_cast<const unsigned char*>(s), m));
+}
+
+template <typename Traits, typename CharT>
+inline const CharT* stringSearchAux(const CharT* hay, std::size_t n,
+                                    const CharT* s, std::size_t m,
+                                    false_type) noexcept {
+    const CharT* const end = hay + (n - m + 1);
+    for (const CharT* pos = hay; pos != end; ++pos) {
+        pos = Traits::find(pos, static_cast<std::size_t>(end - pos), s[0]);
+        if (pos == nullptr)
+            return nullptr;
+        if (Traits::compare(pos + 1, s + 1, m - 1) == 0)
+            return pos;
+    }
+
+    return nullptr;
+}
+
+template <typename Traits, typename CharT>
+inline const CharT* stringSearchLastAux(const CharT* hay, std::size_t n,
+                                        const CharT* s, std::size_t m,
+                                        true_type) noexcept {
+    return reinterpret_cast<const CharT*>(
+        byteSearchLast(reinterpret_cast<const unsigned char*>(hay), n,
+                       reinterpret_cast<const unsigned char*>(s), m));
+}
+
+template <typename Traits, typename CharT>
+inline const CharT* stringSearchLastAux(const CharT* hay, std::size_t n,
+                                        const CharT* s, std::size_t m,
+                                        false_type) noexcept {
+    for (std::size_t i = n - m + 1; i-- > 0;) {
+        if (Traits::eq(hay[i], s[0]) &&
+            Traits::compare(hay + i + 1, s + 1, m - 1) == 0)
+            return hay + i;
+    }
+
+    return nullptr;
+}
+
+// the first occurrence of [s, s + m) in [hay, hay + n), or nullptr
+template <typename Traits, typename CharT>
+inline const CharT* stringSearch(const CharT* hay, std::size_t n,
+                                 const CharT* s, std::size_t m) noexcept {
+    if (m > n)
+        return nullptr;
+    if (m == 0)
+        return hay;
+
+    return stringSearchAux<Traits>(hay, n, s, m, IsByteTraits<CharT, Traits>{});
+}
+
+// the last occurrence of [s, s + m) in [hay, hay + n), or nullptr
+template <typename Traits, typename CharT>
+inline const CharT* stringSearchLast(const CharT* hay, std::size_t n,
+                                     const CharT* s, std::size_t m) noexcept {
+    if (m > n)
+        return nullptr;
+    if (m == 0)
+        return hay + n;
+
+    return stringSearchLastAux<Traits>(hay, n, s, m,
+                                       IsByteTraits<CharT, Traits>{});
+}
+
+// find_first_of family.
+// up to SMALL_CHAR_SET characters are compared with ByteBlock, a larger
+// ASCII set with SSSE3 is classified by two nibble lookups, both 16/32
+// characters per step. other sets test a 256-bit bitmap per character
+static const std::size_t SMALL_CHAR_SET = 8;
+
+// match(pos): bit i is set if pos[i] is in the set
+class SmallCharSet {
+private:
+    const unsigned char* chars;
+    std::size_t count;
+
+public:
+    static const std::size_t WIDTH = ByteBlock::WIDTH;
+
+    // 1 <= m <= SMALL_CHAR_SET
+    SmallCharSet(const unsigned char* s, std::size_t m) noexcept
+        : chars(s), count(m) {
+    }
+
+    std::uint32_t match(const unsigned char* pos) const noexcept {
+        std::uint32_t mask = ByteBlock(chars[0]).match(pos);
+        for (std::size_t i = 1; i < count; ++i)
+            mask |= ByteBlock(chars[i]).match(pos);
+        return mask;
+    }
+
+    bool contains(unsigned char ch) const noexcept {
+        return std::memchr(chars, ch, count) != nullptr;
+    }
+};
+
+#ifdef TINY_STL_HAS_SSSE3
+
+// the low nibble selects a byte of high nibble bits, the high nibble
+// selects one bit. only characters < 0x80 can be in the set
+class NibbleCharSet {
+private:
+    alignas(16) unsigned char low[16];
+#ifdef TINY_STL_HAS_AVX2
+    __m256i lowTable;
+    __m256i highTable;
+#else
+    __m128i lowTable;
+    __m128i highTable;
+#endif
+
+public:
+#ifdef TINY_STL_HAS_AVX2
+    static const std::size_t WIDTH = 32;
+#else
+    static const std::size_t WIDTH = 16;
+#endif
+
+    NibbleCharSet(const unsigned char* s, std::size_t m) noexcept : low{} {
+        for (std::size_t i = 0; i < m; ++i)
+            low[s[i] & 0x0f] |= static_cast<unsigned char>(1u << (s[i] >> 4));
+
+        const __m128i lowBytes =
+            _mm_load_si128(reinterpret_cast<const __m128i*>(low));
+        const __m128i highBytes =
+            _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+#ifdef TINY_STL_HAS_AVX2
+        lowTable = _mm256_broadcastsi128_si256(lowBytes);
+        highTable = _mm256_broadcastsi128_si256(highBytes);
+#else
+        lowTable = lowBytes;
+        highTable = highBytes;
+#endif
+    }
+
+    std::uint32_t match(const unsigned char* pos) const noexcept {
+#ifdef TINY_STL_HAS_AVX2
+        const __m256i nibble = _mm256_set1_epi8(0x0f);
+        const __m256i block =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+        const __m256i lows = _mm256_shuffle_epi8(
+            lowTable, _mm256_and_si256(block, nibble));
+        const __m256i highs = _mm256_shuffle_epi8(
+            highTable, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble));
+        const __m256i miss = _mm256_cmpeq_epi8(_mm256_and_si256(lows, highs),
+                                               _mm256_setzero_si256());
+        return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(miss));
+#else
+        const __m128i nibble = _mm_set1_epi8(0x0f);
+        const __m128i block =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        const __m128i lows =
+            _mm_shuffle_epi8(lowTable, _mm_and_si128(block, nibble));
+        const __m128i highs = _mm_shuffle_epi8(
+            highTable, _mm_and_si128(_mm_srli_epi16(block, 4), nibble));
+        const __m128i miss =
+            _mm_cmpeq_epi8(_mm_and_si128(lows, highs), _mm_setzero_si128());
+        return ~static_cast<std::uint32_t>(_mm_movemask_epi8(miss)) & 0xffff;
+#endif
+    }
+
+    bool contains(unsigned char ch) const noexcept {
+        return ch < 0x80 && ((low[ch & 0x0f] >> (ch >> 4)) & 1);
+    }
+};
+
+#endif // TINY_STL_HAS_SSSE3
+
+// scalar, 8 characters per step
+class BitmapCharSet {
+private:
+    std::uint64_t bits[4];
+
+public:
+    static const std::size_t WIDTH = 8;
+
+    BitmapCharSet(const unsigned char* s, std::size_t m) noexcept
+        : bits{0, 0, 0, 0} {
+        for (std::size_t i = 0; i < m; ++i)
+            bits[s[i] >> 6] |= std::uint64_t{1} << (s[i] & 63);
+    }
+
+    std::uint32_t match(const unsigned char* pos) const noexcept {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < WIDTH; ++i)
+            mask |= static_cast<std::uint32_t>(contains(pos[i])) << i;
+        return mask;
+    }
+
+    bool contains(unsigned char ch) const noexcept {
+        return (bits[ch >> 6] >> (ch & 63)) & 1;
+    }
+};
+
+// the first character in (inSet) or not in the set
+template <typename CharSet>
+inline const unsigned char* scanFirstOf(const CharSet& set,
+                                        const unsigned char* hay,
+                                        std::size_t n, bool inSet) noexcept {
+    const std::uint32_t flip =
+        inSet ? 0 : static_cast<std::uint32_t>(~0ull >> (64 - CharSet::WIDTH));
+    std::size_t i = 0;
+    for (; i + CharSet::WIDTH <= n; i += CharSet::WIDTH) {
+        const std::uint32_t mask = set.match(hay + i) ^ flip;
+        if (mask != 0)
+            return hay + i + lowestBit32(mask);
+    }
+
+    for (; i < n; ++i) {
+        if (set.contains(hay[i]) == inSet)
+            return hay + i;
+    }
+
+    return nullptr;
+}
+
+template <typename CharSet>
+inline const unsigned char* scanLastOf(const CharSet& set,
+                                       const unsigned char* hay,
+                                       std::size_t n, bool inSet) noexcept {
+    const std::uint32_t flip =
+        inSet ? 0 : static_cast<std::uint32_t>(~0ull >> (64 - CharSet::WIDTH));
+    for (; n >= CharSet::WIDTH; n -= CharSet::WIDTH) {
+        const std::uint32_t mask =
+            set.match(hay + (n - CharSet::WIDTH)) ^ flip;
+        if (mask != 0)
+            return hay + (n - CharSet::WIDTH) + highestBit32(mask);
+    }
+
+    while (n-- > 0) {
+        if (set.contains(hay[n]) == inSet)
+            return hay + n;
+    }
+
+    return nullptr;
+}
+
+template <typename CharSet>
+inline const unsigned char* scanOf(const CharSet& set,
+                                   const unsigned char* hay, std::size_t n,
+                                   bool inSet, bool last) noexcept {
+    return last ? scanLastOf(set, hay, n, inSet)
+                : scanFirstOf(set, hay, n, inSet);
+}
+
+inline bool isAsciiSet(const unsigned char* s, std::size_t m) noexcept {
+    for (std::size_t i = 0; i < m; ++i) {
+        if (s[i] >= 0x80)
+            return false;
+    }
+    return true;
+}
+
+inline const unsigned char* byteFindOf(const unsigned char* hay,
+                                       std::size_t n, const unsigned char* s,
+                                       std::size_t m, bool inSet,
+                                       bool last) noexcept {
+    if (m > 0 && m <= SMALL_CHAR_SET)
+        return scanOf(SmallCharSet(s, m), hay, n, inSet, last);
+
+#ifdef TINY_STL_HAS_SSSE3
+    if (isAsciiSet(s, m))
+        return scanOf(NibbleCharSet(s, m), hay, n, inSet, last);
+#endif // TINY_STL_HAS_SSSE3
+
+    return scanOf(BitmapCharSet(s, m), hay, n, inSet, last);
+}
+
+template <typename Traits, typename CharT>
+inline const CharT* findOfAux(const CharT* hay, std::size_t n,
+                              const CharT* s, std::size_t m, bool inSet,
+                              bool last, true_type) noexcept {
+    return reinterpret_cast<const CharT*>(
+        byteFindOf(reinterpret_cast<const unsigned char*>(hay), n,
+                   reinterpret_cast<const unsigned char*>(s), m, inSet, last));
+}
+
+template <typename Traits, typename CharT>
+inline const CharT* findOfAux(const CharT* hay, std::size_t n,
+                              const CharT* s, std::size_t m, bool inSet,
+                              bool last, false_type) noexcept {
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::size_t i = last ? n - 1 - k : k;
+        if ((Traits::find(s, m, hay[i]) != nullptr) == inSet)
+            return hay + i;
+    }
+
+    return nullptr;
+}
+
+// the first character of [hay, hay + n) which is (inSet) or is not
+// (!inSet) in [s, s + m), or nullptr
+template <typename Traits, typename CharT>
+inline const CharT* findFirstOf(const CharT* hay, std::size_t n,
+                                const CharT* s, std::size_t m,
+                                bool inSet) noexcept {
+    return findOfAux<Traits>(hay, n, s, m, inSet, false,
+                             IsByteTraits<CharT, Traits>{});
+}
+
+// the last one
+template <typename Traits, typename CharT>
+inline const CharT* findLastOf(const CharT* hay, std::size_t n,
+                               const CharT* s, std::size_t m,
+                               bool inSet) noexcept {
+    return findOfAux<Traits>(hay, n, s, m, inSet, true,
+                             IsByteTraits<CharT, Traits>{});
+}
+
+} // namespace details
+
+} // namespace tiny_stl
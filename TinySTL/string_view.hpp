@@ -10,6 +10,7 @@
 #include <stdexcept>
 
 #include "string.hpp"
+#include "string_search.hpp"
 
 namespace tiny_stl {
 
@@ -444,26 +445,14 @@ public:
 
     XCONSTEXPR14
     size_type find(basic_string_view rhs, size_type pos1 = 0) const noexcept {
-        if (mSize < rhs.mSize || pos1 + rhs.mSize > mSize) {
+        // scalar so it stays constexpr, basic_string has the SIMD search
+        if (pos1 > mSize || rhs.mSize > mSize - pos1) {
             return npos;
         }
 
-        if (rhs.empty()) { // always matches
-            return min(pos1, mSize);
-        }
-
         for (size_type i = pos1; i <= mSize - rhs.mSize; ++i) {
-            if (mData[i] == rhs[0]) { // matched the first element
-                size_type j = 1;
-                for (j = 1; j < rhs.mSize; ++j) {
-                    if (mData[i + j] != rhs[j]) { // mismatched
-                        break;
-                    }
-                }
-
-                if (j == rhs.mSize) {
-                    return i; // matched
-                }
+            if (matchAt(i, rhs)) {
+                return i;
             }
         }
 
@@ -472,13 +461,7 @@ public:
 
     XCONSTEXPR14
     size_type find(CharT ch, size_type pos1 = 0) const noexcept {
-        for (size_type i = pos1; i < mSize; ++i) {
-            if (mData[i] == ch) {
-                return i; // matched
-            }
-        }
-
-        return npos;
+        return find(basic_string_view{&ch, 1}, pos1);
     }
 
     XCONSTEXPR14
@@ -495,27 +478,13 @@ public:
     XCONSTEXPR14
     size_type rfind(basic_string_view rhs,
                     size_type pos1 = npos) const noexcept {
-        if (rhs.mSize == 0) { // always matches
-            return min(pos1, mSize);
-        }
-
         if (rhs.mSize > mSize) {
             return npos;
         }
 
-        for (size_type i = min(pos1, mSize - rhs.mSize);
-             i != static_cast<size_type>(-1); --i) {
-            if (mData[i] == rhs[0]) { // matched the first element
-                size_type j = 1;
-                for (j = 1; j < rhs.mSize; ++j) {
-                    if (mData[i + j] != rhs[j]) {
-                        break;
-                    }
-                }
-
-                if (j == rhs.mSize) {
-                    return i;
-                }
+        for (size_type i = min(pos1, mSize - rhs.mSize) + 1; i-- > 0;) {
+            if (matchAt(i, rhs)) {
+                return i;
             }
         }
 
@@ -524,17 +493,7 @@ public:
 
     XCONSTEXPR14
     size_type rfind(CharT ch, size_type pos1 = npos) const noexcept {
-        if (mSize == 0) {
-            return npos;
-        }
-
-        for (int i = static_cast<int>(min(pos1, mSize - 1)); i >= 0; --i) {
-            if (mData[i] == ch) {
-                return i; // matched
-            }
-        }
-
-        return npos;
+        return rfind(basic_string_view{&ch, 1}, pos1);
     }
 
     XCONSTEXPR14 size_type rfind(const CharT* str, size_type pos1,
@@ -547,6 +506,120 @@ public:
         return rfind(basic_string_view{str}, pos1);
     }
 
+    size_type find_first_of(basic_string_view str,
+                            size_type pos = 0) const noexcept {
+        return findFirstOfHelper(str.mData, pos, str.mSize, true);
+    }
+
+    size_type find_first_of(const CharT* str, size_type pos,
+                            size_type count) const noexcept {
+        return findFirstOfHelper(str, pos, count, true);
+    }
+
+    size_type find_first_of(const CharT* str,
+                            size_type pos = 0) const noexcept {
+        return findFirstOfHelper(str, pos, Traits::length(str), true);
+    }
+
+    size_type find_first_of(CharT ch, size_type pos = 0) const noexcept {
+        return findFirstOfHelper(&ch, pos, 1, true);
+    }
+
+    size_type find_first_not_of(basic_string_view str,
+                                size_type pos = 0) const noexcept {
+        return findFirstOfHelper(str.mData, pos, str.mSize, false);
+    }
+
+    size_type find_first_not_of(const CharT* str, size_type pos,
+                                size_type count) const noexcept {
+        return findFirstOfHelper(str, pos, count, false);
+    }
+
+    size_type find_first_not_of(const CharT* str,
+                                size_type pos = 0) const noexcept {
+        return findFirstOfHelper(str, pos, Traits::length(str), false);
+    }
+
+    size_type find_first_not_of(CharT ch, size_type pos = 0) const noexcept {
+        return findFirstOfHelper(&ch, pos, 1, false);
+    }
+
+    size_type find_last_of(basic_string_view str,
+                           size_type pos = npos) const noexcept {
+        return findLastOfHelper(str.mData, pos, str.mSize, true);
+    }
+
+    size_type find_last_of(const CharT* str, size_type pos,
+                           size_type count) const noexcept {
+        return findLastOfHelper(str, pos, count, true);
+    }
+
+    size_type find_last_of(const CharT* str,
+                           size_type pos = npos) const noexcept {
+        return findLastOfHelper(str, pos, Traits::length(str), true);
+    }
+
+    size_type find_last_of(CharT ch, size_type pos = npos) const noexcept {
+        return findLastOfHelper(&ch, pos, 1, true);
+    }
+
+    size_type find_last_not_of(basic_string_view str,
+                               size_type pos = npos) const noexcept {
+        return findLastOfHelper(str.mData, pos, str.mSize, false);
+    }
+
+    size_type find_last_not_of(const CharT* str, size_type pos,
+                               size_type count) const noexcept {
+        return findLastOfHelper(str, pos, count, false);
+    }
+
+    size_type find_last_not_of(const CharT* str,
+                               size_type pos = npos) const noexcept {
+        return findLastOfHelper(str, pos, Traits::length(str), false);
+    }
+
+    size_type find_last_not_of(CharT ch, size_type pos = npos) const noexcept {
+        return findLastOfHelper(&ch, pos, 1, false);
+    }
+
+    XCONSTEXPR14 bool matchAt(size_type pos,
+                              basic_string_view rhs) const noexcept {
+        for (size_type i = 0; i < rhs.mSize; ++i) {
+            if (!Traits::eq(mData[pos + i], rhs.mData[i])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // not constexpr, the char set search in details is vectorized
+    size_type findFirstOfHelper(const CharT* str, size_type pos,
+                                size_type count, bool inSet) const noexcept {
+        if (pos >= mSize) {
+            return npos;
+        }
+
+        const CharT* findAt = details::findFirstOf<Traits>(
+            mData + pos, mSize - pos, str, count, inSet);
+        return findAt == nullptr ? npos
+                                 : static_cast<size_type>(findAt - mData);
+    }
+
+    // [0, pos]
+    size_type findLastOfHelper(const CharT* str, size_type pos,
+                               size_type count, bool inSet) const noexcept {
+        if (mSize == 0) {
+            return npos;
+        }
+
+        pos = min(pos, mSize - 1);
+        const CharT* findAt =
+            details::findLastOf<Traits>(mData, pos + 1, str, count, inSet);
+        return findAt == nullptr ? npos
+                                 : static_cast<size_type>(findAt - mData);
+    }
+
     static XCONSTEXPR14 size_type getStringLength(const_pointer str) noexcept {
         size_type len = Traits::length(str);
         return len;
@@ -637,14 +710,14 @@ operator<<(std::basic_ostream<CharT, Traits>& os,
     return os;
 }
 
-template <typename CharT, typename Traits>
-struct hash<basic_string_view<CharT, Traits>> {
+template <typename CharT, typename Traits, typename Policy>
+struct hash<basic_string_view<CharT, Traits>, Policy> {
     using argument_type = basic_string_view<CharT, Traits>;
     using result_type = std::size_t;
 
     std::size_t operator()(const basic_string_view<CharT, Traits>& str) const
         noexcept {
-        return tiny_stl::hashFNV(str.data(), str.size());
+        return Policy::hash_bytes(str.data(), str.size() * sizeof(CharT));
     }
 };
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2021 syn1w
+﻿// Copyright (C) 2021 syn1w
 // Distributed under the MIT software license, see the accompanying
 // file LICENSE or http://www.opensource.org/licenses/mit-license.php.
 
@@ -9,20 +9,33 @@
 
 #include <chrono>
 #include <climits>
+#include <cstring>
 #include <ctime>
 #include <iostream>
+#include <thread>
 
 #include "array.hpp"
+#include "btree_map.hpp"
+#include "btree_set.hpp"
 #include "cow_string.hpp"
 #include "deque.hpp"
+#include "execution.hpp"
+#include "flat_map.hpp"
+#include "flat_set.hpp"
 #include "forward_list.hpp"
 #include "iterator.hpp"
 #include "list.hpp"
 #include "map.hpp"
 #include "memory.hpp"
+#include "memory_resource.hpp"
+#include "order_statistic.hpp"
+#include "pool_allocator.hpp"
 #include "queue.hpp"
 #include "rbtree.hpp"
+#include "rope.hpp"
+#include "searcher.hpp"
 #include "set.hpp"
+#include "small_vector.hpp"
 #include "stack.hpp"
 #include "string.hpp"
 #include "string_view.hpp"
@@ -249,23 +262,379 @@ void testAlgorithm() {
     tiny_stl::sort(vs.begin(), vs.end());
     UNIT_TEST(true, tiny_stl::is_sorted(vs.begin(), vs.end()));
 
-#if 0
-    tiny_stl::vector<int> bigNums(100'000'000);
-    for (int i = 0; i < 100'000'000; ++i)
-    {
-        bigNums[i] = rand();
+    // sorted, reversed, sawtooth, duplicates and random inputs
+    const int kSortSize = 10000;
+    tiny_stl::vector<tiny_stl::vector<int>> patterns(5);
+    for (int i = 0; i < kSortSize; ++i) {
+        patterns[0].push_back(i);
+        patterns[1].push_back(kSortSize - i);
+        patterns[2].push_back(i % 100);
+        patterns[3].push_back(rand() % 4);
+        patterns[4].push_back(rand());
+    }
+    for (auto& pv : patterns) {
+        auto pg = pv;
+        tiny_stl::sort(pv.begin(), pv.end());
+        UNIT_TEST(true, tiny_stl::is_sorted(pv.begin(), pv.end()));
+        tiny_stl::sort(pg.begin(), pg.end(), tiny_stl::greater<>{});
+        UNIT_TEST(true, tiny_stl::is_sorted(pg.begin(), pg.end(),
+                                            tiny_stl::greater<>{}));
+    }
+
+    // arithmetic keys with less<>/greater<> take the block partition
+    UNIT_TEST(true, (tiny_stl::IsBranchlessCompare<double,
+                                                   tiny_stl::less<>>::value));
+    UNIT_TEST(false, (tiny_stl::IsBranchlessCompare<tiny_stl::string,
+                                                    tiny_stl::less<>>::value));
+    tiny_stl::vector<double> ds;
+    for (int i = 0; i < kSortSize; ++i)
+        ds.push_back((rand() % 1000) / 8.0);
+    auto dg = ds;
+    tiny_stl::sort(ds.begin(), ds.end(), tiny_stl::less<double>{});
+    UNIT_TEST(true, tiny_stl::is_sorted(ds.begin(), ds.end()));
+    tiny_stl::sort(dg.begin(), dg.end(), tiny_stl::greater<double>{});
+    UNIT_TEST(true, tiny_stl::is_sorted(dg.begin(), dg.end(),
+                                        tiny_stl::greater<double>{}));
+
+    // radix_sort on signed, floating point and pair keys
+    tiny_stl::vector<long long> rs;
+    tiny_stl::vector<float> rf;
+    for (int i = 0; i < kSortSize; ++i) {
+        rs.push_back((static_cast<long long>(rand()) - RAND_MAX / 2) * 1000000);
+        rf.push_back((rand() % 2001 - 1000) / 7.0f);
+    }
+    rs.push_back(LLONG_MIN);
+    rs.push_back(LLONG_MAX);
+    tiny_stl::radix_sort(rs.begin(), rs.end());
+    UNIT_TEST(true, tiny_stl::is_sorted(rs.begin(), rs.end()));
+    UNIT_TEST(LLONG_MIN, rs.front());
+    tiny_stl::radix_sort(rf.begin(), rf.end());
+    UNIT_TEST(true, tiny_stl::is_sorted(rf.begin(), rf.end()));
+
+    // group, then id % 3 descending, equal keys keep the id order
+    using RadixItem = tiny_stl::pair<int, int>;
+    tiny_stl::vector<RadixItem> ri;
+    for (int i = 0; i < 2000; ++i)
+        ri.emplace_back(i, (i * 7) % 10 - 5);
+    tiny_stl::radix_sort(ri.begin(), ri.end(), [](const RadixItem& x) {
+        return tiny_stl::tuple<int, double>(x.second, -(x.first % 3) / 2.0);
+    });
+    bool radixStable = true;
+    for (std::size_t i = 1; i < ri.size(); ++i) {
+        const RadixItem& x = ri[i - 1];
+        const RadixItem& y = ri[i];
+        radixStable = radixStable &&
+                      (x.second < y.second ||
+                       (x.second == y.second &&
+                        (x.first % 3 > y.first % 3 ||
+                         (x.first % 3 == y.first % 3 && x.first < y.first))));
     }
+    UNIT_TEST(true, radixStable);
 
-    auto begin1 = std::chrono::high_resolution_clock::now();
-    tiny_stl::sort(bigNums.begin(), bigNums.end());
-    auto end1 = std::chrono::high_resolution_clock::now();
+    tiny_stl::vector<tiny_stl::string> ss;
+    for (int i = 0; i < 1000; ++i)
+        ss.push_back(tiny_stl::to_string(rand() % 200));
+    tiny_stl::sort(ss.begin(), ss.end());
+    UNIT_TEST(true, tiny_stl::is_sorted(ss.begin(), ss.end()));
+
+    // stable_sort keeps the index order of equal keys on every pattern
+    using StableItem = tiny_stl::pair<int, int>;
+    auto byKey = [](const StableItem& x, const StableItem& y) {
+        return x.first < y.first;
+    };
+    for (int n : {0, 1, 2, 63, 64, 65, 1000, kSortSize}) {
+        for (auto& pv : patterns) {
+            tiny_stl::vector<StableItem> si;
+            for (int i = 0; i < n; ++i)
+                si.emplace_back(pv[i] % 50, i);
+            tiny_stl::stable_sort(si.begin(), si.end(), byKey);
+            bool stable = true;
+            for (std::size_t i = 1; i < si.size(); ++i) {
+                stable = stable && (si[i - 1].first < si[i].first ||
+                                    (si[i - 1].first == si[i].first &&
+                                     si[i - 1].second < si[i].second));
+            }
+            UNIT_TEST(true, stable);
+        }
+    }
+    auto sg = ss;
+    tiny_stl::stable_sort(ss.begin(), ss.end());
+    UNIT_TEST(true, tiny_stl::is_sorted(ss.begin(), ss.end()));
+    tiny_stl::stable_sort(sg.begin(), sg.end(), tiny_stl::greater<>{});
+    UNIT_TEST(true,
+              tiny_stl::is_sorted(sg.begin(), sg.end(), tiny_stl::greater<>{}));
+
+    // partial_sort and nth_element agree with the full sort
+    tiny_stl::vector<int> sel = patterns[4];
+    auto full = sel;
+    tiny_stl::sort(full.begin(), full.end());
+    for (int k : {0, 1, 10, kSortSize / 2, kSortSize - 1, kSortSize}) {
+        auto ps = sel;
+        tiny_stl::partial_sort(ps.begin(), ps.begin() + k, ps.end());
+        UNIT_TEST(true, tiny_stl::equal(ps.begin(), ps.begin() + k,
+                                        full.begin()));
+        if (k == kSortSize)
+            continue;
+        auto ns = sel;
+        tiny_stl::nth_element(ns.begin(), ns.begin() + k, ns.end());
+        UNIT_TEST(full[k], ns[k]);
+        UNIT_TEST(true, tiny_stl::all_of(ns.begin(), ns.begin() + k,
+                                         [&](int x) { return x <= ns[k]; }));
+        UNIT_TEST(true, tiny_stl::all_of(ns.begin() + k, ns.end(),
+                                         [&](int x) { return x >= ns[k]; }));
+    }
+    auto nsd = patterns[3];
+    tiny_stl::nth_element(nsd.begin(), nsd.begin() + 100, nsd.end(),
+                          tiny_stl::greater<>{});
+    UNIT_TEST(3, nsd[100]);
+
+    // many equal keys, the block equal to the pivot is skipped at once
+    tiny_stl::vector<int> few;
+    for (int i = 0; i < kSortSize; ++i)
+        few.push_back(i % 3 == 0 ? 1 : rand() % 3);
+    auto fewSorted = few;
+    tiny_stl::sort(fewSorted.begin(), fewSorted.end());
+    for (int k : {0, kSortSize / 3, kSortSize / 2, kSortSize - 1}) {
+        auto nf = few;
+        tiny_stl::nth_element(nf.begin(), nf.begin() + k, nf.end());
+        UNIT_TEST(fewSorted[k], nf[k]);
+        UNIT_TEST(true, tiny_stl::all_of(nf.begin(), nf.begin() + k,
+                                         [&](int x) { return x <= nf[k]; }));
+        UNIT_TEST(true, tiny_stl::all_of(nf.begin() + k, nf.end(),
+                                         [&](int x) { return x >= nf[k]; }));
+    }
 
-    std::cout << "time: " << ((end1 - begin1).count() / 1000000.0) << "ms" << std::endl;
+    // search and the searchers find the first occurrence
+    tiny_stl::string hay = "here is a simple example, an example";
+    tiny_stl::string pat = "example";
+    tiny_stl::string none = "examples";
+    UNIT_TEST(17, tiny_stl::search(hay.begin(), hay.end(), pat.begin(),
+                                   pat.end()) -
+                      hay.begin());
+    UNIT_TEST(true, tiny_stl::search(hay.begin(), hay.end(), none.begin(),
+                                     none.end()) == hay.end());
+    UNIT_TEST(true, tiny_stl::search(hay.begin(), hay.end(), pat.begin(),
+                                     pat.begin()) == hay.begin());
+    auto caseless = [](char x, char y) { return (x | 0x20) == (y | 0x20); };
+    tiny_stl::string upper = "EXAMPLE";
+    UNIT_TEST(17, tiny_stl::search(hay.begin(), hay.end(), upper.begin(),
+                                   upper.end(), caseless) -
+                      hay.begin());
+
+    using StrIter = tiny_stl::string::iterator;
+    tiny_stl::default_searcher<StrIter> dfs(pat.begin(), pat.end());
+    tiny_stl::boyer_moore_horspool_searcher<StrIter> bmh(pat.begin(),
+                                                         pat.end());
+    tiny_stl::boyer_moore_searcher<StrIter> bm(pat.begin(), pat.end());
+    tiny_stl::deque<char> dhay(hay.begin(), hay.end());
+    tiny_stl::vector<char> vhay(hay.begin(), hay.end());
+    UNIT_TEST(17, tiny_stl::search(hay.begin(), hay.end(), dfs) - hay.begin());
+    UNIT_TEST(17, tiny_stl::search(hay.begin(), hay.end(), bmh) - hay.begin());
+    UNIT_TEST(17, tiny_stl::search(hay.begin(), hay.end(), bm) - hay.begin());
+    UNIT_TEST(17, tiny_stl::search(dhay.begin(), dhay.end(), bmh) -
+                      dhay.begin());
+    UNIT_TEST(17, tiny_stl::search(vhay.begin(), vhay.end(), bm) -
+                      vhay.begin());
+    UNIT_TEST(29, tiny_stl::search(hay.begin() + 18, hay.end(), bm) -
+                      hay.begin());
+    auto bmRange = bm(hay.begin(), hay.end());
+    UNIT_TEST(7, bmRange.second - bmRange.first);
+    auto bmNone = bm(hay.begin(), hay.begin() + 20);
+    UNIT_TEST(true, bmNone.first == hay.begin() + 20 &&
+                        bmNone.second == hay.begin() + 20);
+    tiny_stl::boyer_moore_searcher<StrIter> bmEmpty(pat.begin(), pat.begin());
+    UNIT_TEST(true, tiny_stl::search(hay.begin(), hay.end(), bmEmpty) ==
+                        hay.begin());
+
+    // non-byte keys use the hash table, periodic patterns the good suffix
+    tiny_stl::vector<int> ihay = {1, 2, 1, 2, 1, 2, 3, 1, 2, 1, 2, 3, 4};
+    tiny_stl::vector<int> ipat = {1, 2, 1, 2, 3};
+    using IntIter = tiny_stl::vector<int>::iterator;
+    tiny_stl::boyer_moore_searcher<IntIter> ibm(ipat.begin(), ipat.end());
+    tiny_stl::boyer_moore_horspool_searcher<IntIter> ibmh(ipat.begin(),
+                                                          ipat.end());
+    UNIT_TEST(2, tiny_stl::search(ihay.begin(), ihay.end(), ibm) -
+                     ihay.begin());
+    UNIT_TEST(2, tiny_stl::search(ihay.begin(), ihay.end(), ibmh) -
+                     ihay.begin());
+    UNIT_TEST(7, tiny_stl::search(ihay.begin() + 3, ihay.end(), ibm) -
+                     ihay.begin());
+    UNIT_TEST(true, tiny_stl::search(ihay.begin() + 8, ihay.end(), ibmh) ==
+                        ihay.end());
 
-    UNIT_TEST(true, tiny_stl::is_sorted(bigNums.begin(), bigNums.end()));
+#if 0
+    // one pattern reused across many short haystacks
+    tiny_stl::string logs;
+    while (logs.size() < (64u << 20)) {
+        logs += "2024-01-01 12:00:00 INFO request handled id=";
+        logs += tiny_stl::to_string(rand());
+        logs += " status=200 path=/api/v1/items\n";
+    }
+    const std::size_t kLine = 256;
+    const std::size_t kLines = logs.size() / kLine;
+    for (const char* needle :
+         {"status=503", "request handled id=12345 status=404 path=/api/v2/"}) {
+        const char* nFirst = needle;
+        const char* nLast = needle + std::strlen(needle);
+        tiny_stl::default_searcher<const char*> lds(nFirst, nLast);
+        tiny_stl::boyer_moore_horspool_searcher<const char*> lbmh(nFirst,
+                                                                  nLast);
+        tiny_stl::boyer_moore_searcher<const char*> lbm(nFirst, nLast);
+        std::size_t hits[3] = {};
+
+        auto begin1 = std::chrono::high_resolution_clock::now();
+        for (std::size_t i = 0; i < kLines; ++i) {
+            const char* line = logs.data() + i * kLine;
+            hits[0] += tiny_stl::search(line, line + kLine, lds) - line;
+        }
+        auto end1 = std::chrono::high_resolution_clock::now();
+        for (std::size_t i = 0; i < kLines; ++i) {
+            const char* line = logs.data() + i * kLine;
+            hits[1] += tiny_stl::search(line, line + kLine, lbmh) - line;
+        }
+        auto end2 = std::chrono::high_resolution_clock::now();
+        for (std::size_t i = 0; i < kLines; ++i) {
+            const char* line = logs.data() + i * kLine;
+            hits[2] += tiny_stl::search(line, line + kLine, lbm) - line;
+        }
+        auto end3 = std::chrono::high_resolution_clock::now();
+
+        std::cout << "pattern " << (nLast - nFirst) << " default_searcher: "
+                  << ((end1 - begin1).count() / 1000000.0)
+                  << "ms, horspool: " << ((end2 - end1).count() / 1000000.0)
+                  << "ms, boyer_moore: " << ((end3 - end2).count() / 1000000.0)
+                  << "ms" << std::endl;
+        UNIT_TEST(hits[0], hits[1]);
+        UNIT_TEST(hits[0], hits[2]);
+    }
+
+    const int kBenchSize = 10'000'000;
+    const char* benchNames[] = {"sorted", "reversed", "sawtooth",
+                                "random", "3 values", "equal"};
+    for (int k = 0; k < 6; ++k) {
+        tiny_stl::vector<int> bigNums(kBenchSize);
+        for (int i = 0; i < kBenchSize; ++i) {
+            bigNums[i] = k == 0   ? i
+                         : k == 1 ? kBenchSize - i
+                         : k == 2 ? i % 1000
+                         : k == 3 ? rand()
+                         : k == 4 ? rand() % 3
+                                  : 42;
+        }
+
+        auto stableNums = bigNums;
+        auto partialNums = bigNums;
+        auto nthNums = bigNums;
+
+        auto begin1 = std::chrono::high_resolution_clock::now();
+        tiny_stl::sort(bigNums.begin(), bigNums.end());
+        auto end1 = std::chrono::high_resolution_clock::now();
+        tiny_stl::stable_sort(stableNums.begin(), stableNums.end());
+        auto end2 = std::chrono::high_resolution_clock::now();
+        tiny_stl::partial_sort(partialNums.begin(), partialNums.begin() + 100,
+                               partialNums.end());
+        auto end3 = std::chrono::high_resolution_clock::now();
+        tiny_stl::nth_element(nthNums.begin(), nthNums.begin() + kBenchSize / 2,
+                              nthNums.end());
+        auto end4 = std::chrono::high_resolution_clock::now();
+
+        std::cout << benchNames[k] << " time: "
+                  << ((end1 - begin1).count() / 1000000.0) << "ms"
+                  << ", stable_sort: " << ((end2 - end1).count() / 1000000.0)
+                  << "ms, partial_sort top 100: "
+                  << ((end3 - end2).count() / 1000000.0)
+                  << "ms, nth_element: " << ((end4 - end3).count() / 1000000.0)
+                  << "ms" << std::endl;
+
+        UNIT_TEST(true, tiny_stl::is_sorted(bigNums.begin(), bigNums.end()));
+        UNIT_TEST(true,
+                  tiny_stl::is_sorted(stableNums.begin(), stableNums.end()));
+        UNIT_TEST(bigNums[kBenchSize / 2], nthNums[kBenchSize / 2]);
+    }
 #endif
 }
 
+void testExecution() {
+    using tiny_stl::execution::par;
+    using tiny_stl::execution::seq;
+
+    const int n = 1 << 18;
+    tiny_stl::vector<int> v(n);
+    tiny_stl::fill(par, v.begin(), v.end(), 1);
+    UNIT_TEST(n, tiny_stl::count_if(par, v.begin(), v.end(),
+                                    [](int x) { return x == 1; }));
+
+    for (int i = 0; i < n; ++i)
+        v[i] = (i * 7919) % n;
+    tiny_stl::vector<int> w(n);
+    tiny_stl::copy(par, v.begin(), v.end(), w.begin());
+    UNIT_TEST(true, tiny_stl::equal(par, v.begin(), v.end(), w.begin()));
+    w[n - 1] = -1;
+    UNIT_TEST(false, tiny_stl::equal(par, v.begin(), v.end(), w.begin()));
+
+    auto mm = tiny_stl::minmax_element(par, v.begin(), v.end());
+    UNIT_TEST(0, *mm.first);
+    UNIT_TEST(n - 1, *mm.second);
+
+    auto found = tiny_stl::find_if(par, v.begin(), v.end(),
+                                   [](int x) { return x > n - 10; });
+    UNIT_TEST(tiny_stl::find_if(v.begin(), v.end(),
+                                [](int x) { return x > n - 10; }) - v.begin(),
+              found - v.begin());
+    UNIT_TEST(true, tiny_stl::find_if(par, v.begin(), v.end(), [](int x) {
+                        return x < 0;
+                    }) == v.end());
+
+    tiny_stl::transform(par, v.begin(), v.end(), w.begin(),
+                        [](int x) { return x * 2; });
+    tiny_stl::transform(par, v.begin(), v.end(), w.begin(), w.begin(),
+                        [](int x, int y) { return y - x; });
+    UNIT_TEST(true, tiny_stl::equal(par, v.begin(), v.end(), w.begin()));
+
+    // the two inputs have different iterator types
+    tiny_stl::transform(par, v.data(), v.data() + n, w.begin(), w.begin(),
+                        [](int x, int y) { return x + y; });
+    UNIT_TEST(2 * v[n - 1], w[n - 1]);
+    tiny_stl::transform(seq, w.begin(), w.end(), v.data(), w.begin(),
+                        [](int x, int y) { return x - y; });
+    UNIT_TEST(true, tiny_stl::equal(par, v.begin(), v.end(), w.begin()));
+
+    std::atomic<long long> sum{0};
+    tiny_stl::for_each(par, v.begin(), v.end(), [&sum](int x) { sum += x; });
+    UNIT_TEST(static_cast<long long>(n) * (n - 1) / 2, sum.load());
+
+    tiny_stl::sort(par, v.begin(), v.end());
+    UNIT_TEST(true, tiny_stl::is_sorted(v.begin(), v.end()));
+    for (int i = 0; i < n; ++i)
+        w[i] = rand() % 16;
+    tiny_stl::sort(par, w.begin(), w.end(), tiny_stl::greater<>{});
+    UNIT_TEST(true,
+              tiny_stl::is_sorted(w.begin(), w.end(), tiny_stl::greater<>{}));
+
+    tiny_stl::vector<tiny_stl::string> vs(n / 4);
+    for (auto& s : vs)
+        s = tiny_stl::to_string(rand());
+    tiny_stl::sort(par, vs.begin(), vs.end());
+    UNIT_TEST(true, tiny_stl::is_sorted(vs.begin(), vs.end()));
+
+    // not random access, runs sequentially
+    tiny_stl::list<int> l(100, 3);
+    tiny_stl::fill(par, l.begin(), l.end(), 5);
+    UNIT_TEST(100, tiny_stl::count_if(seq, l.begin(), l.end(),
+                                      [](int x) { return x == 5; }));
+
+    bool thrown = false;
+    try {
+        tiny_stl::for_each(par, v.begin(), v.end(), [](int x) {
+            if (x == 12345)
+                throw x;
+        });
+    } catch (int x) {
+        thrown = x == 12345;
+    }
+    UNIT_TEST(true, thrown);
+}
+
 void testArray() {
     tiny_stl::array<std::int32_t, 10> arr;
     arr.assign(42);
@@ -404,6 +773,108 @@ void testVector() {
     UNIT_TEST(10, v16.size());
     UNIT_TEST(42, v16.front());
     UNIT_TEST(42, v16.back());
+
+    tiny_stl::vector<tiny_stl::string> v17 = {"a", "b", "c", "d"};
+    v17.reserve(10);
+    v17.insert(v17.begin() + 1, {"x", "y"});
+    v17.emplace(v17.begin(), "z");
+    v17.insert(v17.begin() + 2, 2, v17.back());
+    UNIT_TEST(9, v17.size());
+    UNIT_TEST(true, v17[0] == "z" && v17[1] == "a" && v17[2] == "d" &&
+                        v17[3] == "d" && v17[4] == "x" && v17[8] == "d");
+    v17.resize(12, "e");
+    UNIT_TEST(true, v17[8] == "d" && v17[11] == "e");
+    v17.resize(2);
+    UNIT_TEST(2, v17.size());
+    v17 = tiny_stl::vector<tiny_stl::string>(3, "f");
+    UNIT_TEST(true, v17[2] == "f");
+
+    // growth relocates with memcpy, owners must not be destroyed twice
+    UNIT_TEST(true, tiny_stl::is_trivially_relocatable_v<tiny_stl::string>);
+    UNIT_TEST(true,
+              tiny_stl::is_trivially_relocatable_v<tiny_stl::unique_ptr<int>>);
+    UNIT_TEST(true, (tiny_stl::is_trivially_relocatable_v<
+                        tiny_stl::pair<tiny_stl::vector<int>, int>>));
+    UNIT_TEST(false, (tiny_stl::is_trivially_relocatable_v<
+                         tiny_stl::small_vector<int, 2>>));
+    tiny_stl::vector<tiny_stl::unique_ptr<int>> v18;
+    tiny_stl::vector<tiny_stl::string> v19;
+    for (int i = 0; i < 100; ++i) {
+        v18.emplace_back(new int(i));
+        v19.emplace_back(i % 2 ? "short" : "a string longer than the buffer");
+    }
+    v18.emplace(v18.begin() + 1, new int(-1));
+    v19.insert(v19.begin() + 1, 100, "x");
+    UNIT_TEST(99, *v18.back());
+    UNIT_TEST(-1, *v18[1]);
+    UNIT_TEST(true, v19.back() == "short" && v19[100] == "x");
+    UNIT_TEST(200, v19.size());
+    v19.erase(v19.begin());
+    v19.erase(v19.begin() + 1, v19.begin() + 101);
+    UNIT_TEST(99, v19.size());
+    UNIT_TEST(true, v19[0] == "x" && v19[2] == "short");
+}
+
+void testSmallVector() {
+    tiny_stl::small_vector<int, 4> sv;
+    UNIT_TEST(4, sv.capacity());
+    const int* inlineData = sv.data();
+    sv = {1, 2, 3, 4};
+    UNIT_TEST(true, sv.data() == inlineData);
+    sv.push_back(5); // spill to the heap
+    UNIT_TEST(5, sv.size());
+    UNIT_TEST(8, sv.capacity());
+    UNIT_TEST(false, sv.data() == inlineData);
+    sv.erase(sv.begin(), sv.begin() + 3);
+    sv.shrink_to_fit();
+    UNIT_TEST(true, sv.data() == inlineData);
+    UNIT_TEST(4, sv[0]);
+    UNIT_TEST(5, sv[1]);
+
+    tiny_stl::small_vector<int, 4> sv2(sv);
+    UNIT_TEST(true, sv2 == sv);
+    tiny_stl::small_vector<int, 4> sv3(10, 7);
+    sv2.swap(sv3); // inline with heap
+    UNIT_TEST(10, sv2.size());
+    UNIT_TEST(2, sv3.size());
+    UNIT_TEST(5, sv3.back());
+    tiny_stl::small_vector<int, 4> sv4(tiny_stl::move(sv2));
+    UNIT_TEST(10, sv4.size());
+    UNIT_TEST(true, sv2.empty());
+    sv2 = tiny_stl::move(sv3); // inline elements are moved one by one
+    UNIT_TEST(2, sv2.size());
+    UNIT_TEST(true, sv3.empty());
+
+    // swap may move elements through a temporary, a throwing move leaks out
+    struct MayThrow {
+        MayThrow() = default;
+        MayThrow(MayThrow&&) noexcept(false) {
+        }
+        MayThrow& operator=(MayThrow&&) noexcept(false) {
+            return *this;
+        }
+    };
+    tiny_stl::small_vector<MayThrow, 2> mt1;
+    tiny_stl::small_vector<MayThrow, 2> mt2;
+    tiny_stl::vector<MayThrow> mt3;
+    tiny_stl::vector<MayThrow> mt4;
+    UNIT_TEST(true, noexcept(sv2.swap(sv3)));
+    UNIT_TEST(false, noexcept(mt1.swap(mt2)));
+    UNIT_TEST(true, noexcept(mt3.swap(mt4)));
+
+    using StrVec = tiny_stl::small_vector<tiny_stl::string, 2>;
+    StrVec ss = {"a"};
+    ss.insert(ss.begin(), "b");
+    UNIT_TEST(true, ss[0] == "b" && ss[1] == "a");
+    ss.insert(ss.begin() + 1, {"c", "d"});
+    UNIT_TEST(4, ss.size());
+    UNIT_TEST(true, ss[1] == "c" && ss[2] == "d" && ss[3] == "a");
+    ss.resize(1);
+    ss.shrink_to_fit();
+    StrVec ss2 = tiny_stl::move(ss);
+    UNIT_TEST(1, ss2.size());
+    UNIT_TEST(true, ss2[0] == "b");
+    UNIT_TEST(true, ss2 < StrVec{"c"});
 }
 
 void testList() {
@@ -783,6 +1254,63 @@ void testStringView() {
     UNIT_TEST(12, str5.rfind("xxx"));
     UNIT_TEST(12, str5.rfind("xxx", 12));
     UNIT_TEST(0, str5.rfind("xxx", 11));
+    UNIT_TEST(3, str5.find("", 3));
+    UNIT_TEST(tiny_stl::string_view::npos, str5.find("", 19));
+    UNIT_TEST(tiny_stl::string_view::npos, str5.find('x', 19));
+
+#ifdef TINY_STL_CXX14
+    constexpr tiny_stl::string_view cexpr("hello world", 11);
+    static_assert(cexpr.find('w') == 6, "");
+    static_assert(cexpr.find(tiny_stl::string_view("wor", 3)) == 6, "");
+    static_assert(cexpr.find('o', 5) == 7, "");
+    static_assert(cexpr.find('z') == tiny_stl::string_view::npos, "");
+    static_assert(cexpr.rfind('o') == 7, "");
+    static_assert(cexpr.rfind(tiny_stl::string_view("o", 1), 6) == 4, "");
+    static_assert(cexpr.rfind(tiny_stl::string_view("", 0), 3) == 3, "");
+#endif // TINY_STL_CXX14
+
+    // a long haystack, the view loops and the string SIMD search agree
+    tiny_stl::string log;
+    for (int i = 0; i < 200; ++i)
+        log += "GET /index.html 200 ";
+    log += "GET /index.html 404 ";
+    const tiny_stl::string_view logView{log.data(), log.size()};
+    UNIT_TEST(4016, logView.find("404"));
+    UNIT_TEST(4016, logView.rfind("404"));
+    UNIT_TEST(4011, logView.find("html 404"));
+    UNIT_TEST(tiny_stl::string_view::npos, logView.find("html 500"));
+    tiny_stl::string longNeedle;
+    for (int i = 0; i < 10; ++i)
+        longNeedle += "GET /index.html 200 ";
+    longNeedle += "GET /index.html 404";
+    UNIT_TEST(3800, logView.find(longNeedle.c_str()));
+    UNIT_TEST(3800, logView.rfind(longNeedle.c_str()));
+    longNeedle.back() = '5';
+    UNIT_TEST(tiny_stl::string_view::npos, logView.find(longNeedle.c_str()));
+    UNIT_TEST(3980, logView.rfind("GET /index.html 200 "));
+    UNIT_TEST(0, logView.rfind("GET", 0));
+    UNIT_TEST(4016, log.find("404"));
+    UNIT_TEST(4016, log.rfind("404"));
+    UNIT_TEST(tiny_stl::string::npos, log.find(longNeedle.c_str()));
+    UNIT_TEST(3980, log.rfind("GET /index.html 200 "));
+
+    // find_first_of family, small sets, large sets and the scalar tail
+    const tiny_stl::string_view csv =
+        "name,age,\"city, state\"\r\nbob,42,\"NY\"";
+    UNIT_TEST(4, csv.find_first_of(",\r\n\""));
+    UNIT_TEST(9, csv.find_first_of('"', 5));
+    UNIT_TEST(27, csv.find_last_of(",\r\n\"", 29));
+    UNIT_TEST(0, csv.find_first_not_of(",\r\n\""));
+    UNIT_TEST(csv.size() - 2, csv.find_last_not_of('"'));
+    UNIT_TEST(tiny_stl::string_view::npos, csv.find_first_of(""));
+    UNIT_TEST(3, csv.find_first_not_of("", 3));
+    UNIT_TEST(tiny_stl::string_view::npos, csv.find_first_of(',', 100));
+    const char* const letters = "abcdefghijklmnopqrstuvwxyz";
+    UNIT_TEST(5, logView.find_first_not_of("GET /"));
+    UNIT_TEST(4016, logView.find_first_of("0123456789", 4000));
+    UNIT_TEST(4018, logView.find_last_of("0123456789"));
+    UNIT_TEST(4019, logView.find_last_not_of(letters));
+    UNIT_TEST(4014, logView.find_last_not_of("4 0", 4018));
 
 #ifdef TINY_STL_CXX14
     using namespace tiny_stl::literals::string_view_literals;
@@ -884,6 +1412,13 @@ void testCowString() {
     UNIT_TEST(2, s12.rfind("is", 3));
     UNIT_TEST(10, s12.rfind('s'));
     UNIT_TEST(tiny_stl::cow_string::npos, s12.rfind("that"));
+    UNIT_TEST(0, s12.rfind("this", 0));
+    UNIT_TEST(3, s12.find("", 3));
+    UNIT_TEST(10, s12.find("string"));
+    UNIT_TEST(3, s12.find_first_of("sa"));
+    UNIT_TEST(4, s12.find_first_not_of("this"));
+    UNIT_TEST(15, s12.find_last_of("ing"));
+    UNIT_TEST(8, s12.find_last_not_of("string ", 12));
 
     //tiny_stl::cow_string s13 = "12345";
 
@@ -919,6 +1454,91 @@ void testCowString() {
     llx = LLONG_MIN;
     s16 = tiny_stl::to_cow_string(llx);
     UNIT_TEST(tiny_stl::cow_string{"-9223372036854775808"}, s16);
+
+    // one representation shared by worker threads, writes detach a copy
+    const tiny_stl::cow_string shared = "shared immutable config string";
+    tiny_stl::vector<std::thread> workers;
+    std::atomic<int> intact{0};
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&shared, &intact, t] {
+            bool ok = true;
+            for (int i = 0; i < 10000; ++i) {
+                tiny_stl::cow_string local = shared;
+                tiny_stl::cow_string other(local);
+                if (i % 100 == 0)
+                    other[0] = static_cast<char>('a' + t);
+                ok = ok && local.size() == 30 && local.c_front() == 's';
+            }
+            if (ok)
+                ++intact;
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    UNIT_TEST(4, intact.load());
+    UNIT_TEST(true, shared == "shared immutable config string");
+}
+
+void testRope() {
+    tiny_stl::crope r0;
+    UNIT_TEST(true, r0.empty());
+    UNIT_TEST(true, r0.chunk_begin() == r0.chunk_end());
+
+    tiny_stl::crope r1 = "hello world";
+    UNIT_TEST(11, r1.size());
+    UNIT_TEST('w', r1[6]);
+    UNIT_TEST('d', r1.back());
+
+    r1.insert(5, ",");
+    r1.append("!");
+    UNIT_TEST(tiny_stl::string{"hello, world!"}, r1.str());
+    r1.erase(0, 7);
+    UNIT_TEST(tiny_stl::string{"world!"}, r1.str());
+    r1.replace(0, 5, "there");
+    UNIT_TEST(tiny_stl::string{"there!"}, r1.str());
+    UNIT_TEST(tiny_stl::string{"her"}, r1.substr(1, 3).str());
+    UNIT_TEST(true, r1 == tiny_stl::crope("there!"));
+
+    // large ropes are split into chunks, edits leave the copies alone
+    tiny_stl::string big;
+    for (int i = 0; i < 10000; ++i)
+        big.push_back(static_cast<char>('a' + i % 26));
+    tiny_stl::crope r2 = big;
+    tiny_stl::crope r3 = r2;
+    r2.insert(5000, "XYZ");
+    r2.erase(100, 1000);
+    big.insert(5000, "XYZ");
+    big.erase(100, 1000);
+    UNIT_TEST(big, r2.str());
+    UNIT_TEST(10000, r3.size());
+    UNIT_TEST('a', r3[5000 - 5000 % 26]);
+
+    std::size_t chunks = 0;
+    std::size_t total = 0;
+    bool ordered = true;
+    for (auto iter = r2.chunk_begin(); iter != r2.chunk_end(); ++iter) {
+        ordered = ordered && iter.position() == total;
+        total += (*iter).size();
+        ++chunks;
+    }
+    UNIT_TEST(true, ordered);
+    UNIT_TEST(r2.size(), total);
+    UNIT_TEST(true, chunks > 1);
+
+    // the same chunks twice
+    tiny_stl::crope r4 = r3 + r3;
+    UNIT_TEST(20000, r4.size());
+    UNIT_TEST(true, r4.substr(10000) == r3);
+    UNIT_TEST(true, r4.substr(0, 10000) == r3);
+    UNIT_TEST(false, r4.substr(1, 10000) == r3);
+
+    bool thrown = false;
+    try {
+        r0.at(0);
+    } catch (const char*) {
+        thrown = true;
+    }
+    UNIT_TEST(true, thrown);
 }
 
 void testString() {
@@ -1044,6 +1664,24 @@ void testString() {
     UNIT_TEST(6, str15.find('s', 4));
     UNIT_TEST(13, str15.rfind('i'));
     UNIT_TEST(5, str15.rfind("is", 5));
+    UNIT_TEST(tiny_stl::string::npos, str15.rfind("is", 1));
+    UNIT_TEST(0, str15.rfind('T', 0));
+    UNIT_TEST(16, str15.find("", 16));
+    UNIT_TEST(tiny_stl::string::npos, str15.find("", 17));
+    UNIT_TEST(tiny_stl::string::npos, str15.find('s', 17));
+
+    tiny_stl::wstring wstr = L"wide string, wide chars";
+    UNIT_TEST(13, wstr.find(L"wide", 1));
+    UNIT_TEST(13, wstr.rfind(L"wide"));
+    UNIT_TEST(tiny_stl::wstring::npos, wstr.find(L"wider"));
+    UNIT_TEST(2, str15.find_first_of("is"));
+    UNIT_TEST(3, str15.find_first_of('s', 3));
+    UNIT_TEST(4, str15.find_first_not_of("This"));
+    UNIT_TEST(14, str15.find_last_of("ni"));
+    UNIT_TEST(8, str15.find_last_not_of("string "));
+    UNIT_TEST(tiny_stl::string::npos, str15.find_last_not_of(str15));
+    UNIT_TEST(4, wstr.find_first_of(L" ,"));
+    UNIT_TEST(21, wstr.find_last_not_of(L"s"));
 
     tiny_stl::string str16 = "1234555578";
     str16.replace(5, 3, "6");
@@ -1121,6 +1759,80 @@ void testSet() {
     }
     UNIT_TEST(true, tiny_stl::is_sorted(s1.begin(), s1.end()));
     UNIT_TEST(1000, s1.size());
+
+    // sorted input is built in O(n), the tree stays usable afterwards
+    tiny_stl::vector<int> sorted;
+    for (int i = 0; i < 1000; ++i)
+        sorted.push_back(i / 2);
+    tiny_stl::set<int> s2(sorted.begin(), sorted.end(), tiny_stl::less<int>());
+    UNIT_TEST(500, s2.size());
+    UNIT_TEST(499, *s2.rbegin());
+    tiny_stl::multiset<int> ms2(sorted.begin(), sorted.end(),
+                                tiny_stl::less<int>());
+    UNIT_TEST(1000, ms2.size());
+    for (int i = 0; i < 500; i += 2)
+        s2.erase(i);
+    s2.insert(-1);
+    s2.insert(1000);
+    UNIT_TEST(252, s2.size());
+    UNIT_TEST(-1, *s2.begin());
+    UNIT_TEST(true, tiny_stl::is_sorted(s2.begin(), s2.end()));
+
+    // a throwing compare leaves no value behind, not even the last one
+    struct Live {
+        int v;
+        int* live;
+        Live(int val, int* cnt) : v(val), live(cnt) {
+            ++*live;
+        }
+        Live(const Live& rhs) : v(rhs.v), live(rhs.live) {
+            ++*live;
+        }
+        ~Live() {
+            --*live;
+        }
+    };
+    struct ThrowLess {
+        int* calls;
+        bool operator()(const Live& lhs, const Live& rhs) const {
+            if (--*calls == 0)
+                throw 1;
+            return lhs.v < rhs.v;
+        }
+    };
+    int live = 0;
+    int calls = 50;
+    tiny_stl::vector<Live> lives;
+    for (int i = 0; i < 100; ++i)
+        lives.emplace_back(i, &live);
+    UNIT_TEST(100, live);
+    try {
+        tiny_stl::set<Live, ThrowLess> s4(lives.begin(), lives.end(),
+                                          ThrowLess{&calls});
+    } catch (int) {
+    }
+    UNIT_TEST(0, calls);
+    UNIT_TEST(100, live);
+
+    // the hint is used if the value goes right before or after it
+    tiny_stl::set<int> s3;
+    for (int i = 0; i < 100; ++i)
+        s3.insert(s3.end(), i);
+    UNIT_TEST(100, s3.size());
+    auto iter2 = s3.insert(s3.find(50), 50);
+    UNIT_TEST(50, *iter2);
+    UNIT_TEST(100, s3.size());
+    s3.emplace_hint(s3.begin(), 200); // a wrong hint still works
+    UNIT_TEST(200, *s3.rbegin());
+    UNIT_TEST(101, s3.size());
+
+    tiny_stl::multiset<int> ms3{1, 3, 3, 5};
+    ms3.insert_range(tiny_stl::vector<int>{4, 3, 0, 5});
+    UNIT_TEST(8, ms3.size());
+    UNIT_TEST(3, ms3.count(3));
+    UNIT_TEST(true, tiny_stl::is_sorted(ms3.begin(), ms3.end()));
+    ms3.emplace(6);
+    UNIT_TEST(6, *ms3.rbegin());
 }
 
 void testMap() {
@@ -1156,6 +1868,260 @@ void testMap() {
                                        {3, 3.3}, {0, 0.0}, {1, 1.1}};
 
     UNIT_TEST(7, mm.size());
+
+    // transparent lookup, no temporary string
+    tiny_stl::map<tiny_stl::string, int, tiny_stl::less<>> ms{
+        {"apple", 1}, {"banana", 2}, {"cherry", 3}};
+    UNIT_TEST(2, ms.find("banana")->second);
+    UNIT_TEST(1, ms.count("apple"));
+    UNIT_TEST(true, ms.contains("cherry"));
+    UNIT_TEST(false, ms.contains("durian"));
+    UNIT_TEST(1, ms.erase("apple"));
+    UNIT_TEST(0, ms.erase("apple"));
+    UNIT_TEST(2, ms.size());
+    ms.erase(ms.begin());
+    UNIT_TEST(1, ms.size());
+
+    // sorted input, the first one of the equivalent keys is kept
+    tiny_stl::vector<tiny_stl::pair<int, int>> sorted;
+    for (int i = 0; i < 100; ++i)
+        sorted.push_back(tiny_stl::make_pair(i / 2, i));
+    tiny_stl::map<int, int> m3(sorted.begin(), sorted.end());
+    UNIT_TEST(50, m3.size());
+    UNIT_TEST(20, m3.at(10));
+    m3.clear();
+    m3.insert(sorted.rbegin(), sorted.rend());
+    UNIT_TEST(50, m3.size());
+    UNIT_TEST(21, m3.at(10));
+
+    // a batch keeps the order of insertion of the equivalent keys
+    tiny_stl::multimap<int, int> mm2{{1, -1}, {2, -1}};
+    mm2.insert(sorted.begin(), sorted.begin() + 6);
+    UNIT_TEST(8, mm2.size());
+    auto range = mm2.equal_range(1);
+    UNIT_TEST(-1, range.first->second);
+    UNIT_TEST(3, (--range.second)->second);
+    auto iter = mm2.emplace_hint(mm2.lower_bound(2), 2, 9);
+    UNIT_TEST(true, iter == mm2.lower_bound(2));
+    UNIT_TEST(9, iter->second);
+
+    tiny_stl::map<int, int> m4;
+    m4.emplace(1, 2);
+    auto iter1 = m4.emplace_hint(m4.end(), 1, 5);
+    UNIT_TEST(2, iter1->second);
+    m4.insert(m4.end(), tiny_stl::make_pair(3, 4));
+    UNIT_TEST(2, m4.size());
+    UNIT_TEST(4, m4.at(3));
+}
+
+void testBTree() {
+    tiny_stl::btree_set<int> s = {5, 4, 3, 6, 7, 3, 5, 7, 8, 4, 6, 8};
+    s.insert(1);
+    UNIT_TEST(1, *s.begin());
+    UNIT_TEST(7, s.size());
+    UNIT_TEST(1, s.erase(8));
+    UNIT_TEST(7, *(--s.end()));
+    auto iter = s.erase(s.find(4));
+    UNIT_TEST(5, *iter);
+    UNIT_TEST(true, s.contains(3));
+    UNIT_TEST(false, s.contains(4));
+
+    // enough values to split the root several times
+    tiny_stl::btree_multiset<int> ms;
+    for (int i = 0; i < 10000; ++i)
+        ms.insert(rand() % 1000);
+    UNIT_TEST(true, tiny_stl::is_sorted(ms.begin(), ms.end()));
+    UNIT_TEST(10000, ms.size());
+    const auto cnt = ms.count(500);
+    UNIT_TEST(cnt, ms.erase(500));
+    UNIT_TEST(10000 - cnt, ms.size());
+    auto range = ms.equal_range(500);
+    UNIT_TEST(true, range.first == range.second);
+
+    // erase returns the successor while nodes are merged
+    tiny_stl::btree_set<int> s1;
+    for (int i = 0; i < 10000; ++i)
+        s1.insert(i);
+    auto iter1 = s1.begin();
+    while (iter1 != s1.end())
+        iter1 = s1.erase(iter1);
+    UNIT_TEST(true, s1.empty());
+    for (int i = 10000; i > 0; --i)
+        s1.insert(i);
+    iter1 = s1.erase(s1.lower_bound(100), s1.upper_bound(9900));
+    UNIT_TEST(9901, *iter1);
+    UNIT_TEST(199, s1.size());
+    UNIT_TEST(10000, *s1.rbegin());
+
+    tiny_stl::btree_map<int, double> m{{2, 2.2}, {3, 3.3}, {6, 6.6},
+                                       {4, 4.4}, {0, 0.0}, {1, 1.1}};
+    auto p = m.insert({5, 5.5});
+    UNIT_TEST(7, m.size());
+    UNIT_TEST(true, p.second);
+    p = m.insert({1, 3.4});
+    UNIT_TEST(false, p.second);
+    UNIT_TEST(3.3, m.at(3));
+    m[7] = 7.7;
+    UNIT_TEST(7.7, m[7]);
+    auto m1 = m;
+    UNIT_TEST(true, m1 == m);
+    auto m2 = tiny_stl::move(m1);
+    UNIT_TEST(8, m2.size());
+    UNIT_TEST(0, m1.size());
+
+    tiny_stl::btree_multimap<tiny_stl::string, int, tiny_stl::less<>> mm{
+        {"apple", 1}, {"banana", 2}, {"apple", 3}};
+    UNIT_TEST(2, mm.count("apple"));
+    UNIT_TEST(2, mm.find("banana")->second);
+    UNIT_TEST(2, mm.erase("apple"));
+    UNIT_TEST(1, mm.size());
+
+    // single values into the multi containers
+    auto iter2 = mm.insert({"banana", 4});
+    UNIT_TEST(4, iter2->second);
+    iter2 = mm.insert(tiny_stl::make_pair(tiny_stl::string("cherry"), 5));
+    UNIT_TEST(5, iter2->second);
+    iter2 = mm.emplace("banana", 6);
+    UNIT_TEST(6, iter2->second);
+    UNIT_TEST(3, mm.count("banana"));
+    UNIT_TEST(4, mm.size());
+
+    tiny_stl::btree_multiset<tiny_stl::pair<int, int>> ms1;
+    auto iter3 = ms1.emplace(1, 2);
+    UNIT_TEST(2, iter3->second);
+    ms1.emplace(1, 2);
+    ms1.insert(tiny_stl::make_pair(0, 1));
+    UNIT_TEST(3, ms1.size());
+    UNIT_TEST(2, ms1.count(tiny_stl::make_pair(1, 2)));
+    UNIT_TEST(0, ms1.begin()->first);
+}
+
+void testFlatSet() {
+    tiny_stl::flat_set<int> s = {5, 4, 3, 6, 7, 3, 5, 7, 8, 4, 6, 8};
+    s.insert(1);
+    UNIT_TEST(1, *s.begin());
+    UNIT_TEST(7, s.size());
+    UNIT_TEST(false, s.insert(5).second);
+    UNIT_TEST(1, s.erase(8));
+    UNIT_TEST(7, *(--s.end()));
+    auto iter = s.erase(s.find(4));
+    UNIT_TEST(5, *iter);
+    UNIT_TEST(true, s.contains(3));
+    UNIT_TEST(false, s.contains(4));
+
+    tiny_stl::flat_multiset<int> ms = {5, 4, 3, 6, 7, 3, 5, 7, 8, 4, 6, 8};
+    ms.insert(1);
+    UNIT_TEST(13, ms.size());
+    UNIT_TEST(2, ms.erase(8));
+    UNIT_TEST(2, ms.count(3));
+    UNIT_TEST(true, tiny_stl::is_sorted(ms.begin(), ms.end()));
+
+    // bulk construction sorts once
+    tiny_stl::vector<int> v;
+    for (int i = 0; i < 1000; ++i)
+        v.push_back(rand() % 100);
+    tiny_stl::set<int> ref(v.begin(), v.end(), tiny_stl::less<int>());
+    tiny_stl::flat_set<int> s1(tiny_stl::move(v));
+    UNIT_TEST(ref.size(), s1.size());
+    UNIT_TEST(true, tiny_stl::equal(s1.begin(), s1.end(), ref.begin()));
+
+    tiny_stl::flat_set<int> s2(tiny_stl::sorted_unique, {1, 3, 5});
+    UNIT_TEST(3, *s2.lower_bound(2));
+    UNIT_TEST(5, *s2.upper_bound(3));
+    UNIT_TEST(true, s2.upper_bound(5) == s2.end());
+}
+
+void testFlatMap() {
+    tiny_stl::flat_map<int, double> m{{2, 2.2}, {3, 3.3}, {6, 6.6},
+                                      {4, 4.4}, {3, 3.4}, {0, 0.0}};
+    UNIT_TEST(5, m.size());
+    UNIT_TEST(3.3, m.at(3));
+    auto p = m.insert({5, 5.5});
+    UNIT_TEST(true, p.second);
+    UNIT_TEST(5, p.first->first);
+    p = m.insert({1, 1.1});
+    UNIT_TEST(true, p.second);
+    p = m.insert({1, 3.4});
+    UNIT_TEST(false, p.second);
+    UNIT_TEST(1.1, p.first->second);
+    UNIT_TEST(0.0, m[7]);
+    m[7] = 7.7;
+    UNIT_TEST(7.7, m[7]);
+    UNIT_TEST(8, m.size());
+    UNIT_TEST(false, m.try_emplace(7, 0.0).second);
+    UNIT_TEST(true, tiny_stl::is_sorted(m.keys().begin(), m.keys().end()));
+
+    for (auto&& kv : m)
+        kv.second += 1.0;
+    UNIT_TEST(1.0, m.begin()->second);
+    UNIT_TEST(8.7, m.rbegin()->second);
+
+    auto iter = m.erase(m.find(3));
+    UNIT_TEST(4, iter->first);
+    UNIT_TEST(1, m.erase(4));
+    UNIT_TEST(6, m.size());
+
+    auto m1 = m;
+    UNIT_TEST(true, m1 == m);
+    auto m2 = tiny_stl::move(m1);
+    UNIT_TEST(6, m2.size());
+    UNIT_TEST(0, m1.size());
+
+    // the first one of the equivalent keys is kept
+    tiny_stl::vector<int> keys = {3, 1, 2, 1, 3};
+    tiny_stl::vector<char> values = {'a', 'b', 'c', 'd', 'e'};
+    tiny_stl::flat_map<int, char> m3(tiny_stl::move(keys),
+                                     tiny_stl::move(values));
+    UNIT_TEST(3, m3.size());
+    UNIT_TEST('b', m3.at(1));
+    UNIT_TEST('a', m3.at(3));
+
+    tiny_stl::flat_multimap<tiny_stl::string, int, tiny_stl::less<>> mm{
+        {"apple", 1}, {"banana", 2}, {"apple", 3}};
+    UNIT_TEST(2, mm.count("apple"));
+    UNIT_TEST(1, mm.find("apple")->second);
+    UNIT_TEST(3, (++mm.find("apple"))->second);
+    UNIT_TEST(2, mm.erase("apple"));
+    UNIT_TEST(1, mm.size());
+}
+
+void testOrderStatistic() {
+    tiny_stl::order_statistic_set<int> s{5, 1, 9, 3, 7, 3};
+    UNIT_TEST(5, s.size());
+    UNIT_TEST(1, *s.nth(0));
+    UNIT_TEST(5, *s.nth(2));
+    UNIT_TEST(9, *s.nth(4));
+    UNIT_TEST(true, s.nth(5) == s.end());
+    UNIT_TEST(0, s.rank(1));
+    UNIT_TEST(2, s.rank(5));
+    UNIT_TEST(3, s.rank(6));
+    UNIT_TEST(5, s.rank(100));
+
+    s.erase(3);
+    s.insert(4);
+    UNIT_TEST(4, *s.nth(1));
+    UNIT_TEST(2, s.rank(5));
+
+    // the sizes survive the rotations of many inserts and erases
+    tiny_stl::order_statistic_set<int> s1;
+    for (int i = 0; i < 1000; ++i)
+        s1.insert((i * 7919) % 1000);
+    for (int i = 0; i < 1000; i += 2)
+        s1.erase(i);
+    UNIT_TEST(500, s1.size());
+    UNIT_TEST(201, *s1.nth(100));
+    UNIT_TEST(100, s1.rank(201));
+    auto s2 = s1;
+    UNIT_TEST(999, *s2.nth(499));
+
+    tiny_stl::order_statistic_map<tiny_stl::string, int, tiny_stl::less<>> m{
+        {"cherry", 3}, {"apple", 1}, {"banana", 2}};
+    UNIT_TEST(2, m.nth(1)->second);
+    UNIT_TEST(2, m.rank("cherry"));
+    m["blueberry"] = 4;
+    UNIT_TEST(4, m.nth(2)->second);
+    UNIT_TEST(3, m.rank("cherry"));
+    UNIT_TEST(1, m.at("apple"));
 }
 
 void testTuple() {
@@ -1190,6 +2156,280 @@ void testTuple() {
     UNIT_TEST(3, tiny_stl::tuple_size<decltype(t)>::value);
 }
 
+void testPoolAllocator() {
+    tiny_stl::pool_allocator<int> a;
+    int* p1 = a.allocate(1);
+    *p1 = 1;
+    a.deallocate(p1, 1);
+    int* p2 = a.allocate(1);
+    UNIT_TEST(true, p1 == p2); // recycled
+    int* arr = a.allocate(100);
+    arr[99] = 99;
+    UNIT_TEST(99, arr[99]);
+    a.deallocate(arr, 100);
+    a.deallocate(p2, 1);
+    UNIT_TEST(true, a == tiny_stl::pool_allocator<double>{});
+
+    tiny_stl::map<int, int, tiny_stl::less<int>,
+                  tiny_stl::pool_allocator<tiny_stl::pair<int, int>>>
+        m;
+    tiny_stl::unordered_map<int, int, tiny_stl::hash<int>,
+                            tiny_stl::equal_to<int>,
+                            tiny_stl::pool_allocator<tiny_stl::pair<int, int>>>
+        um;
+    tiny_stl::list<int, tiny_stl::pool_allocator<int>> l;
+    tiny_stl::forward_list<int, tiny_stl::pool_allocator<int>> fl;
+    for (int i = 0; i < 1000; ++i) {
+        m[i] = i;
+        um[i] = i;
+        l.push_back(i);
+        fl.push_front(i);
+    }
+
+    for (int i = 0; i < 1000; i += 2) {
+        m.erase(i);
+        um.erase(i);
+    }
+    UNIT_TEST(500, m.size());
+    UNIT_TEST(500, um.size());
+    UNIT_TEST(999, m.rbegin()->second);
+    UNIT_TEST(0, um.count(998));
+    UNIT_TEST(999, um[999]);
+    UNIT_TEST(999, l.back());
+    UNIT_TEST(999, fl.front());
+
+    auto m2 = m;
+    m.clear();
+    UNIT_TEST(500, m2.size());
+    UNIT_TEST(1, m2.begin()->first);
+}
+
+// counts the bytes still held from upstream
+class CountingResource : public tiny_stl::pmr::memory_resource {
+public:
+    std::size_t inUse = 0;
+    std::size_t calls = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        inUse += bytes;
+        ++calls;
+        return tiny_stl::pmr::new_delete_resource()->allocate(bytes,
+                                                              alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes,
+                       std::size_t alignment) override {
+        inUse -= bytes;
+        tiny_stl::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const tiny_stl::pmr::memory_resource& rhs) const
+        noexcept override {
+        return this == &rhs;
+    }
+};
+
+void testMemoryResource() {
+    using tiny_stl::pmr::polymorphic_allocator;
+    using PmrString =
+        tiny_stl::basic_string<char, std::char_traits<char>,
+                               polymorphic_allocator<char>>;
+
+    CountingResource upstream;
+    {
+        alignas(std::max_align_t) char buf[256];
+        tiny_stl::pmr::monotonic_buffer_resource arena(buf, sizeof(buf),
+                                                       &upstream);
+        void* p1 = arena.allocate(10, 1);
+        void* p2 = arena.allocate(8, 8);
+        UNIT_TEST(true, p1 == buf);
+        UNIT_TEST(16, static_cast<char*>(p2) - buf);
+        UNIT_TEST(0, upstream.calls);
+
+        tiny_stl::vector<int, polymorphic_allocator<int>> v(&arena);
+        tiny_stl::map<int, int, tiny_stl::less<int>,
+                      polymorphic_allocator<tiny_stl::pair<int, int>>>
+            m(tiny_stl::less<int>{}, &arena);
+        tiny_stl::vector<PmrString, polymorphic_allocator<PmrString>> vs(
+            &arena);
+        for (int i = 0; i < 1000; ++i) {
+            v.push_back(i);
+            m[i] = i;
+            vs.emplace_back(40, 'a');
+        }
+        UNIT_TEST(999, v.back());
+        UNIT_TEST(999, m.rbegin()->second);
+        UNIT_TEST(true, vs.back().get_allocator().resource() == &arena);
+        UNIT_TEST(true, upstream.calls > 0);
+        UNIT_TEST(true, upstream.calls < 64); // geometric chunks
+
+        // a copy does not inherit the arena
+        auto v2 = v;
+        UNIT_TEST(true, v2.get_allocator().resource() ==
+                            tiny_stl::pmr::get_default_resource());
+        UNIT_TEST(1000, v2.size());
+
+        v.clear();
+        m.clear();
+        vs.clear();
+        arena.release();
+        UNIT_TEST(0, upstream.inUse);
+        UNIT_TEST(true, arena.allocate(10, 1) == buf);
+    }
+    UNIT_TEST(0, upstream.inUse);
+
+    // the buckets and the nodes stay in the arena across rehashes
+    {
+        tiny_stl::pmr::monotonic_buffer_resource arena(&upstream);
+        tiny_stl::unordered_map<
+            int, int, tiny_stl::hash<int>, tiny_stl::equal_to<int>,
+            polymorphic_allocator<tiny_stl::pair<int, int>>>
+            um(&arena);
+        const auto buckets = um.bucket_count();
+        for (int i = 0; i < 1000; ++i)
+            um[i] = i;
+        UNIT_TEST(true, um.bucket_count() > buckets);
+        UNIT_TEST(1000, um.size());
+        UNIT_TEST(999, um.at(999));
+        UNIT_TEST(true, um.get_allocator().resource() == &arena);
+    }
+    UNIT_TEST(0, upstream.inUse);
+
+    // a move between resources moves the elements, the arrays stay put
+    {
+        using PmrFlatMap = tiny_stl::flat_unordered_map<
+            int, int, tiny_stl::hash<int>, tiny_stl::equal_to<int>,
+            polymorphic_allocator<tiny_stl::pair<int, int>>>;
+        CountingResource other;
+        PmrFlatMap fm1(&upstream);
+        PmrFlatMap fm2(&other);
+        PmrFlatMap fm3(&other);
+        for (int i = 0; i < 100; ++i) {
+            fm1[i] = i;
+            fm2[-i] = i;
+        }
+        fm2 = tiny_stl::move(fm1);
+        UNIT_TEST(true, fm2.get_allocator().resource() == &other);
+        UNIT_TEST(100, fm2.size());
+        UNIT_TEST(99, fm2.at(99));
+        UNIT_TEST(true, fm1.empty());
+        UNIT_TEST(0, upstream.inUse);
+        const std::size_t calls = other.calls;
+        fm3 = tiny_stl::move(fm2); // same resource, the arrays are stolen
+        UNIT_TEST(calls, other.calls);
+        UNIT_TEST(100, fm3.size());
+        UNIT_TEST(true, fm2.empty());
+    }
+    UNIT_TEST(0, upstream.inUse);
+
+    {
+        tiny_stl::pmr::unsynchronized_pool_resource pool(&upstream);
+        void* p1 = pool.allocate(24, 8);
+        pool.deallocate(p1, 24, 8);
+        void* p2 = pool.allocate(32, 8);
+        UNIT_TEST(true, p1 == p2); // same 32 byte pool
+        void* big = pool.allocate(100000, 64);
+        UNIT_TEST(0, reinterpret_cast<std::uintptr_t>(big) % 64);
+        pool.deallocate(big, 100000, 64);
+        pool.deallocate(p2, 32, 8);
+
+        tiny_stl::list<int, polymorphic_allocator<int>> l(&pool);
+        for (int i = 0; i < 1000; ++i)
+            l.push_back(i);
+        const std::size_t calls = upstream.calls;
+        l.clear();
+        for (int i = 0; i < 1000; ++i)
+            l.push_back(i);
+        UNIT_TEST(calls, upstream.calls); // nodes are recycled
+
+        polymorphic_allocator<int> a1(&pool);
+        polymorphic_allocator<double> a2(&pool);
+        UNIT_TEST(true, a1 == a2);
+        UNIT_TEST(false, a1 == polymorphic_allocator<int>{});
+    }
+    UNIT_TEST(0, upstream.inUse);
+
+    polymorphic_allocator<int> none(tiny_stl::pmr::null_memory_resource());
+    bool thrown = false;
+    try {
+        none.allocate(1);
+    } catch (const std::bad_alloc&) {
+        thrown = true;
+    }
+    UNIT_TEST(true, thrown);
+}
+
+struct HashOnlyBytes {
+    explicit HashOnlyBytes(int v) : val(v) {
+    }
+    int val;
+};
+
+void testHash() {
+    tiny_stl::string s1(100, 'a');
+    tiny_stl::string s2(100, 'a');
+    tiny_stl::string_view sv(s1.c_str(), s1.size());
+    UNIT_TEST(tiny_stl::hash<tiny_stl::string>{}(s1),
+              tiny_stl::hash<tiny_stl::string>{}(s2));
+    UNIT_TEST(tiny_stl::hash<tiny_stl::string>{}(s1),
+              tiny_stl::hash<tiny_stl::string_view>{}(sv));
+
+    // every length takes a different tail path, all prefixes differ
+    tiny_stl::unordered_set<std::size_t> hs;
+    for (std::size_t i = 0; i <= s1.size(); ++i) {
+        s2 = s1.substr(0, i);
+        hs.insert(tiny_stl::hash<tiny_stl::string>{}(s2));
+    }
+    UNIT_TEST(101, hs.size());
+    s2 = s1;
+    s2[99] = 'b';
+    UNIT_TEST(false, tiny_stl::hash<tiny_stl::string>{}(s1) ==
+                         tiny_stl::hash<tiny_stl::string>{}(s2));
+
+    using FnvHash =
+        tiny_stl::hash<tiny_stl::string, tiny_stl::fnv1a_hash_policy>;
+    UNIT_TEST(tiny_stl::hashFNV(s1.c_str(), s1.size()), FnvHash{}(s1));
+#ifdef TINY_STL_HAS_CRC32
+    using CrcHash =
+        tiny_stl::hash<tiny_stl::string, tiny_stl::crc32_hash_policy>;
+    UNIT_TEST(CrcHash{}(s1), CrcHash{}(tiny_stl::string(100, 'a')));
+    UNIT_TEST(false, CrcHash{}(s1) == CrcHash{}(s2));
+#endif // TINY_STL_HAS_CRC32
+
+    // integers are mixed, consecutive keys differ in the high bits too
+    tiny_stl::hash<int> ih;
+    UNIT_TEST(ih(1), ih(1));
+    constexpr std::size_t half = sizeof(std::size_t) * CHAR_BIT / 2;
+    UNIT_TEST(false, (ih(1) >> half) == (ih(2) >> half));
+    int arr[2];
+    tiny_stl::hash<int*> ph;
+    UNIT_TEST(ph(arr), ph(&arr[0]));
+    UNIT_TEST(false, ph(arr) == ph(arr + 1));
+    UNIT_TEST(tiny_stl::hash<double>{}(0.0), tiny_stl::hash<double>{}(-0.0));
+
+    // the bytes of a type without a default constructor or operator==
+    tiny_stl::hash<HashOnlyBytes> bh;
+    UNIT_TEST(bh(HashOnlyBytes(7)), bh(HashOnlyBytes(7)));
+    UNIT_TEST(false, bh(HashOnlyBytes(7)) == bh(HashOnlyBytes(8)));
+}
+
+struct TransparentStringHash {
+    using is_transparent = int;
+
+    std::size_t operator()(tiny_stl::string_view sv) const noexcept {
+        return tiny_stl::hash<tiny_stl::string_view>{}(sv);
+    }
+
+    std::size_t operator()(const tiny_stl::string& s) const noexcept {
+        return (*this)(tiny_stl::string_view(s.c_str(), s.size()));
+    }
+
+    std::size_t operator()(const char* s) const noexcept {
+        return (*this)(tiny_stl::string_view(s));
+    }
+};
+
 void testUnorderSet() {
     tiny_stl::unordered_set<int> us = {1, 2, 3, 5, 5};
     UNIT_TEST(1, *us.find(1));
@@ -1248,6 +2488,41 @@ void testUnorderSet() {
 
     ums.swap(ums1);
     UNIT_TEST(1001, ums.size());
+
+    // default power2_bucket_policy
+    UNIT_TEST(0, ums.bucket_count() & (ums.bucket_count() - 1));
+    UNIT_TEST(true, ums.load_factor() <= ums.max_load_factor());
+
+    tiny_stl::unordered_set<int, tiny_stl::hash<int>, tiny_stl::equal_to<int>,
+                            tiny_stl::allocator<int>,
+                            tiny_stl::prime_bucket_policy>
+        us4;
+    UNIT_TEST(53, us4.bucket_count());
+    for (int i = 0; i < 1000; ++i)
+        us4.insert(i);
+    UNIT_TEST(1000, us4.size());
+    UNIT_TEST(1, us4.count(999));
+    UNIT_TEST(true, us4.bucket_count() % 2 == 1);
+}
+
+// erase while iterating, the returned iterator may be in a later bucket
+template <bool cacheHash>
+void testHashEraseLoop() {
+    tiny_stl::unordered_map<int, int, tiny_stl::hash<int>,
+                            tiny_stl::equal_to<int>,
+                            tiny_stl::allocator<tiny_stl::pair<int, int>>,
+                            tiny_stl::power2_bucket_policy, cacheHash>
+        um;
+    for (int i = 0; i < 1000; ++i)
+        um[i] = i;
+    for (auto it = um.begin(); it != um.end();)
+        it = it->first % 2 ? um.erase(it) : ++it;
+    UNIT_TEST(500, um.size());
+    int odd = 0;
+    for (auto& kv : um)
+        odd += kv.first % 2;
+    UNIT_TEST(0, odd);
+    UNIT_TEST(true, um.contains(998));
 }
 
 void testUnorderedMap() {
@@ -1285,28 +2560,212 @@ void testUnorderedMap() {
         {2, 2.2}, {3, 3.3}, {6, 6.6}, {4, 4.4}, {3, 3.3}, {0, 0.0}, {1, 1.1}};
 
     UNIT_TEST(7, umm.size());
+
+    tiny_stl::unordered_map<tiny_stl::string, int, TransparentStringHash,
+                            tiny_stl::equal_to<>>
+        ums{{"apple", 1}, {"banana", 2}, {"cherry", 3}};
+    UNIT_TEST(2, ums.find("banana")->second);
+    UNIT_TEST(1, ums.count("apple"));
+    UNIT_TEST(true, ums.contains("cherry"));
+    UNIT_TEST(false, ums.contains("durian"));
+    UNIT_TEST(1, ums.equal_range("apple").first->second);
+    UNIT_TEST(1, ums.erase("apple"));
+    UNIT_TEST(0, ums.erase("apple"));
+    UNIT_TEST(2, ums.size());
+
+    // cache hash mode
+    using StrHash = tiny_stl::hash<tiny_stl::string>;
+    using StrEqual = tiny_stl::equal_to<tiny_stl::string>;
+    tiny_stl::unordered_map<
+        tiny_stl::string, int, StrHash, StrEqual,
+        tiny_stl::allocator<tiny_stl::pair<tiny_stl::string, int>>,
+        tiny_stl::power2_bucket_policy, true>
+        umc;
+    umc.max_load_factor(0.5f);
+    for (int i = 0; i < 1000; ++i)
+        umc[tiny_stl::to_string(i)] = i;
+    UNIT_TEST(1000, umc.size());
+    UNIT_TEST(0.5f, umc.max_load_factor());
+    UNIT_TEST(999, umc.at("999"));
+    UNIT_TEST(0, umc.count("1000"));
+    UNIT_TEST(1, umc.erase("500"));
+    UNIT_TEST(false, umc.contains("500"));
+    std::size_t total = 0;
+    for (std::size_t n = 0; n < umc.bucket_count(); ++n) {
+        for (auto it = umc.begin(n); it != umc.end(n); ++it)
+            total += (umc.bucket(it->first) == n);
+    }
+    UNIT_TEST(999, total);
+
+    tiny_stl::unordered_multimap<
+        int, int, tiny_stl::hash<int>, tiny_stl::equal_to<int>,
+        tiny_stl::allocator<tiny_stl::pair<int, int>>,
+        tiny_stl::power2_bucket_policy, true>
+        ummc;
+    for (int i = 0; i < 300; ++i)
+        ummc.insert({i % 30, i});
+    ummc.rehash(1024);
+    UNIT_TEST(10, ummc.count(7));
+    auto range = ummc.equal_range(7);
+    UNIT_TEST(10, tiny_stl::distance(range.first, range.second));
+
+    testHashEraseLoop<false>();
+    testHashEraseLoop<true>();
+}
+
+void testFlatUnorderedSet() {
+    tiny_stl::flat_unordered_set<int> fs = {1, 2, 3, 5, 5};
+    UNIT_TEST(4, fs.size());
+    UNIT_TEST(1, *fs.find(1));
+    UNIT_TEST(5, *fs.find(5));
+    UNIT_TEST(true, fs.find(4) == fs.end());
+    auto range = fs.equal_range(5);
+    UNIT_TEST(5, *range.first);
+    UNIT_TEST(1, tiny_stl::distance(range.first, range.second));
+    UNIT_TEST(false, fs.insert(3).second);
+
+    UNIT_TEST(1, fs.erase(5));
+    UNIT_TEST(0, fs.erase(5));
+    UNIT_TEST(0, fs.count(5));
+    UNIT_TEST(3, fs.size());
+
+    tiny_stl::flat_unordered_set<int> fs1;
+    UNIT_TEST(true, fs1.begin() == fs1.end());
+    UNIT_TEST(0, fs1.count(42));
+    for (int i = 0; i < 1000; ++i)
+        fs1.insert(i);
+    UNIT_TEST(1000, fs1.size());
+    UNIT_TEST(true, fs1.load_factor() <= fs1.max_load_factor());
+    UNIT_TEST(1000, tiny_stl::distance(fs1.begin(), fs1.end()));
+
+    // erase half, the deleted slots are reused
+    for (int i = 0; i < 1000; i += 2)
+        fs1.erase(i);
+    UNIT_TEST(500, fs1.size());
+    UNIT_TEST(0, fs1.count(10));
+    UNIT_TEST(1, fs1.count(11));
+    for (int i = 0; i < 1000; i += 2)
+        fs1.insert(i);
+    UNIT_TEST(1000, fs1.size());
+    UNIT_TEST(1, fs1.count(10));
+
+    auto fs2(fs1);
+    UNIT_TEST(true, fs1 == fs2);
+    fs2.erase(fs2.find(0));
+    UNIT_TEST(false, fs1 == fs2);
+
+    auto fs3 = tiny_stl::move(fs2);
+    UNIT_TEST(999, fs3.size());
+    UNIT_TEST(0, fs2.size());
+
+    fs.swap(fs3);
+    UNIT_TEST(999, fs.size());
+    UNIT_TEST(1, fs.count(999));
+
+    fs.clear();
+    UNIT_TEST(true, fs.empty());
+    UNIT_TEST(true, fs.begin() == fs.end());
+
+    tiny_stl::flat_unordered_set<tiny_stl::string> fs4 = {"abc", "def"};
+    fs4.emplace("ghi");
+    UNIT_TEST(3, fs4.size());
+    UNIT_TEST(1, fs4.count("def"));
+    fs4.rehash(128);
+    UNIT_TEST(128, fs4.bucket_count());
+    UNIT_TEST(1, fs4.count("ghi"));
+}
+
+void testFlatUnorderedMap() {
+    tiny_stl::flat_unordered_map<int, double> fm{
+        {2, 2.2}, {3, 3.3}, {6, 6.6}, {4, 4.4}, {3, 3.3}, {0, 0.0}, {1, 1.1}};
+    auto p = fm.insert({5, 5.5});
+    UNIT_TEST(7, fm.size());
+    UNIT_TEST(true, p.second);
+    p = fm.insert({1, 3.4});
+    UNIT_TEST(7, fm.size());
+    UNIT_TEST(false, p.second);
+    UNIT_TEST(1.1, p.first->second);
+    auto iter = fm.find(0);
+    UNIT_TEST(0, iter->first);
+    UNIT_TEST(3.3, fm.at(3));
+
+    UNIT_TEST(0.0, fm[7]);
+    UNIT_TEST(8, fm.size());
+    fm[7] = 7.7;
+    UNIT_TEST(7.7, fm[7]);
+
+    auto fm1 = fm;
+    UNIT_TEST(8, fm1.size());
+    UNIT_TEST(true, fm1 == fm);
+
+    auto fm2 = tiny_stl::move(fm1);
+    UNIT_TEST(8, fm2.size());
+    UNIT_TEST(0, fm1.size());
+
+    tiny_stl::flat_unordered_map<tiny_stl::string, int> fm3;
+    fm3.reserve(100);
+    const auto buckets = fm3.bucket_count();
+    for (int i = 0; i < 100; ++i)
+        fm3[tiny_stl::to_string(i)] = i;
+    UNIT_TEST(buckets, fm3.bucket_count());
+    UNIT_TEST(100, fm3.size());
+    UNIT_TEST(42, fm3["42"]);
+
+    int sum = 0;
+    for (const auto& kv : fm3)
+        sum += kv.second;
+    UNIT_TEST(4950, sum);
+
+    auto first = fm3.begin();
+    while (first != fm3.end())
+        first = fm3.erase(first);
+    UNIT_TEST(true, fm3.empty());
+
+    tiny_stl::flat_unordered_map<tiny_stl::string, int, TransparentStringHash,
+                                 tiny_stl::equal_to<>>
+        fms{{"apple", 1}, {"banana", 2}, {"cherry", 3}};
+    UNIT_TEST(2, fms.find("banana")->second);
+    UNIT_TEST(1, fms.count("apple"));
+    UNIT_TEST(true, fms.contains("cherry"));
+    UNIT_TEST(false, fms.contains("durian"));
+    UNIT_TEST(1, fms.equal_range("apple").first->second);
+    UNIT_TEST(1, fms.erase("apple"));
+    UNIT_TEST(0, fms.erase("apple"));
+    UNIT_TEST(2, fms.size());
 }
 
 void testAll() {
     testUtility();
     testTypeTraits();
     testAlgorithm();
+    testExecution();
     testArray();
     testMemory();
     testVector();
+    testSmallVector();
     testList();
     testForwardList();
     testDeque();
     testAdaptor();
     testCowString();
+    testRope();
     testString();
     testStringView();
     testRBTree();
     testSet();
     testMap();
+    testBTree();
+    testFlatSet();
+    testFlatMap();
+    testOrderStatistic();
     testTuple();
+    testPoolAllocator();
+    testMemoryResource();
+    testHash();
     testUnorderSet();
     testUnorderedMap();
+    testFlatUnorderedSet();
+    testFlatUnorderedMap();
 }
 
 int main() {
@@ -473,7 +473,7 @@ template <typename T, bool = is_integral<T>::value>
 struct SignBase {
     using U = remove_cv_t<T>;
     using Signed = bool_constant<U(-1) < U(0)>;
-    using Unsiged = bool_constant<U(0) < U(-1)>;
+    using Unsigned = bool_constant<U(0) < U(-1)>;
 };
 
 template <typename T>
@@ -483,7 +483,7 @@ struct SignBase<T, false> {
 };
 
 template <typename T>
-struct is_signed : SignBase<T>::SignBase {};
+struct is_signed : SignBase<T>::Signed {};
 
 template <typename T>
 constexpr bool is_signed_v = is_signed<T>::value;
@@ -705,6 +705,18 @@ template <typename T>
 constexpr bool is_trivially_destructible_v =
     is_trivially_destructible<T>::value;
 
+// an object of T can be moved to new storage with memcpy, the old bytes
+// are then dropped without running the destructor. Class types that keep
+// no pointer to themselves (e.g. containers with a heap sentinel)
+// specialize it
+template <typename T>
+struct is_trivially_relocatable
+    : bool_constant<std::is_trivially_move_constructible<T>::value &&
+                    std::is_trivially_destructible<T>::value> {};
+
+template <typename T>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
 template <typename T, typename... Args>
 struct is_nothrow_constructible
     : bool_constant<std::is_nothrow_constructible<T, Args...>::value> {};
@@ -940,4 +952,27 @@ constexpr bool is_nothrow_swappable_with_v =
 template <typename T>
 constexpr bool is_nothrow_swappable_v = is_nothrow_swappable<T>::value;
 
+template <typename T>
+struct less;
+
+template <typename T>
+struct greater;
+
+// Cmp on T compiles to a compare and a setcc, so sort can use the result
+// as an index and partition without a branch
+template <typename T, typename Cmp>
+struct IsBranchlessCompare : false_type {};
+
+template <typename T>
+struct IsBranchlessCompare<T, less<T>> : is_arithmetic<T> {};
+
+template <typename T>
+struct IsBranchlessCompare<T, less<void>> : is_arithmetic<T> {};
+
+template <typename T>
+struct IsBranchlessCompare<T, greater<T>> : is_arithmetic<T> {};
+
+template <typename T>
+struct IsBranchlessCompare<T, greater<void>> : is_arithmetic<T> {};
+
 } // namespace tiny_stl
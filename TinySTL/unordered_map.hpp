@@ -10,13 +10,16 @@ namespace tiny_stl {
 
 template <typename Key, typename T, typename Hash = hash<Key>,
           typename KeyEqual = equal_to<Key>,
-          typename Alloc = allocator<pair<Key, T>>>
+          typename Alloc = allocator<pair<Key, T>>,
+          typename BucketPolicy = power2_bucket_policy, bool cacheHash = false>
 class unordered_map
-    : public HashTable<pair<Key, T>, Hash, KeyEqual, Alloc, true> {
+    : public HashTable<pair<Key, T>, Hash, KeyEqual, Alloc, true,
+                       BucketPolicy, cacheHash> {
 public:
     using allocator_type = Alloc;
 private:
-    using Base = HashTable<pair<Key, T>, Hash, KeyEqual, Alloc, true>;
+    using Base = HashTable<pair<Key, T>, Hash, KeyEqual, Alloc, true,
+                           BucketPolicy, cacheHash>;
     using AlTraits = allocator_traits<allocator_type>;
 public:
     using key_type = Key;
@@ -151,7 +154,7 @@ public:
     T& operator[](const key_type& key) {
         iterator pos = this->find(key);
         if (pos == this->end())
-            return this->insert(make_pair(key, T{})).first->second;
+            return this->insert(tiny_stl::make_pair(key, T{})).first->second;
 
         return pos->second;
     }
@@ -159,7 +162,7 @@ public:
     T& operator[](key_type&& key) {
         iterator pos = this->find(key);
         if (pos == this->end())
-            return this->insert(make_pair(tiny_stl::move(key), T{}))
+            return this->insert(tiny_stl::make_pair(tiny_stl::move(key), T{}))
                 .first->second;
 
         return pos->second;
@@ -169,6 +172,12 @@ public:
         return this->count_unique(key);
     }
 
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    size_type count(const K& key) const {
+        return this->count_unique(key);
+    }
+
     pair<iterator, bool> insert(const value_type& val) {
         return this->insert_unique(val);
     }
@@ -197,21 +206,26 @@ public:
 }; // unordered_map
 
 template <typename Key, typename T, typename Hash, typename KeyEqual,
-          typename Alloc>
-void swap(unordered_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
-          unordered_map<Key, T, Hash, KeyEqual, Alloc>& rhs) {
+          typename Alloc, typename BucketPolicy, bool cacheHash>
+void swap(unordered_map<Key, T, Hash, KeyEqual, Alloc, BucketPolicy,
+                        cacheHash>& lhs,
+          unordered_map<Key, T, Hash, KeyEqual, Alloc, BucketPolicy,
+                        cacheHash>& rhs) {
     lhs.swap(rhs);
 }
 
 template <typename Key, typename T, typename Hash = hash<Key>,
           typename KeyEqual = equal_to<Key>,
-          typename Alloc = allocator<pair<Key, T>>>
+          typename Alloc = allocator<pair<Key, T>>,
+          typename BucketPolicy = power2_bucket_policy, bool cacheHash = false>
 class unordered_multimap
-    : public HashTable<pair<Key, T>, Hash, KeyEqual, Alloc, true> {
+    : public HashTable<pair<Key, T>, Hash, KeyEqual, Alloc, true,
+                       BucketPolicy, cacheHash> {
 public:
     using allocator_type = Alloc;
 private:
-    using Base = HashTable<pair<Key, T>, Hash, KeyEqual, Alloc, true>;
+    using Base = HashTable<pair<Key, T>, Hash, KeyEqual, Alloc, true,
+                           BucketPolicy, cacheHash>;
     using AlTraits = allocator_traits<allocator_type>;
 
 public:
@@ -338,11 +352,17 @@ public:
         return this->count_equal(key);
     }
 
-    pair<iterator, bool> insert(const value_type& val) {
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    size_type count(const K& key) const {
+        return this->count_equal(key);
+    }
+
+    iterator insert(const value_type& val) {
         return this->insert_equal(val);
     }
 
-    pair<iterator, bool> insert(value_type&& val) {
+    iterator insert(value_type&& val) {
         return this->insert_equal(tiny_stl::move(val));
     }
 
@@ -356,7 +376,7 @@ public:
     }
 
     template <typename... Args>
-    pair<iterator, bool> emplace(Args&&... args) {
+    iterator emplace(Args&&... args) {
         return this->emplace_equal(tiny_stl::forward<Args>(args)...);
     }
 
@@ -365,10 +385,212 @@ public:
     }
 }; // unordered_multimap
 
+template <typename Key, typename T, typename Hash, typename KeyEqual,
+          typename Alloc, typename BucketPolicy, bool cacheHash>
+void swap(unordered_multimap<Key, T, Hash, KeyEqual, Alloc, BucketPolicy,
+                             cacheHash>& lhs,
+          unordered_multimap<Key, T, Hash, KeyEqual, Alloc, BucketPolicy,
+                             cacheHash>& rhs) {
+    lhs.swap(rhs);
+}
+
+// open addressing unordered_map, see FlatHashTable
+// same interface as unordered_map except the bucket interface,
+// iterators are invalidated by rehash
+template <typename Key, typename T, typename Hash = hash<Key>,
+          typename KeyEqual = equal_to<Key>,
+          typename Alloc = allocator<pair<Key, T>>>
+class flat_unordered_map
+    : public FlatHashTable<pair<Key, T>, Hash, KeyEqual, Alloc, true> {
+public:
+    using allocator_type = Alloc;
+private:
+    using Base = FlatHashTable<pair<Key, T>, Hash, KeyEqual, Alloc, true>;
+    using AlTraits = allocator_traits<allocator_type>;
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = pair<const Key, T>;
+    using size_type = typename Alloc::size_type;
+    using difference_type = typename Alloc::difference_type;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename AlTraits::pointer;
+    using const_pointer = typename AlTraits::const_pointer;
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+
+public:
+    // (1)
+    flat_unordered_map() : flat_unordered_map(0) {
+    }
+    explicit flat_unordered_map(size_type num_bucket,
+                                const Hash& hashfunc = Hash(),
+                                const KeyEqual& eq = KeyEqual(),
+                                const Alloc& alloc = Alloc())
+        : Base(num_bucket, alloc, hashfunc, eq) {
+    }
+
+    // (1)
+    flat_unordered_map(size_type num_bucket, const Alloc& alloc)
+        : flat_unordered_map(num_bucket, Hash(), KeyEqual(), alloc) {
+    }
+
+    // (1)
+    flat_unordered_map(size_type num_bucket, const Hash& hashfunc,
+                       const Alloc& alloc)
+        : flat_unordered_map(num_bucket, hashfunc, KeyEqual(), alloc) {
+    }
+
+    // (1)
+    explicit flat_unordered_map(const Alloc& alloc) : Base(0, alloc) {
+    }
+
+    // (2)
+    template <typename InIter>
+    flat_unordered_map(InIter first, InIter last, size_type num_bucket = 0,
+                       const Hash& hashfunc = Hash(),
+                       const KeyEqual& eq = KeyEqual(),
+                       const Alloc& alloc = Alloc())
+        : Base(num_bucket, alloc, hashfunc, eq) {
+        this->insert_unique(first, last);
+    }
+
+    // (2)
+    template <typename InIter>
+    flat_unordered_map(InIter first, InIter last, size_type num_bucket,
+                       const Alloc& alloc)
+        : flat_unordered_map(first, last, num_bucket, Hash(), KeyEqual(),
+                             alloc) {
+    }
+
+    // (2)
+    template <typename InIter>
+    flat_unordered_map(InIter first, InIter last, size_type num_bucket,
+                       const Hash& hashfunc, const Alloc& alloc)
+        : flat_unordered_map(first, last, num_bucket, hashfunc, KeyEqual(),
+                             alloc) {
+    }
+
+    // (3)
+    flat_unordered_map(const flat_unordered_map& rhs) : Base(rhs) {
+    }
+
+    // (3)
+    flat_unordered_map(const flat_unordered_map& rhs, const Alloc& alloc)
+        : Base(rhs, alloc) {
+    }
+
+    // (4)
+    flat_unordered_map(flat_unordered_map&& rhs) noexcept
+        : Base(tiny_stl::move(rhs)) {
+    }
+
+    // (5)
+    flat_unordered_map(std::initializer_list<value_type> ilist,
+                       size_type num_bucket = 0, const Hash& hashfunc = Hash(),
+                       const KeyEqual& eq = KeyEqual(),
+                       const Alloc& alloc = Alloc())
+        : flat_unordered_map(ilist.begin(), ilist.end(), num_bucket, hashfunc,
+                             eq, alloc) {
+    }
+
+    // (5)
+    flat_unordered_map(std::initializer_list<value_type> ilist,
+                       size_type num_bucket, const Alloc& alloc)
+        : flat_unordered_map(ilist, num_bucket, Hash(), KeyEqual(), alloc) {
+    }
+
+    // (5)
+    flat_unordered_map(std::initializer_list<value_type> ilist,
+                       size_type num_bucket, const Hash& hashfunc,
+                       const Alloc& alloc)
+        : flat_unordered_map(ilist, num_bucket, hashfunc, KeyEqual(), alloc) {
+    }
+
+    flat_unordered_map& operator=(const flat_unordered_map& rhs) {
+        Base::operator=(rhs);
+        return *this;
+    }
+
+    flat_unordered_map& operator=(flat_unordered_map&& rhs) {
+        Base::operator=(tiny_stl::move(rhs));
+        return *this;
+    }
+
+    flat_unordered_map& operator=(std::initializer_list<value_type> ilist) {
+        this->clear();
+        this->insert(ilist);
+        return *this;
+    }
+
+    mapped_type& at(const key_type& key) {
+        iterator pos = this->find(key);
+        if (pos == this->end())
+            throw "flat_unordered_map: out of range";
+
+        return pos->second;
+    }
+
+    const mapped_type& at(const key_type& key) const {
+        const_iterator pos = this->find(key);
+        if (pos == this->end())
+            throw "flat_unordered_map: out of range";
+
+        return pos->second;
+    }
+
+    T& operator[](const key_type& key) {
+        return this->findOrEmplaceKey(key)->second;
+    }
+
+    T& operator[](key_type&& key) {
+        return this->findOrEmplaceKey(tiny_stl::move(key))->second;
+    }
+
+    size_type count(const key_type& key) const {
+        return this->count_unique(key);
+    }
+
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    size_type count(const K& key) const {
+        return this->count_unique(key);
+    }
+
+    pair<iterator, bool> insert(const value_type& val) {
+        return this->insert_unique(val);
+    }
+
+    pair<iterator, bool> insert(value_type&& val) {
+        return this->insert_unique(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert(InIter first, InIter last) {
+        this->insert_unique(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        this->insert_unique(ilist.begin(), ilist.end());
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+        return this->emplace_unique(tiny_stl::forward<Args>(args)...);
+    }
+
+    void swap(flat_unordered_map& rhs) {
+        Base::swap(rhs);
+    }
+}; // flat_unordered_map
+
 template <typename Key, typename T, typename Hash, typename KeyEqual,
           typename Alloc>
-void swap(unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& lhs,
-          unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& rhs) {
+void swap(flat_unordered_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+          flat_unordered_map<Key, T, Hash, KeyEqual, Alloc>& rhs) {
     lhs.swap(rhs);
 }
 
@@ -9,12 +9,16 @@
 namespace tiny_stl {
 
 template <typename Key, typename Hash = hash<Key>,
-          typename KeyEqual = equal_to<Key>, typename Alloc = allocator<Key>>
-class unordered_set : public HashTable<Key, Hash, KeyEqual, Alloc, false> {
+          typename KeyEqual = equal_to<Key>, typename Alloc = allocator<Key>,
+          typename BucketPolicy = power2_bucket_policy, bool cacheHash = false>
+class unordered_set
+    : public HashTable<Key, Hash, KeyEqual, Alloc, false, BucketPolicy,
+                       cacheHash> {
 public:
     using allocator_type = Alloc;
 private:
-    using Base = HashTable<Key, Hash, KeyEqual, Alloc, false>;
+    using Base = HashTable<Key, Hash, KeyEqual, Alloc, false, BucketPolicy,
+                           cacheHash>;
     using AlTraits = allocator_traits<allocator_type>;
 
 public:
@@ -134,6 +138,12 @@ public:
         return this->count_unique(key);
     }
 
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    size_type count(const K& key) const {
+        return this->count_unique(key);
+    }
+
     pair<iterator, bool> insert(const value_type& val) {
         return this->insert_unique(val);
     }
@@ -161,19 +171,25 @@ public:
     }
 }; // unordered_set
 
-template <typename Key, typename Hash, typename KeyEqual, typename Alloc>
-void swap(unordered_set<Key, Hash, KeyEqual, Alloc>& lhs,
-          unordered_set<Key, Hash, KeyEqual, Alloc>& rhs) {
+template <typename Key, typename Hash, typename KeyEqual, typename Alloc,
+          typename BucketPolicy, bool cacheHash>
+void swap(
+    unordered_set<Key, Hash, KeyEqual, Alloc, BucketPolicy, cacheHash>& lhs,
+    unordered_set<Key, Hash, KeyEqual, Alloc, BucketPolicy, cacheHash>& rhs) {
     lhs.swap(rhs);
 }
 
 template <typename Key, typename Hash = hash<Key>,
-          typename KeyEqual = equal_to<Key>, typename Alloc = allocator<Key>>
-class unordered_multiset : public HashTable<Key, Hash, KeyEqual, Alloc, false> {
+          typename KeyEqual = equal_to<Key>, typename Alloc = allocator<Key>,
+          typename BucketPolicy = power2_bucket_policy, bool cacheHash = false>
+class unordered_multiset
+    : public HashTable<Key, Hash, KeyEqual, Alloc, false, BucketPolicy,
+                       cacheHash> {
 public:
     using allocator_type = Alloc;
 private:
-    using Base = HashTable<Key, Hash, KeyEqual, Alloc, false>;
+    using Base = HashTable<Key, Hash, KeyEqual, Alloc, false, BucketPolicy,
+                           cacheHash>;
     using AlTraits = allocator_traits<allocator_type>;
 
 public:
@@ -299,6 +315,12 @@ public:
         return this->count_equal(key);
     }
 
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    size_type count(const K& key) const {
+        return this->count_equal(key);
+    }
+
     iterator insert(const value_type& val) {
         return this->insert_equal(val);
     }
@@ -326,9 +348,186 @@ public:
     }
 }; // unordered_multiset
 
+template <typename Key, typename Hash, typename KeyEqual, typename Alloc,
+          typename BucketPolicy, bool cacheHash>
+void swap(unordered_multiset<Key, Hash, KeyEqual, Alloc, BucketPolicy,
+                             cacheHash>& lhs,
+          unordered_multiset<Key, Hash, KeyEqual, Alloc, BucketPolicy,
+                             cacheHash>& rhs) {
+    lhs.swap(rhs);
+}
+
+// open addressing unordered_set, see FlatHashTable
+// same interface as unordered_set except the bucket interface,
+// iterators are invalidated by rehash
+template <typename Key, typename Hash = hash<Key>,
+          typename KeyEqual = equal_to<Key>, typename Alloc = allocator<Key>>
+class flat_unordered_set
+    : public FlatHashTable<Key, Hash, KeyEqual, Alloc, false> {
+public:
+    using allocator_type = Alloc;
+private:
+    using Base = FlatHashTable<Key, Hash, KeyEqual, Alloc, false>;
+    using AlTraits = allocator_traits<allocator_type>;
+
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = typename Alloc::size_type;
+    using difference_type = typename Alloc::difference_type;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename AlTraits::pointer;
+    using const_pointer = typename AlTraits::const_pointer;
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+
+public:
+    // (1)
+    flat_unordered_set() : flat_unordered_set(0) {
+    }
+    explicit flat_unordered_set(size_type num_bucket,
+                                const Hash& hashfunc = Hash(),
+                                const KeyEqual& eq = KeyEqual(),
+                                const Alloc& alloc = Alloc())
+        : Base(num_bucket, alloc, hashfunc, eq) {
+    }
+
+    // (1)
+    flat_unordered_set(size_type num_bucket, const Alloc& alloc)
+        : flat_unordered_set(num_bucket, Hash(), KeyEqual(), alloc) {
+    }
+
+    // (1)
+    flat_unordered_set(size_type num_bucket, const Hash& hashfunc,
+                       const Alloc& alloc)
+        : flat_unordered_set(num_bucket, hashfunc, KeyEqual(), alloc) {
+    }
+
+    // (1)
+    explicit flat_unordered_set(const Alloc& alloc) : Base(0, alloc) {
+    }
+
+    // (2)
+    template <typename InIter>
+    flat_unordered_set(InIter first, InIter last, size_type num_bucket = 0,
+                       const Hash& hashfunc = Hash(),
+                       const KeyEqual& eq = KeyEqual(),
+                       const Alloc& alloc = Alloc())
+        : Base(num_bucket, alloc, hashfunc, eq) {
+        this->insert_unique(first, last);
+    }
+
+    // (2)
+    template <typename InIter>
+    flat_unordered_set(InIter first, InIter last, size_type num_bucket,
+                       const Alloc& alloc)
+        : flat_unordered_set(first, last, num_bucket, Hash(), KeyEqual(),
+                             alloc) {
+    }
+
+    // (2)
+    template <typename InIter>
+    flat_unordered_set(InIter first, InIter last, size_type num_bucket,
+                       const Hash& hashfunc, const Alloc& alloc)
+        : flat_unordered_set(first, last, num_bucket, hashfunc, KeyEqual(),
+                             alloc) {
+    }
+
+    // (3)
+    flat_unordered_set(const flat_unordered_set& rhs) : Base(rhs) {
+    }
+
+    // (3)
+    flat_unordered_set(const flat_unordered_set& rhs, const Alloc& alloc)
+        : Base(rhs, alloc) {
+    }
+
+    // (4)
+    flat_unordered_set(flat_unordered_set&& rhs) noexcept
+        : Base(tiny_stl::move(rhs)) {
+    }
+
+    // (5)
+    flat_unordered_set(std::initializer_list<value_type> ilist,
+                       size_type num_bucket = 0, const Hash& hashfunc = Hash(),
+                       const KeyEqual& eq = KeyEqual(),
+                       const Alloc& alloc = Alloc())
+        : flat_unordered_set(ilist.begin(), ilist.end(), num_bucket, hashfunc,
+                             eq, alloc) {
+    }
+
+    // (5)
+    flat_unordered_set(std::initializer_list<value_type> ilist,
+                       size_type num_bucket, const Alloc& alloc)
+        : flat_unordered_set(ilist, num_bucket, Hash(), KeyEqual(), alloc) {
+    }
+
+    // (5)
+    flat_unordered_set(std::initializer_list<value_type> ilist,
+                       size_type num_bucket, const Hash& hashfunc,
+                       const Alloc& alloc)
+        : flat_unordered_set(ilist, num_bucket, hashfunc, KeyEqual(), alloc) {
+    }
+
+    flat_unordered_set& operator=(const flat_unordered_set& rhs) {
+        Base::operator=(rhs);
+        return *this;
+    }
+
+    flat_unordered_set& operator=(flat_unordered_set&& rhs) {
+        Base::operator=(tiny_stl::move(rhs));
+        return *this;
+    }
+
+    flat_unordered_set& operator=(std::initializer_list<value_type> ilist) {
+        this->clear();
+        this->insert(ilist);
+        return *this;
+    }
+
+    size_type count(const key_type& key) const {
+        return this->count_unique(key);
+    }
+
+    template <typename K,
+              typename = details::EnableIfTransparentHash<Hash, KeyEqual, K>>
+    size_type count(const K& key) const {
+        return this->count_unique(key);
+    }
+
+    pair<iterator, bool> insert(const value_type& val) {
+        return this->insert_unique(val);
+    }
+
+    pair<iterator, bool> insert(value_type&& val) {
+        return this->insert_unique(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void insert(InIter first, InIter last) {
+        this->insert_unique(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        this->insert_unique(ilist.begin(), ilist.end());
+    }
+
+    template <typename... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+        return this->emplace_unique(tiny_stl::forward<Args>(args)...);
+    }
+
+    void swap(flat_unordered_set& rhs) {
+        Base::swap(rhs);
+    }
+}; // flat_unordered_set
+
 template <typename Key, typename Hash, typename KeyEqual, typename Alloc>
-void swap(unordered_multiset<Key, Hash, KeyEqual, Alloc>& lhs,
-          unordered_multiset<Key, Hash, KeyEqual, Alloc>& rhs) {
+void swap(flat_unordered_set<Key, Hash, KeyEqual, Alloc>& lhs,
+          flat_unordered_set<Key, Hash, KeyEqual, Alloc>& rhs) {
     lhs.swap(rhs);
 }
 
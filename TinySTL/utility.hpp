@@ -52,9 +52,12 @@ inline void swap(T& lhs, T& rhs) noexcept(
     rhs = tiny_stl::move(tmp);
 }
 
+template <typename T>
+inline void swapADL(T& lhs, T& rhs) noexcept(is_nothrow_swappable<T>::value);
+
 template <typename FwdIter1, typename FwdIter2>
 inline void iter_swap(FwdIter1 lhs, FwdIter2 rhs) {
-    swap(*lhs, *rhs);
+    tiny_stl::swapADL(*lhs, *rhs);
 }
 
 // swap array lhs and rhs
@@ -72,14 +75,39 @@ inline void swap(T (&lhs)[N],
     }
 }
 
+namespace details {
+namespace adl {
+
+// poison pill, only swaps found by ADL are visible
+void swap() = delete;
+
+template <typename T, typename = void>
+struct HasUniqueADLSwap : false_type {};
+
+// ambiguous when ADL finds both tiny_stl::swap and std::swap, e.g. a
+// tiny_stl type with std::char_traits in its template arguments
+template <typename T>
+struct HasUniqueADLSwap<T, void_t<decltype(swap(tiny_stl::declval<T&>(),
+                                                tiny_stl::declval<T&>()))>>
+    : true_type {};
+
+template <typename T>
+inline void swapAux(T& lhs, T& rhs, true_type) {
+    swap(lhs, rhs);
+}
+
+template <typename T>
+inline void swapAux(T& lhs, T& rhs, false_type) {
+    tiny_stl::swap(lhs, rhs);
+}
+
+} // namespace adl
+} // namespace details
+
 template <typename T>
 inline void swapADL(T& lhs, T& rhs) noexcept(is_nothrow_swappable<T>::value) {
     // ADL: argument-dependent lookup
-    swap(lhs, rhs);
-    // std::swap(a, b);
-    // maybe =>
-    // using std::swap;
-    // swap(a, b);
+    details::adl::swapAux(lhs, rhs, details::adl::HasUniqueADLSwap<T>{});
 }
 
 struct piecewise_construct_t {
@@ -243,6 +271,11 @@ struct pair {
     }
 }; // class pair<T1, T2>
 
+template <typename T1, typename T2>
+struct is_trivially_relocatable<pair<T1, T2>>
+    : bool_constant<is_trivially_relocatable<T1>::value &&
+                    is_trivially_relocatable<T2>::value> {};
+
 // if reference_wrap<T> -> T&
 // else                 -> decay_t<T>
 
@@ -198,7 +198,9 @@ operator+(typename VectorIterator<T>::difference_type offset,
     return iter += offset;
 }
 
-template <typename T, typename Alloc>
+// storage of small_vector, the first N elements live in an inline buffer
+// and only a larger capacity is allocated
+template <typename T, typename Alloc, std::size_t N = 0>
 class VectorBase {
 public:
     using value_type = T;
@@ -214,6 +216,86 @@ public:
     using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>;
     using allocator_type = Alloc;
 
+    static constexpr std::size_t inlineCapacity = N;
+
+protected:
+    allocator_type alloc;
+
+    T* first;
+    T* last;
+    T* end_of_storage;
+
+private:
+    alignas(T) unsigned char buffer[sizeof(T) * N];
+
+public:
+    VectorBase(const Alloc& a) : alloc(a) {
+        resetStorage();
+    }
+
+    VectorBase(const VectorBase&) = delete;
+    VectorBase& operator=(const VectorBase&) = delete;
+
+    T* inlineData() noexcept {
+        return reinterpret_cast<T*>(buffer);
+    }
+
+    const T* inlineData() const noexcept {
+        return reinterpret_cast<const T*>(buffer);
+    }
+
+    bool isInline() const noexcept {
+        return first == inlineData();
+    }
+
+    // empty, the inline buffer is the capacity
+    void resetStorage() noexcept {
+        first = inlineData();
+        last = first;
+        end_of_storage = first + N;
+    }
+
+    T* allocateAux(std::size_t n) {
+        return alloc.allocate(n);
+    }
+
+    void deallocateAux(T* p, std::size_t n) {
+        if (p != inlineData())
+            alloc.deallocate(p, n);
+    }
+
+    allocator_type& getAllocator() noexcept {
+        return alloc;
+    }
+
+    const allocator_type& getAllocator() const noexcept {
+        return alloc;
+    }
+
+    ~VectorBase() {
+        deallocateAux(first, end_of_storage - first);
+    }
+}; // class VectorBase<T, Alloc, N>
+
+// storage of vector, always on the heap
+template <typename T, typename Alloc>
+class VectorBase<T, Alloc, 0> {
+public:
+    using value_type = T;
+    using size_type = typename Alloc::size_type;
+    using difference_type = typename Alloc::difference_type;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = VectorIterator<T>;
+    using const_iterator = VectorConstIterator<T>;
+    using reverse_iterator = tiny_stl::reverse_iterator<iterator>;
+    using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>;
+    using allocator_type = Alloc;
+
+    static constexpr std::size_t inlineCapacity = 0;
+
 protected:
     allocator_type alloc;
 
@@ -225,6 +307,23 @@ public:
     VectorBase(const Alloc& a) : alloc(a), first(), last(), end_of_storage() {
     }
 
+    VectorBase(const VectorBase&) = delete;
+    VectorBase& operator=(const VectorBase&) = delete;
+
+    T* inlineData() noexcept {
+        return nullptr;
+    }
+
+    bool isInline() const noexcept {
+        return false;
+    }
+
+    void resetStorage() noexcept {
+        first = pointer();
+        last = pointer();
+        end_of_storage = pointer();
+    }
+
     T* allocateAux(std::size_t n) {
         return alloc.allocate(n);
     }
@@ -245,16 +344,23 @@ public:
     ~VectorBase() {
         deallocateAux(first, end_of_storage - first);
     }
-}; // class VectorBase<T, Alloc>
+}; // class VectorBase<T, Alloc, 0>
 
-template <typename T, typename Alloc = allocator<T>>
-class vector : public VectorBase<T, Alloc> {
+template <typename T, typename Alloc, std::size_t N>
+constexpr std::size_t VectorBase<T, Alloc, N>::inlineCapacity;
+
+template <typename T, typename Alloc>
+constexpr std::size_t VectorBase<T, Alloc, 0>::inlineCapacity;
+
+// the body of vector and small_vector, N is the inline capacity
+template <typename T, typename Alloc, std::size_t N>
+class VectorImpl : public VectorBase<T, Alloc, N> {
 public:
     static_assert(tiny_stl::is_same_v<T, typename Alloc::value_type>,
                   "Alloc::value_type is not the same as T");
 
 private:
-    using Base = VectorBase<T, Alloc>;
+    using Base = VectorBase<T, Alloc, N>;
 
 public:
     using allocator_type = typename Base::allocator_type;
@@ -278,13 +384,14 @@ private:
 private:
     // only allocate
     bool allocAux(size_type newCapacity) {
-        this->first = pointer();
-        this->last = pointer();
-        this->end_of_storage = pointer();
+        this->resetStorage();
 
         if (newCapacity == 0)
             return false;
 
+        if (newCapacity <= capacity()) // fits in the inline buffer
+            return true;
+
         if (newCapacity >= max_size())
             xLength();
 
@@ -316,7 +423,13 @@ private:
         uninitializedAllocCopy(xfirst, xlast, newFirst, this->alloc);
     }
 
+    // to new storage, updatePointer() drops the old elements
     void moveOrCopy(pointer xfirst, pointer xlast, pointer newFirst) {
+        if (UseRelocate<Alloc>::value) { // memcpy can not throw
+            uninitializedRelocate(xfirst, xlast, newFirst);
+            return;
+        }
+
         moveOrCopyAux(xfirst, xlast, newFirst,
                       typename tiny_stl::disjunction<
                           is_nothrow_move_constructible<T>,
@@ -327,6 +440,20 @@ private:
         return uninitializedAllocMove(xfirst, xlast, newFirst, this->alloc);
     }
 
+    // like moveAux, but the source is dropped by dropRelocated() instead of
+    // being destroyed or assigned to
+    pointer relocateAux(pointer xfirst, pointer xlast, pointer newFirst) {
+        if (UseRelocate<Alloc>::value)
+            return uninitializedRelocate(xfirst, xlast, newFirst);
+
+        return moveAux(xfirst, xlast, newFirst);
+    }
+
+    void dropRelocated(pointer xfirst, pointer xlast) {
+        if (!UseRelocate<Alloc>::value)
+            destroyAllocRange(xfirst, xlast, this->alloc);
+    }
+
     template <typename Iter> // ? Iter
     pointer copyAux(Iter xfirst, Iter xlast, pointer newFirst) {
         return uninitializedAllocCopy(xfirst, xlast, newFirst, this->alloc);
@@ -336,23 +463,20 @@ private:
     void tidy() {
         if (this->first != pointer()) {
             destroyAllocRange(this->first, this->last, this->alloc);
-            this->alloc.deallocate(this->first, capacity());
-
-            this->first = pointer();
-            this->last = pointer();
-            this->end_of_storage = pointer();
+            this->deallocateAux(this->first, capacity());
+            this->resetStorage();
         }
     }
 
 public:
     // (1)
-    vector() noexcept(noexcept(Alloc())) : vector(Alloc()) {
+    VectorImpl() noexcept(noexcept(Alloc())) : VectorImpl(Alloc()) {
     }
-    explicit vector(const Alloc& alloc) noexcept : Base(alloc) {
+    explicit VectorImpl(const Alloc& alloc) noexcept : Base(alloc) {
     }
 
     // (2)
-    vector(size_type count, const T& val, const Alloc& alloc = Alloc())
+    VectorImpl(size_type count, const T& val, const Alloc& alloc = Alloc())
         : Base(alloc) {
         try {
             if (allocAux(count))
@@ -364,7 +488,7 @@ public:
     }
 
     // (3)
-    explicit vector(size_type count, const Alloc& alloc = Alloc())
+    explicit VectorImpl(size_type count, const Alloc& alloc = Alloc())
         : Base(alloc) {
         try {
             if (allocAux(count))
@@ -405,14 +529,14 @@ public:
     // (4)
     template <typename InIter,
               typename = enable_if_t<is_iterator<InIter>::value>>
-    vector(InIter xfirst, InIter xlast, const Alloc& alloc = Alloc())
+    VectorImpl(InIter xfirst, InIter xlast, const Alloc& alloc = Alloc())
         : Base(alloc) {
         rangeConstruct(xfirst, xlast,
                        typename iterator_traits<InIter>::iterator_category{});
     }
 
     // (5)
-    vector(const vector& rhs)
+    VectorImpl(const VectorImpl& rhs)
         : Base(allocator_traits<Alloc>::select_on_container_copy_construction(
               rhs.alloc)) {
         try {
@@ -425,7 +549,7 @@ public:
     }
 
     // (5) alloc
-    vector(const vector& rhs, const Alloc& alloc) : Base(alloc) {
+    VectorImpl(const VectorImpl& rhs, const Alloc& alloc) : Base(alloc) {
         try {
             if (allocAux(rhs.size()))
                 this->last = copyAux(rhs.first, rhs.last, this->first);
@@ -436,17 +560,24 @@ public:
     }
 
 private:
-    void constructMove(vector&& rhs, true_type) noexcept {
+    // *this is empty and owns no heap memory
+    void constructMove(VectorImpl&& rhs, true_type) noexcept(
+        N == 0 || is_nothrow_move_constructible<T>::value) {
+        if (rhs.isInline()) { // the inline elements can only be moved
+            this->last = relocateAux(rhs.first, rhs.last, this->first);
+            rhs.dropRelocated(rhs.first, rhs.last);
+            rhs.last = rhs.first;
+            return;
+        }
+
         this->first = rhs.first;
         this->last = rhs.last;
         this->end_of_storage = rhs.end_of_storage;
 
-        rhs.first = pointer();
-        rhs.last = pointer();
-        rhs.end_of_storage = pointer();
+        rhs.resetStorage();
     }
 
-    void constructMove(vector&& rhs, false_type) {
+    void constructMove(VectorImpl&& rhs, false_type) {
         if (this->alloc == rhs.alloc)
             constructMove(tiny_stl::move(rhs), true_type{});
         else if (allocAux(rhs.size()))
@@ -455,25 +586,27 @@ private:
 
 public:
     // (6)
-    vector(vector&& rhs) noexcept : Base(tiny_stl::move(rhs.alloc)) {
+    VectorImpl(VectorImpl&& rhs) noexcept(
+        N == 0 || is_nothrow_move_constructible<T>::value)
+        : Base(tiny_stl::move(rhs.alloc)) {
         constructMove(tiny_stl::move(rhs), true_type{});
     }
 
     // (7)
-    vector(vector&& rhs, const Alloc& alloc) : Base(alloc) {
+    VectorImpl(VectorImpl&& rhs, const Alloc& alloc) : Base(alloc) {
         // FIXME, no strong exception
-        constructMove(rhs.first, rhs.last,
+        constructMove(tiny_stl::move(rhs),
                       typename allocator_traits<Alloc>::is_always_equal{});
     }
 
     // (8)
-    vector(std::initializer_list<T> ilist, const Alloc& alloc = Alloc())
+    VectorImpl(std::initializer_list<T> ilist, const Alloc& alloc = Alloc())
         : Base(alloc) {
         rangeConstruct(ilist.begin(), ilist.end(),
                        random_access_iterator_tag{});
     }
 
-    ~vector() {
+    ~VectorImpl() {
         tidy();
     }
 
@@ -517,13 +650,16 @@ private:
         }
     }
 
-    void assignMove(vector&& rhs, true_type) noexcept {
+    void assignMove(VectorImpl&& rhs, true_type) {
+        tidy();
         constructMove(tiny_stl::move(rhs), true_type{});
     }
 
-    void assignMove(vector&& rhs, false_type) {
-        if (this->alloc == rhs.alloc)
-            constructMove(tiny_stl::move(rhs), true_type{});
+    void assignMove(VectorImpl&& rhs, false_type) {
+        if (this->alloc == rhs.alloc) {
+            assignMove(tiny_stl::move(rhs), true_type{});
+            return;
+        }
 
         // Move individually
         const size_type newSize = rhs.size();
@@ -585,7 +721,7 @@ public:
                         random_access_iterator_tag{});
     }
 
-    vector& operator=(const vector& rhs) {
+    VectorImpl& operator=(const VectorImpl& rhs) {
         assert(this != tiny_stl::addressof(rhs));
 
         if (this->alloc != rhs.alloc)
@@ -599,7 +735,7 @@ public:
         return *this;
     }
 
-    vector& operator=(vector&& rhs) noexcept(
+    VectorImpl& operator=(VectorImpl&& rhs) noexcept(
         allocator_traits<
             Alloc>::propagate_on_container_move_assignment::value ||
         allocator_traits<Alloc>::is_always_equal::value) {
@@ -618,7 +754,7 @@ public:
         return *this;
     }
 
-    vector& operator=(std::initializer_list<T> ilist) {
+    VectorImpl& operator=(std::initializer_list<T> ilist) {
         assignCopyRange(ilist.begin(), ilist.end(),
                         random_access_iterator_tag{});
         return *this;
@@ -732,8 +868,8 @@ private:
     void updatePointer(const pointer newFirst, size_type newSize,
                        size_type newCapacity) {
         if (this->first != pointer()) {
-            destroyAllocRange(this->first, this->last, this->alloc);
-            this->alloc.deallocate(this->first, capacity());
+            dropRelocated(this->first, this->last);
+            this->deallocateAux(this->first, capacity());
         }
 
         this->first = newFirst;
@@ -743,7 +879,12 @@ private:
 
     void reallocAndInit(size_type newCapacity) {
         const size_type newSize = size();
-        const pointer newFirst = this->alloc.allocate(newCapacity);
+        // shrinking a heap small_vector moves the elements back inline
+        const bool toInline = newCapacity <= Base::inlineCapacity;
+        const pointer newFirst = toInline ? this->inlineData()
+                                          : this->allocateAux(newCapacity);
+        if (toInline)
+            newCapacity = Base::inlineCapacity;
 
         try {
             moveOrCopy(this->first, this->last, newFirst);
@@ -796,7 +937,7 @@ public:
     }
 
     void shrink_to_fit() {
-        if (size() < capacity()) {
+        if (size() < capacity() && !this->isInline()) {
             if (empty())
                 tidy(); // no destroy, only deallocate
             else
@@ -827,7 +968,7 @@ public:
             const size_type newCapacity = capacityGrowth(newSize);
 
             try {
-                const pointer newFirst = this->alloc.allocate(newCapacity);
+                const pointer newFirst = this->allocateAux(newCapacity);
 
                 allocator_traits<Alloc>::construct(
                     this->alloc, tiny_stl::addressof(*(newFirst + oldSize)),
@@ -866,7 +1007,7 @@ public:
             const size_type newCapacity = capacityGrowth(newSize);
 
             try {
-                const pointer newFirst = this->alloc.allocate(newCapacity);
+                const pointer newFirst = this->allocateAux(newCapacity);
 
                 // construct
                 allocator_traits<Alloc>::construct(
@@ -876,8 +1017,8 @@ public:
                 if (is_back) { // Strong exception guarantee
                     moveOrCopy(this->first, this->last, newFirst);
                 } else {
-                    moveAux(this->first, pos.ptr, newFirst);
-                    moveAux(pos.ptr, this->last, newFirst + offset + 1);
+                    relocateAux(this->first, pos.ptr, newFirst);
+                    relocateAux(pos.ptr, this->last, newFirst + offset + 1);
                 }
 
                 updatePointer(newFirst, newSize, newCapacity);
@@ -891,13 +1032,15 @@ public:
                 tiny_stl::forward<Args>(args)...);
             ++this->last;
         } else { // no reallocate, move old elements
-            pointer oldLast = this->last;
-            for (; pos.ptr != oldLast; --oldLast)
-                *oldLast = tiny_stl::move(oldLast[-1]);
-
+            // args may refer to an element, build the value first
             T obj(tiny_stl::forward<Args>(args)...);
+            const pointer oldLast = this->last;
+            allocator_traits<Alloc>::construct(
+                this->alloc, tiny_stl::addressof(*oldLast),
+                tiny_stl::move(oldLast[-1]));
             ++this->last;
-            *oldLast = tiny_stl::move(obj);
+            tiny_stl::move_backward(pos.ptr, oldLast - 1, oldLast);
+            *pos.ptr = tiny_stl::move(obj);
         }
         return begin() + offset;
     }
@@ -930,10 +1073,10 @@ public:
             const size_type newCapacity = capacityGrowth(newSize);
 
             try {
-                const pointer newFirst = this->alloc.allocate(newCapacity);
+                const pointer newFirst = this->allocateAux(newCapacity);
                 fillHelper(newFirst + offset, n, val);
-                moveAux(this->first, pos.ptr, newFirst);
-                moveAux(pos.ptr, this->last, newFirst + offset + n);
+                relocateAux(this->first, pos.ptr, newFirst);
+                relocateAux(pos.ptr, this->last, newFirst + offset + n);
                 updatePointer(newFirst, newSize, newCapacity);
             } catch (...) {
                 tidy();
@@ -948,15 +1091,12 @@ public:
                     this->last = fillHelper(oldLast, n - number_move, val);
                     this->last =
                         moveAux(pos.ptr, pos.ptr + number_move, this->last);
-                    fill(pos.ptr, oldLast, val);
+                    tiny_stl::fill(pos.ptr, oldLast, val);
                 } else { // move backward
-                    this->last = oldLast + n;
-                    pointer p = const_cast<pointer>(oldLast + (n - 1));
-                    for (size_type i = 0; i < number_move; ++i, --p)
-                        *p =
-                            tiny_stl::move(p[-static_cast<difference_type>(n)]);
-
-                    fill(pos.ptr, p, val);
+                    const T copy = val; // val may be an element
+                    this->last = moveAux(oldLast - n, oldLast, oldLast);
+                    tiny_stl::move_backward(pos.ptr, oldLast - n, oldLast);
+                    tiny_stl::fill(pos.ptr, pos.ptr + n, copy);
                 }
             } catch (...) {
                 tidy();
@@ -993,8 +1133,10 @@ private:
             static_cast<size_type>(tiny_stl::distance(xfirst, xlast));
         const size_type offset = pos.ptr - this->first;
 
-        if (n == 1 && pos.ptr == this->last)
+        if (n == 1 && pos.ptr == this->last) {
             emplace(pos.ptr, *xfirst);
+            return;
+        }
 
         if (n == 0) {
             // do nothing
@@ -1009,11 +1151,11 @@ private:
             const size_type newCapacity = capacityGrowth(newSize);
 
             try {
-                const pointer newFirst = this->alloc.allocate(newCapacity);
+                const pointer newFirst = this->allocateAux(newCapacity);
 
                 copyAux(xfirst, xlast, newFirst + offset);
-                moveAux(this->first, pos.ptr, newFirst);
-                moveAux(pos.ptr, this->last, newFirst + offset + n);
+                relocateAux(this->first, pos.ptr, newFirst);
+                relocateAux(pos.ptr, this->last, newFirst + offset + n);
 
                 updatePointer(newFirst, newSize, newCapacity);
             } catch (...) {
@@ -1023,30 +1165,23 @@ private:
         } else { // no reallocate
             const pointer oldLast = this->last;
             const size_type number_move = oldLast - pos.ptr;
-            if (n >= number_move) { // no move backward
-                const pointer newPos = this->first + (offset + n);
-                this->last = moveAux(pos.ptr, oldLast, newPos);
-
-                try {
-                    copyAux(xfirst, xlast, pos.ptr);
-                } catch (...) {
-                    // FIXME, move rollback
-                    tidy();
-                    throw;
-                }
-            } else { // move backward
-                this->last = oldLast + n;
-                pointer p = const_cast<pointer>(oldLast + (n - 1));
-                for (size_type i = 0; i < number_move; ++i, --p)
-                    *p = tiny_stl::move(p[-static_cast<difference_type>(n)]);
-
-                try {
-                    copyAux(xfirst, xlast, pos.ptr);
-                } catch (...) {
-                    // FIXME, move rollback
-                    tidy();
-                    throw;
+            try {
+                if (n >= number_move) { // no move backward
+                    // the tail of the range goes to raw memory
+                    FwdIter mid = xfirst;
+                    tiny_stl::advance(mid, number_move);
+                    this->last = copyAux(mid, xlast, oldLast);
+                    this->last = moveAux(pos.ptr, oldLast, this->last);
+                    tiny_stl::copy(xfirst, mid, pos.ptr);
+                } else { // move backward
+                    this->last = moveAux(oldLast - n, oldLast, oldLast);
+                    tiny_stl::move_backward(pos.ptr, oldLast - n, oldLast);
+                    tiny_stl::copy(xfirst, xlast, pos.ptr);
                 }
+            } catch (...) {
+                // FIXME, move rollback
+                tidy();
+                throw;
             }
         }
     }
@@ -1066,13 +1201,15 @@ public:
         return insert(pos, ilist.begin(), ilist.end());
     }
 
+    // the tail is move-assigned over the erased elements, which are still
+    // alive, so moveAux (move construction into raw storage) does not fit
     iterator erase(const_iterator pos) {
         assert(pos.ptr >= this->first && pos.ptr < this->last);
 
         const size_type offset = pos.ptr - this->first;
-        moveAux(pos.ptr + 1, this->last, pos.ptr);
-        this->alloc.destroy(tiny_stl::addressof(*(this->last - 1)));
-        --this->last;
+        tiny_stl::move(pos.ptr + 1, this->last, pos.ptr);
+        allocator_traits<Alloc>::destroy(this->alloc,
+                                         tiny_stl::addressof(*--this->last));
         return this->first + offset;
     }
 
@@ -1082,8 +1219,9 @@ public:
                 xlast.ptr <= this->last));
         const size_type offset = xfirst.ptr - this->first;
         if (xfirst != xlast) {
-            const pointer newLast = moveAux(xlast.ptr, this->last, xfirst.ptr);
-            destroyRange(newLast, this->last);
+            const pointer newLast =
+                tiny_stl::move(xlast.ptr, this->last, xfirst.ptr);
+            destroyAllocRange(newLast, this->last, this->alloc);
             this->last = newLast;
         }
         return this->first + offset;
@@ -1105,20 +1243,10 @@ private:
             if (newSize > max_size())
                 xLength();
 
-            size_type newCapacity = (newSize >> 1) + newSize;
-
-            const pointer newFirst = nullptr;
-            try {
-                newFirst = this->alloc.allocate(newCapacity);
-                moveOrCopy(this->first, this->last, newFirst);
-            } catch (...) {
-                tidy();
-                throw;
-            }
+            reallocAndInit(capacityGrowth(newSize));
+        }
 
-            // destroy/deallocate old elements, update new pointer
-            updatePointer(newFirst, newSize, newCapacity);
-        } else if (newSize < oldSize) { // update pointer, size = newSize
+        if (newSize < oldSize) { // update pointer, size = newSize
             const pointer newLast = this->first + newSize;
             destroyRange(newLast, this->last);
             this->last = newLast;
@@ -1143,9 +1271,19 @@ public:
         resizeHelper(newSize, lambda_fill);
     }
 
-    void swap(vector& rhs) noexcept(
-        noexcept(allocator_traits<Alloc>::propagate_on_container_swap::value ||
-                 allocator_traits<Alloc>::is_always_equal::value)) {
+    // the inline buffer swaps by moving elements through a temporary
+    void swap(VectorImpl& rhs) noexcept(
+        (allocator_traits<Alloc>::propagate_on_container_swap::value ||
+         allocator_traits<Alloc>::is_always_equal::value) &&
+        (N == 0 || (is_nothrow_move_constructible<T>::value &&
+                    is_nothrow_move_assignable<T>::value))) {
+        if (this->isInline() || rhs.isInline()) { // no buffer to exchange
+            VectorImpl tmp(tiny_stl::move(rhs));
+            rhs = tiny_stl::move(*this);
+            *this = tiny_stl::move(tmp);
+            return;
+        }
+
         swapAlloc(this->alloc, rhs.alloc);
         swapADL(this->first, rhs.first);
         swapADL(this->last, rhs.last);
@@ -1160,8 +1298,29 @@ private:
     [[noreturn]] static void xRange() {
         throw "invalid vector<T> subscript";
     }
+}; // class VectorImpl<T, Alloc, N>
+
+template <typename T, typename Alloc = allocator<T>>
+class vector : public VectorImpl<T, Alloc, 0> {
+private:
+    using Base = VectorImpl<T, Alloc, 0>;
+
+public:
+    using Base::Base;
+
+    vector() noexcept(noexcept(Alloc())) : Base() {
+    }
+
+    vector& operator=(std::initializer_list<T> ilist) {
+        Base::operator=(ilist);
+        return *this;
+    }
 }; // class vector<T>
 
+template <typename T, typename Alloc>
+struct is_trivially_relocatable<vector<T, Alloc>>
+    : is_trivially_relocatable<Alloc> {};
+
 template <typename T, typename Alloc>
 inline bool operator==(const vector<T, Alloc>& lhs,
                        const vector<T, Alloc>& rhs) {